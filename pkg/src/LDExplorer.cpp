@@ -29,7 +29,13 @@
 #include "algorithms/include/CIFactory.h"
 #include "algorithms/include/AlgorithmFactory.h"
 #include "algorithms/include/LD.h"
+#include "algorithms/include/Chunker.h"
+#include "algorithms/include/Multiscale.h"
+#include "algorithms/include/Sweep.h"
+#include "algorithms/include/BootstrapReplicate.h"
+#include "algorithms/include/BlockStability.h"
 #include "db/include/Db.h"
+#include "db/include/PairCounter.h"
 
 #include <R.h>
 #include <Rinternals.h>
@@ -162,6 +168,35 @@ extern "C" {
 		}
 	}
 
+	void validateDoublesLengthFree(SEXP value, const char* name, vector<double>& c_value) {
+		long int size = 0;
+		double c_value_double = numeric_limits<double>::quiet_NaN();
+
+		if (!isNumeric(value)) {
+			error("'%s' argument is not numeric.", name);
+		}
+
+		if (isLogical(value)) {
+			error("'%s' argument is logical.", name);
+		}
+
+		size = length(value);
+
+		if (isInteger(value)) {
+			for (long int i = 0; i < size; ++i) {
+				c_value.push_back((double)INTEGER(value)[i]);
+			}
+		} else {
+			for (long int i = 0; i < size; ++i) {
+				c_value_double = REAL(value)[i];
+				if (isnan(c_value_double)) {
+					error("'%s' argument contains NA/NaN value(s).", name);
+				}
+				c_value.push_back(c_value_double);
+			}
+		}
+	}
+
 	long int validateInteger(SEXP value, const char* name) {
 		double c_value_double = numeric_limits<double>::quiet_NaN();
 		long int c_value_int = numeric_limits<long int>::min();
@@ -258,9 +293,30 @@ extern "C" {
 		}
 	}
 
+	/* Sets up an algorithm of mig() on dbview; the main, coarse, region and chunk algorithms differ only in n_threads and the maximum span. */
+	static void configure_algorithm(Algorithm* algorithm, const DbView* dbview, const char* ci_method, long int l_density, int l_adaptive,
+			CICache* ci_cache, const double* ld_ci, double ehr_ci, double ld_fraction, unsigned int n_threads,
+			unsigned long int max_span_bp, unsigned int max_span_snps, int collapse_columns, int integer_weights) {
+		algorithm->set_dbview(dbview);
+		algorithm->set_ci_method(ci_method);
+		algorithm->set_likelihood_density(l_density);
+		algorithm->set_adaptive_likelihood(l_adaptive);
+		algorithm->set_ci_cache(ci_cache);
+		algorithm->set_strong_pair_cl(ld_ci[0]);
+		algorithm->set_strong_pair_cu(ld_ci[1]);
+		algorithm->set_recomb_pair_cu(ehr_ci);
+		algorithm->set_strong_pairs_fraction(ld_fraction);
+		algorithm->set_n_threads(n_threads);
+		algorithm->set_max_span(max_span_bp, max_span_snps);
+		algorithm->set_collapse_columns(collapse_columns);
+		algorithm->set_integer_weights(integer_weights);
+	}
+
 	SEXP mig(SEXP phase_file, SEXP output_file, SEXP phase_file_format, SEXP map_file,
 			SEXP region, SEXP maf, SEXP ci_method, SEXP l_density, SEXP ld_ci, SEXP ehr_ci, SEXP ld_fraction,
-			SEXP pruning_method, SEXP window) {
+			SEXP pruning_method, SEXP window, SEXP l_adaptive, SEXP threads, SEXP chunk_band, SEXP time_budget,
+			SEXP max_span_bp, SEXP max_span_snps, SEXP collapse_columns, SEXP thin_step, SEXP thin_maf, SEXP thin_margin,
+			SEXP integer_weights) {
 
 		const char* c_phase_file = NULL;
 		const char* c_output_file = NULL;
@@ -270,11 +326,24 @@ extern "C" {
 		double c_maf = numeric_limits<double>::quiet_NaN();
 		const char* c_ci_method = NULL;
 		long int c_l_density = numeric_limits<long int>::min();
+		int c_l_adaptive = 0;
 		double c_ld_ci[2] = {numeric_limits<double>::quiet_NaN(), numeric_limits<double>::quiet_NaN()};
 		double c_ehr_ci = numeric_limits<double>::quiet_NaN();
 		double c_ld_fraction = numeric_limits<double>::quiet_NaN();
 		const char* c_pruning_method = NULL;
 		long int c_window = numeric_limits<long int>::min();
+		bool c_auto_window = false;
+		long int c_threads = numeric_limits<long int>::min();
+		long int c_chunk_band = numeric_limits<long int>::min();
+		double c_time_budget = 0.0;
+		bool c_multiscale = false;
+		long int c_thin_step = 1;
+		double c_thin_maf = numeric_limits<double>::quiet_NaN();
+		long int c_thin_margin = numeric_limits<long int>::min();
+		long int c_max_span_bp = 0;
+		long int c_max_span_snps = 0;
+		int c_collapse_columns = 0;
+		int c_integer_weights = 0;
 
 //		Validate phase_file argument.
 		if (!isNull(phase_file)) {
@@ -356,6 +425,15 @@ extern "C" {
 			} else {
 				error("'%s' argument is NULL.", "l_density");
 			}
+
+			if (!isNull(l_adaptive)) {
+				c_l_adaptive = validateBoolean(l_adaptive, "l_adaptive");
+				if (c_l_adaptive == NA_LOGICAL) {
+					error("'%s' argument contains NA value.", "l_adaptive");
+				}
+			} else {
+				error("'%s' argument is NULL.", "l_adaptive");
+			}
 		}
 
 //		Validate ld_ci argument.
@@ -410,22 +488,137 @@ extern "C" {
 //		Validate window argument if MIG++ search space pruning method was specified.
 		if (auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) {
 			if (!isNull(window)) {
-				c_window = validateInteger(window, "window");
-				if (c_window <= 0) {
-					error("The window size, specified in '%s' argument, must be strictly greater than 0.", "window");
+				if (isString(window)) {
+					if (auxiliary::strcmp_ignore_case(validateString(window, "window"), AlgorithmMIGPP::WINDOW_AUTO) != 0) {
+						error("The window size, specified in '%s' argument, must be a number or '%s'.", "window", AlgorithmMIGPP::WINDOW_AUTO);
+					}
+					c_auto_window = true;
+				} else {
+					c_window = validateInteger(window, "window");
+					if (c_window <= 0) {
+						error("The window size, specified in '%s' argument, must be strictly greater than 0.", "window");
+					}
+				}
+			}
+		}
+
+//		Validate threads argument.
+		if (!isNull(threads)) {
+			c_threads = validateInteger(threads, "threads");
+			if (c_threads < 1) {
+				error("The number of threads, specified in '%s' argument, must be greater than 0.", "threads");
+			}
+		} else {
+			error("'%s' argument is NULL.", "threads");
+		}
+
+//		Validate chunk_band argument.
+		if (!isNull(chunk_band)) {
+			c_chunk_band = validateInteger(chunk_band, "chunk_band");
+			if (c_chunk_band < 1) {
+				error("The band around the chunk splits, specified in '%s' argument, must be strictly greater than 0.", "chunk_band");
+			}
+		}
+
+//		Validate thin_step, thin_maf and thin_margin arguments.
+		if (!isNull(thin_step)) {
+			c_thin_step = validateInteger(thin_step, "thin_step");
+			if (c_thin_step < 1) {
+				error("The thinning step, specified in '%s' argument, must be strictly greater than 0.", "thin_step");
+			}
+			c_multiscale = true;
+		}
+		if (!isNull(thin_maf)) {
+			c_thin_maf = validateDouble(thin_maf, "thin_maf");
+			if ((c_thin_maf < 0.0) || (c_thin_maf >= 0.5)) {
+				error("The minor allele frequency of the thinned SNPs, specified in '%s' argument, must be in [0, 0.5) interval.", "thin_maf");
+			}
+			c_multiscale = true;
+		}
+		if (!isNull(thin_margin)) {
+			c_thin_margin = validateInteger(thin_margin, "thin_margin");
+			if (c_thin_margin < 0) {
+				error("The margin around the coarse haplotype blocks, specified in '%s' argument, must be positive.", "thin_margin");
+			}
+		} else {
+			error("'%s' argument is NULL.", "thin_margin");
+		}
+		if ((c_multiscale) && (c_chunk_band != numeric_limits<long int>::min())) {
+			error("The '%s' argument can not be used with the coarse-to-fine detection.", "chunk_band");
+		}
+
+//		Validate time_budget argument if MIG++ search space pruning method was specified.
+		if (auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) {
+			if (!isNull(time_budget)) {
+				c_time_budget = validateDouble(time_budget, "time_budget");
+				if (c_time_budget <= 0.0) {
+					error("The time budget, specified in '%s' argument, must be strictly greater than 0 seconds.", "time_budget");
 				}
 			}
 		}
 
+//		Validate max_span_bp argument.
+		if (!isNull(max_span_bp)) {
+			c_max_span_bp = validateInteger(max_span_bp, "max_span_bp");
+			if (c_max_span_bp <= 0) {
+				error("The maximal haplotype block span, specified in '%s' argument, must be strictly greater than 0 base-pairs.", "max_span_bp");
+			}
+		}
+
+//		Validate max_span_snps argument.
+		if (!isNull(max_span_snps)) {
+			c_max_span_snps = validateInteger(max_span_snps, "max_span_snps");
+			if (c_max_span_snps < 2) {
+				error("The maximal haplotype block span, specified in '%s' argument, must be at least 2 SNPs.", "max_span_snps");
+			}
+		}
+
+//		Validate collapse_columns argument.
+		if (!isNull(collapse_columns)) {
+			c_collapse_columns = validateBoolean(collapse_columns, "collapse_columns");
+			if (c_collapse_columns == NA_LOGICAL) {
+				error("'%s' argument contains NA value.", "collapse_columns");
+			}
+		} else {
+			error("'%s' argument is NULL.", "collapse_columns");
+		}
+
+//		Validate integer_weights argument.
+		if (!isNull(integer_weights)) {
+			c_integer_weights = validateBoolean(integer_weights, "integer_weights");
+			if (c_integer_weights == NA_LOGICAL) {
+				error("'%s' argument contains NA value.", "integer_weights");
+			}
+		} else {
+			error("'%s' argument is NULL.", "integer_weights");
+		}
+
 		Algorithm* algorithm = NULL;
 		Partition* partition = NULL;
+		CICache* ci_cache = NULL;
+
+		CI* chunk_ci = NULL;
+		vector<Algorithm*> chunk_algorithms;
+		vector<Partition*> chunk_partitions;
+
+		Algorithm* coarse_algorithm = NULL;
+		Partition* coarse_partition = NULL;
 
 		try {
 			clock_t start_time = 0;
 			double execution_time = 0.0;
+#ifdef _OPENMP
+			double start_time_omp = 0.0;
+#endif
+			double memory_usage_preliminary_blocks = 0.0;
+			double memory_usage_algorithm = 0.0;
 
 			Db db;
 			const DbView* dbview = NULL;
+			const DbView* sample_dbview = NULL;
+			Multiscale multiscale((unsigned int)c_thin_step, c_thin_maf, (unsigned int)c_thin_margin);
+			unsigned int sample_start = 0u;
+			unsigned int sample_end = 0u;
 
 			Rprintf("Loading data...\n");
 
@@ -466,11 +659,18 @@ extern "C" {
 			} else {
 				Rprintf("NA\n");
 			}
+			Rprintf("\tD' adaptive likelihood grid: ");
+			if (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) {
+				Rprintf("%s\n", c_l_adaptive ? "TRUE" : "FALSE");
+			} else {
+				Rprintf("NA\n");
+			}
 			Rprintf("\tD' CI lower bound for strong LD: >= %g\n", c_ld_ci[0]);
 			Rprintf("\tD' CI upper bound for strong LD: >= %g\n", c_ld_ci[1]);
 			Rprintf("\tD' CI upper bound for recombination: <= %g\n", c_ehr_ci);
 			Rprintf("\tFraction of strong LD SNP pairs: >= %g\n", c_ld_fraction);
 			Rprintf("\tPruning method: %s\n", c_pruning_method);
+			Rprintf("\tPair counting kernel: %s\n", PairCounter::get_kernel_name());
 			Rprintf("\tWindow: ");
 			if (auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) {
 				if (c_window == numeric_limits<long int>::min()) {
@@ -479,41 +679,334 @@ extern "C" {
 						c_window = 1;
 					}
 				}
-				Rprintf("%ld\n", c_window);
+				if (c_auto_window) {
+					Rprintf("%s\n", AlgorithmMIGPP::WINDOW_AUTO);
+				} else {
+					Rprintf("%ld\n", c_window);
+				}
 			} else {
 				Rprintf("NA\n", c_window);
 			}
+			Rprintf("\tThreads: %ld\n", c_threads);
+			Rprintf("\tChunk band: ");
+			if (c_chunk_band != numeric_limits<long int>::min()) {
+				Rprintf("%ld\n", c_chunk_band);
+			} else {
+				Rprintf("NA\n");
+			}
+			Rprintf("\tTime budget (sec): ");
+			if (c_time_budget > 0.0) {
+				Rprintf("%g\n", c_time_budget);
+			} else {
+				Rprintf("NA\n");
+			}
+			Rprintf("\tMaximum block span (bp): ");
+			if (c_max_span_bp > 0) {
+				Rprintf("%ld\n", c_max_span_bp);
+			} else {
+				Rprintf("NA\n");
+			}
+			Rprintf("\tMaximum block span (SNPs): ");
+			if (c_max_span_snps > 0) {
+				Rprintf("%ld\n", c_max_span_snps);
+			} else {
+				Rprintf("NA\n");
+			}
+			Rprintf("\tCollapse identical SNP columns: %s\n", c_collapse_columns ? "TRUE" : "FALSE");
+			Rprintf("\tInteger pair weights: %s\n", c_integer_weights ? "TRUE" : "FALSE");
+			Rprintf("\tCoarse-to-fine thinning: ");
+			if (c_multiscale) {
+				Rprintf("every %ld SNP(s)", c_thin_step);
+				if (!isnan(c_thin_maf)) {
+					Rprintf(" with MAF > %g", c_thin_maf);
+				}
+				Rprintf(", margin of %ld thinned SNP(s)\n", c_thin_margin);
+			} else {
+				Rprintf("NA\n");
+			}
 
 			algorithm = AlgorithmFactory::create(c_pruning_method, c_window);
 
-			algorithm->set_dbview(dbview);
-			algorithm->set_ci_method(c_ci_method);
-			algorithm->set_likelihood_density(c_l_density);
-			algorithm->set_strong_pair_cl(c_ld_ci[0]);
-			algorithm->set_strong_pair_cu(c_ld_ci[1]);
-			algorithm->set_recomb_pair_cu(c_ehr_ci);
-			algorithm->set_strong_pairs_fraction(c_ld_fraction);
+			if ((auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) || (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_AV) == 0)) {
+				ci_cache = new CICache();
+			}
+
+			configure_algorithm(algorithm, dbview, c_ci_method, c_l_density, c_l_adaptive, ci_cache, c_ld_ci, c_ehr_ci, c_ld_fraction,
+					(unsigned int)c_threads, (unsigned long int)c_max_span_bp, (unsigned int)c_max_span_snps, c_collapse_columns, c_integer_weights);
+
+			/* the window is tuned on a stretch of markers from the middle of the region */
+			if (c_auto_window) {
+				sample_start = dbview->n_markers > AlgorithmMIGPP::AUTO_WINDOW_SAMPLE_SIZE ? (dbview->n_markers - AlgorithmMIGPP::AUTO_WINDOW_SAMPLE_SIZE) / 2u : 0u;
+				sample_end = dbview->n_markers > AlgorithmMIGPP::AUTO_WINDOW_SAMPLE_SIZE ? sample_start + AlgorithmMIGPP::AUTO_WINDOW_SAMPLE_SIZE - 1u : dbview->n_markers - 1u;
+
+				sample_dbview = db.create_view(c_maf, dbview->positions[sample_start], dbview->positions[sample_end]);
+
+				((AlgorithmMIGPP*)algorithm)->tune_window(sample_dbview);
+				c_window = ((AlgorithmMIGPP*)algorithm)->get_window();
+
+				Rprintf("\tTuned window: %ld (probed on %u SNPs)\n", c_window, sample_dbview != NULL ? sample_dbview->n_markers : 0u);
+			}
 
 			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
 			Rprintf("Done (%.3f sec)\n", execution_time);
 
 			Rprintf("Processing data...\n");
+#ifdef	_OPENMP
+			start_time_omp = omp_get_wtime();
+#else
 			start_time = clock();
+#endif
 
-			algorithm->compute_preliminary_blocks();
-			Rprintf("\tPreliminary haplotype blocks: %u\n", algorithm->get_n_preliminary_blocks());
+			if (c_multiscale) {
+				const DbView* thinned_dbview = NULL;
+				const DbView* region_dbview = NULL;
+				Algorithm* region_algorithm = NULL;
+				unsigned int n_preliminary_blocks = 0u;
+				unsigned long int n_calculations = 0u;
+				unsigned long int n_region_markers = 0u;
+				long int coarse_window = 0;
+				long int region_window = 0;
+				bool region_failed = false;
+				string region_failure;
+				int omp_i = 0;
+
+				/* the verification classifies the pairs of the final blocks on the whole view */
+				chunk_ci = CIFactory::create(c_ci_method, c_l_density, ci_cache, c_l_adaptive);
+				chunk_ci->set_dbview(dbview);
+				chunk_ci->set_pair_thresholds(c_ld_ci[0], c_ld_ci[1], c_ehr_ci);
+
+				multiscale.set_dbview(dbview);
+				thinned_dbview = multiscale.create_thinned_view();
+
+				Rprintf("\tThinned SNPs: %u\n", thinned_dbview != NULL ? thinned_dbview->n_markers : 0u);
+
+				if (thinned_dbview != NULL) {
+					coarse_window = (long int)(((double)thinned_dbview->n_markers * (1.0 - c_ld_fraction)) / 2.0);
+					if (coarse_window <= 0) {
+						coarse_window = 1;
+					}
 
-			algorithm->sort_preliminary_blocks();
-			partition = algorithm->get_block_partition();
+					coarse_algorithm = AlgorithmFactory::create(Algorithm::ALGORITHM_MIGPP, coarse_window);
+
+					/* the thinned markers are fewer, so only the span in base-pairs applies */
+					configure_algorithm(coarse_algorithm, thinned_dbview, c_ci_method, c_l_density, c_l_adaptive, ci_cache, c_ld_ci, c_ehr_ci, c_ld_fraction,
+							(unsigned int)c_threads, (unsigned long int)c_max_span_bp, 0u, c_collapse_columns, c_integer_weights);
+
+					coarse_algorithm->compute_preliminary_blocks();
+					coarse_partition = coarse_algorithm->get_block_partition();
+					n_calculations += coarse_algorithm->get_n_calculations();
+
+					multiscale.find_regions(coarse_partition);
+				}
+
+				for (unsigned int r = 0u; r < multiscale.get_n_regions(); ++r) {
+					n_region_markers += multiscale.get_region_end(r) - multiscale.get_region_start(r) + 1u;
+				}
+
+				Rprintf("\tCoarse haplotype blocks: %u\n", coarse_partition != NULL ? coarse_partition->get_n_blocks() : 0u);
+				Rprintf("\tRegions: %u (%lu SNPs)\n", multiscale.get_n_regions(), n_region_markers);
+
+				for (unsigned int r = 0u; r < multiscale.get_n_regions(); ++r) {
+					region_dbview = multiscale.create_region_view(r);
+
+					region_window = c_window;
+					if ((auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) && isNull(window)) {
+						region_window = (long int)(((double)region_dbview->n_markers * (1.0 - c_ld_fraction)) / 2.0);
+						if (region_window <= 0) {
+							region_window = 1;
+						}
+					}
+
+					region_algorithm = AlgorithmFactory::create(c_pruning_method, region_window);
+					chunk_algorithms.push_back(region_algorithm);
+
+					/* the regions are processed in parallel, one thread each */
+					configure_algorithm(region_algorithm, region_dbview, c_ci_method, c_l_density, c_l_adaptive, ci_cache, c_ld_ci, c_ehr_ci, c_ld_fraction,
+							1u, (unsigned long int)c_max_span_bp, (unsigned int)c_max_span_snps, c_collapse_columns, c_integer_weights);
 
+					/* the classes of the pairs in the region are kept for the verification of its blocks */
+					region_algorithm->set_class_cache(multiscale.get_region_class_cache(r));
+				}
+
+				if (c_time_budget > 0.0) {
+					for (unsigned int r = 0u; r < chunk_algorithms.size(); ++r) {
+						((AlgorithmMIGPP*)chunk_algorithms.at(r))->set_time_budget(c_time_budget);
+					}
+				}
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(c_threads) private(omp_i, region_algorithm) schedule(dynamic, 1)
+#endif
+				for (omp_i = 0; omp_i < (int)chunk_algorithms.size(); ++omp_i) {
+					region_algorithm = chunk_algorithms.at(omp_i);
+					try {
+						region_algorithm->compute_preliminary_blocks();
+					} catch (Exception &e) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+						{
+							if (!region_failed) {
+								region_failure = e.what();
+							}
+							region_failed = true;
+						}
+					}
+				}
+
+				if (region_failed) {
+					throw Exception(__FILE__, __LINE__, "%s", region_failure.c_str());
+				}
+
+				for (unsigned int r = 0u; r < chunk_algorithms.size(); ++r) {
+					chunk_partitions.push_back(chunk_algorithms.at(r)->get_block_partition());
+
+					n_preliminary_blocks += chunk_algorithms.at(r)->get_n_preliminary_blocks();
+					n_calculations += chunk_algorithms.at(r)->get_n_calculations();
+					memory_usage_preliminary_blocks += chunk_algorithms.at(r)->get_memory_usage_preliminary_blocks();
+					memory_usage_algorithm += chunk_algorithms.at(r)->get_memory_usage();
+				}
+
+				Rprintf("\tPreliminary haplotype blocks: %u\n", n_preliminary_blocks);
+
+				/* the blocks are verified with the strong pair fraction test of the algorithm configured for the whole view */
+				partition = multiscale.merge(chunk_partitions, chunk_ci, algorithm);
+				n_calculations += multiscale.get_n_calculations();
+				memory_usage_algorithm += multiscale.get_memory_usage();
+
+				Rprintf("\tScanned SNP pairs: %lu (%.2f%% pruned, %lu to verify the blocks)\n", n_calculations,
+						100.0 * (1.0 - n_calculations / ((dbview->n_markers * (double)(dbview->n_markers - 1u)) / 2.0)), multiscale.get_n_calculations());
+				partition->pruning_method = c_pruning_method;
+				if (auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) {
+					partition->window = (unsigned int)c_window;
+					partition->auto_window = c_auto_window;
+				}
+
+				Rprintf("\tRejected haplotype blocks: %u\n", multiscale.get_n_rejected_blocks());
+			} else if (c_chunk_band == numeric_limits<long int>::min()) {
+				if (c_time_budget > 0.0) {
+					((AlgorithmMIGPP*)algorithm)->set_time_budget(c_time_budget);
+				}
+
+				algorithm->compute_preliminary_blocks();
+				if (c_collapse_columns) {
+					Rprintf("\tSNP column groups: %u\n", algorithm->get_n_column_groups());
+				}
+				Rprintf("\tPreliminary haplotype blocks: %u\n", algorithm->get_n_preliminary_blocks());
+
+				partition = algorithm->get_block_partition();
+
+				memory_usage_preliminary_blocks = algorithm->get_memory_usage_preliminary_blocks();
+				memory_usage_algorithm = algorithm->get_memory_usage();
+			} else {
+				Chunker chunker((unsigned int)c_chunk_band);
+				const DbView* chunk_dbview = NULL;
+				Algorithm* chunk_algorithm = NULL;
+				unsigned int n_preliminary_blocks = 0u;
+				long int chunk_window = 0;
+				bool chunk_failed = false;
+				string chunk_failure;
+				int omp_i = 0;
+
+				chunk_ci = CIFactory::create(c_ci_method, c_l_density, ci_cache, c_l_adaptive);
+				chunk_ci->set_dbview(dbview);
+				chunk_ci->set_pair_thresholds(c_ld_ci[0], c_ld_ci[1], c_ehr_ci);
+
+				chunker.set_dbview(dbview);
+				chunker.set_ci(chunk_ci);
+				chunker.find_chunks(4u * (unsigned int)c_chunk_band);
+
+				Rprintf("\tChunks: %u\n", chunker.get_n_chunks());
+				if (chunker.get_n_chunks() > 1u) {
+					Rprintf("\tNote: the haplotype blocks are exact only if both ends of every block are within %ld SNP(s) of every split\n", c_chunk_band);
+				}
+
+				for (unsigned int c = 0u; c < chunker.get_n_chunks(); ++c) {
+					chunk_dbview = chunker.create_chunk_view(&db, c);
+
+					chunk_window = c_window;
+					if ((auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) && isNull(window)) {
+						chunk_window = (long int)(((double)chunk_dbview->n_markers * (1.0 - c_ld_fraction)) / 2.0);
+						if (chunk_window <= 0) {
+							chunk_window = 1;
+						}
+					}
+
+					chunk_algorithm = AlgorithmFactory::create(c_pruning_method, chunk_window);
+					chunk_algorithms.push_back(chunk_algorithm);
+
+					/* the chunks are processed in parallel, one thread each */
+					configure_algorithm(chunk_algorithm, chunk_dbview, c_ci_method, c_l_density, c_l_adaptive, ci_cache, c_ld_ci, c_ehr_ci, c_ld_fraction,
+							1u, (unsigned long int)c_max_span_bp, (unsigned int)c_max_span_snps, c_collapse_columns, c_integer_weights);
+				}
+
+				/* one deadline for all chunks */
+				if (c_time_budget > 0.0) {
+					for (unsigned int c = 0u; c < chunk_algorithms.size(); ++c) {
+						((AlgorithmMIGPP*)chunk_algorithms.at(c))->set_time_budget(c_time_budget);
+					}
+				}
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(c_threads) private(omp_i, chunk_algorithm) schedule(dynamic, 1)
+#endif
+				for (omp_i = 0; omp_i < (int)chunk_algorithms.size(); ++omp_i) {
+					chunk_algorithm = chunk_algorithms.at(omp_i);
+					try {
+						chunk_algorithm->compute_preliminary_blocks();
+					} catch (Exception &e) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+						{
+							if (!chunk_failed) {
+								chunk_failure = e.what();
+							}
+							chunk_failed = true;
+						}
+					}
+				}
+
+				if (chunk_failed) {
+					throw Exception(__FILE__, __LINE__, "%s", chunk_failure.c_str());
+				}
+
+				for (unsigned int c = 0u; c < chunk_algorithms.size(); ++c) {
+					chunk_partitions.push_back(chunk_algorithms.at(c)->get_block_partition());
+
+					n_preliminary_blocks += chunk_algorithms.at(c)->get_n_preliminary_blocks();
+					memory_usage_preliminary_blocks += chunk_algorithms.at(c)->get_memory_usage_preliminary_blocks();
+					memory_usage_algorithm += chunk_algorithms.at(c)->get_memory_usage();
+				}
+
+				Rprintf("\tPreliminary haplotype blocks: %u\n", n_preliminary_blocks);
+
+				partition = chunker.stitch(chunk_partitions);
+				if (auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) {
+					partition->window = (unsigned int)c_window;
+					partition->auto_window = c_auto_window;
+				}
+			}
+
+#ifdef	_OPENMP
+			execution_time = omp_get_wtime() - start_time_omp;
+#else
 			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+#endif
 
 			Rprintf("\tFinal haplotype blocks: %u\n", partition->get_n_blocks());
+			if (partition->provisional) {
+				Rprintf("\tProvisional blocks: time budget exceeded at window %u\n", partition->reached_window);
+			}
 
-			Rprintf("\tMemory used for preliminary haplotype blocks (Mb): %.3g\n", algorithm->get_memory_usage_preliminary_blocks());
+			Rprintf("\tMemory used for preliminary haplotype blocks (Mb): %.3g\n", memory_usage_preliminary_blocks);
 			Rprintf("\tMemory used for final haplotype blocks (Mb): %.3g\n", partition->get_memory_usage());
-			Rprintf("\tMemory used by algorithm (Mb): %.3g\n", algorithm->get_memory_usage());
-			Rprintf("\tTotal used memory (Mb): %.3g\n", algorithm->get_memory_usage_preliminary_blocks() + partition->get_memory_usage() + algorithm->get_memory_usage());
+			Rprintf("\tMemory used by algorithm (Mb): %.3g\n", memory_usage_algorithm);
+			Rprintf("\tTotal used memory (Mb): %.3g\n", memory_usage_preliminary_blocks + partition->get_memory_usage() + memory_usage_algorithm);
+			if (ci_cache != NULL) {
+				Rprintf("\tD' CI cache hit rate: %.3g (%.0f of %.0f lookups)\n", ci_cache->get_hit_rate(), ci_cache->get_n_hits(), ci_cache->get_n_lookups());
+				Rprintf("\tMemory used by D' CI cache (Mb): %.3g\n", ci_cache->get_memory_usage());
+			}
 			Rprintf("Done (%.3f sec)\n", execution_time);
 
 			Rprintf("Writing results...\n");
@@ -531,6 +1024,28 @@ extern "C" {
 			delete algorithm;
 			algorithm = NULL;
 
+			for (unsigned int c = 0u; c < chunk_partitions.size(); ++c) {
+				delete chunk_partitions.at(c);
+			}
+			chunk_partitions.clear();
+
+			for (unsigned int c = 0u; c < chunk_algorithms.size(); ++c) {
+				delete chunk_algorithms.at(c);
+			}
+			chunk_algorithms.clear();
+
+			delete chunk_ci;
+			chunk_ci = NULL;
+
+			delete coarse_partition;
+			coarse_partition = NULL;
+
+			delete coarse_algorithm;
+			coarse_algorithm = NULL;
+
+			delete ci_cache;
+			ci_cache = NULL;
+
 		} catch (Exception &e) {
 			delete partition;
 			partition = NULL;
@@ -538,33 +1053,51 @@ extern "C" {
 			delete algorithm;
 			algorithm = NULL;
 
+			for (unsigned int c = 0u; c < chunk_partitions.size(); ++c) {
+				delete chunk_partitions.at(c);
+			}
+			chunk_partitions.clear();
+
+			for (unsigned int c = 0u; c < chunk_algorithms.size(); ++c) {
+				delete chunk_algorithms.at(c);
+			}
+			chunk_algorithms.clear();
+
+			delete chunk_ci;
+			chunk_ci = NULL;
+
+			delete coarse_partition;
+			coarse_partition = NULL;
+
+			delete coarse_algorithm;
+			coarse_algorithm = NULL;
+
+			delete ci_cache;
+			ci_cache = NULL;
+
 			error("%s", e.what());
 		}
 
 		return R_NilValue;
 	}
 
-	SEXP mig_multi_regions(SEXP phase_file, SEXP output_files, SEXP regions_start, SEXP regions_end, SEXP processes,
-			SEXP phase_file_format, SEXP map_file,
-			SEXP maf, SEXP ci_method, SEXP l_density, SEXP ld_ci, SEXP ehr_ci, SEXP ld_fraction,
-			SEXP pruning_method, SEXP windows) {
+	SEXP mig_sweep(SEXP phase_file, SEXP output_files, SEXP phase_file_format, SEXP map_file,
+			SEXP region, SEXP maf, SEXP ci_method, SEXP l_density, SEXP ld_ci_lower, SEXP ld_ci_upper, SEXP ehr_ci, SEXP ld_fraction,
+			SEXP l_adaptive) {
 
 		const char* c_phase_file = NULL;
 		vector<const char*> c_output_files;
 		const char* c_phase_file_format = NULL;
 		const char* c_map_file = NULL;
-		vector<long int> c_regions_start;
-		vector<long int> c_regions_end;
-		long int c_processes = numeric_limits<long int>::min();
+		long int c_region[2] = {numeric_limits<long int>::min(), numeric_limits<long int>::min()};
 		double c_maf = numeric_limits<double>::quiet_NaN();
 		const char* c_ci_method = NULL;
 		long int c_l_density = numeric_limits<long int>::min();
-		double c_ld_ci[2] = {numeric_limits<double>::quiet_NaN(), numeric_limits<double>::quiet_NaN()};
-		double c_ehr_ci = numeric_limits<double>::quiet_NaN();
-		double c_ld_fraction = numeric_limits<double>::quiet_NaN();
-		const char* c_pruning_method = NULL;
-		vector<long int> c_windows;
-		long int c_window = numeric_limits<long int>::min();
+		int c_l_adaptive = 0;
+		vector<double> c_ld_ci_lower;
+		vector<double> c_ld_ci_upper;
+		vector<double> c_ehr_ci;
+		vector<double> c_ld_fraction;
 
 //		Validate phase_file argument.
 		if (!isNull(phase_file)) {
@@ -573,7 +1106,7 @@ extern "C" {
 			error("'%s' argument is NULL.", "phase_file");
 		}
 
-//		Validate output_file argument.
+//		Validate output_files argument.
 		if (!isNull(output_files)) {
 			validateStringsLengthFree(output_files, "output_files", c_output_files);
 		} else {
@@ -601,24 +1134,324 @@ extern "C" {
 			}
 		}
 
-//		Validate regions_start and regions_end arguments
-		if (!isNull(regions_start)) {
-			validateIntegersLengthFree(regions_start, "regions_start", c_regions_start);
-		} else {
-			error("'%s' argument is NULL.", "regions_start");
+//		Validate region argument.
+		if (!isNull(region)) {
+			validateIntegers(region, "region", c_region, 2u);
+			if (c_region[0] < 0) {
+				error("The region start position, specified in '%s' argument, must be positive.", "region");
+			}
+			if (c_region[1] < 0) {
+				error("The region end position, specified in '%s' argument, must be positive.", "region");
+			}
+			if (c_region[0] >= c_region[1]) {
+				error("The region end position, specified in '%s' argument, must be strictly greater than the region start position.", "region");
+			}
 		}
 
-		if (!isNull(regions_end)) {
-			validateIntegersLengthFree(regions_end, "regions_end", c_regions_end);
+//		Validate maf argument.
+		if (!isNull(maf)) {
+			c_maf = validateDouble(maf, "maf");
+			if ((c_maf < 0.0) || (c_maf > 0.5)) {
+				error("The minor allele frequency, specified in '%s' argument, must be in [0, 0.5] interval.", "maf");
+			}
 		} else {
-			error("'%s' argument is NULL.", "regions_end");
+			error("'%s' argument is NULL.", "maf");
 		}
 
-		for (unsigned int i = 0u; i < c_regions_start.size(); ++i) {
-			if (c_regions_start.at(0) < 0) {
-				error("The region start positions, specified in '%s' argument, must be positive.", "regions_start");
-			}
-		}
+//		Validate ci_method argument.
+		if (!isNull(ci_method)) {
+			c_ci_method = validateString(ci_method, "ci_method");
+			if ((auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) != 0) &&
+					(auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_AV) != 0)) {
+				error("The method to compute the confidence interval (CI) of D', specified in '%s' argument, must be '%s' or '%s'.", "ci_method", CI::CI_WP, CI::CI_AV);
+			}
+		} else {
+			error("'%s' argument is NULL.", "ci_method");
+		}
+
+//		Validate likelihood density argument if WP method to compute D' CI was specified.
+		if (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) {
+			if (!isNull(l_density)) {
+				c_l_density = validateInteger(l_density, "l_density");
+				if (c_l_density <= 0) {
+					error("The number of likelihood estimation points to compute confidence interval, specified in '%s' argument, must be strictly greater then 0.", "l_density");
+				}
+			} else {
+				error("'%s' argument is NULL.", "l_density");
+			}
+
+			if (!isNull(l_adaptive)) {
+				c_l_adaptive = validateBoolean(l_adaptive, "l_adaptive");
+				if (c_l_adaptive == NA_LOGICAL) {
+					error("'%s' argument contains NA value.", "l_adaptive");
+				}
+			} else {
+				error("'%s' argument is NULL.", "l_adaptive");
+			}
+		}
+
+//		Validate ld_ci_lower and ld_ci_upper arguments.
+		if (!isNull(ld_ci_lower)) {
+			validateDoublesLengthFree(ld_ci_lower, "ld_ci_lower", c_ld_ci_lower);
+		} else {
+			error("'%s' argument is NULL.", "ld_ci_lower");
+		}
+
+		if (!isNull(ld_ci_upper)) {
+			validateDoublesLengthFree(ld_ci_upper, "ld_ci_upper", c_ld_ci_upper);
+		} else {
+			error("'%s' argument is NULL.", "ld_ci_upper");
+		}
+
+		for (unsigned int i = 0u; i < c_ld_ci_lower.size(); ++i) {
+			if ((c_ld_ci_lower.at(i) < 0.0) || (c_ld_ci_lower.at(i) > 1.0)) {
+				error("The lower bound of confidence interval, specified in '%s' argument, must be in [0, 1] interval.", "ld_ci_lower");
+			}
+		}
+
+		for (unsigned int i = 0u; i < c_ld_ci_upper.size(); ++i) {
+			if ((c_ld_ci_upper.at(i) < 0.0) || (c_ld_ci_upper.at(i) > 1.0)) {
+				error("The upper bound of confidence interval, specified in '%s' argument, must be in [0, 1] interval.", "ld_ci_upper");
+			}
+		}
+
+//		Validate ehr_ci argument.
+		if (!isNull(ehr_ci)) {
+			validateDoublesLengthFree(ehr_ci, "ehr_ci", c_ehr_ci);
+		} else {
+			error("'%s' argument is NULL.", "ehr_ci");
+		}
+
+		for (unsigned int i = 0u; i < c_ehr_ci.size(); ++i) {
+			if ((c_ehr_ci.at(i) < 0.0) || (c_ehr_ci.at(i) > 1.0)) {
+				error("The upper bound of confidence interval, specified in '%s' argument, must be in [0, 1] interval.", "ehr_ci");
+			}
+		}
+
+//		Validate ld_fraction argument.
+		if (!isNull(ld_fraction)) {
+			validateDoublesLengthFree(ld_fraction, "ld_fraction", c_ld_fraction);
+		} else {
+			error("'%s' argument is NULL.", "ld_fraction");
+		}
+
+		for (unsigned int i = 0u; i < c_ld_fraction.size(); ++i) {
+			if ((c_ld_fraction.at(i) <= 0.0) || (c_ld_fraction.at(i) > 1.0)) {
+				error("The fraction of strong LD SNP pairs within a haplotype block, specified in '%s' argument, must be in (0.0, 1.0] interval.", "ld_fraction");
+			}
+		}
+
+		if ((c_ld_ci_lower.size() != c_output_files.size()) || (c_ld_ci_upper.size() != c_output_files.size()) ||
+				(c_ehr_ci.size() != c_output_files.size()) || (c_ld_fraction.size() != c_output_files.size())) {
+			error("The number of the specified output files must correspond to the number of the specified parameter settings.");
+		}
+
+		for (unsigned int i = 0u; i < c_output_files.size(); ++i) {
+			if (c_ld_ci_lower.at(i) >= c_ld_ci_upper.at(i)) {
+				error("The upper bound of confidence interval, specified in '%s' argument, must be greater than the lower bound, specified in '%s' argument.", "ld_ci_upper", "ld_ci_lower");
+			}
+		}
+
+		Sweep* sweep = NULL;
+		Partition* partition = NULL;
+		CICache* ci_cache = NULL;
+
+		try {
+			clock_t start_time = 0;
+			double execution_time = 0.0;
+
+			Db db;
+			const DbView* dbview = NULL;
+
+			Rprintf("Loading data...\n");
+
+			start_time = clock();
+			db.set_hap_file(c_phase_file);
+			db.set_map_file(c_map_file);
+			db.load(c_region[0] == numeric_limits<long int>::min() ? 0u : (unsigned long int)c_region[0], c_region[1] == numeric_limits<long int>::min() ? numeric_limits<unsigned long int>::max() : (unsigned long int)c_region[1], c_phase_file_format);
+			dbview = db.create_view(c_maf, c_region[0] == numeric_limits<long int>::min() ? 0u : (unsigned long int)c_region[0], c_region[1] == numeric_limits<long int>::min() ? numeric_limits<unsigned long int>::max() : (unsigned long int)c_region[1]);
+			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+
+			if (dbview == NULL) {
+				Rprintf("\tNot enough SNPs (<= 1) in the specified region.\n");
+				Rprintf("Done (%.3f sec)\n", execution_time);
+				return R_NilValue;
+			}
+
+			Rprintf("\tPhase file: %s\n", c_phase_file);
+			Rprintf("\tMap file: %s\n", c_map_file == NULL ? "NA" : c_map_file);
+			if ((c_region[0] != numeric_limits<long int>::min()) && (c_region[1] != numeric_limits<long int>::min())) {
+				Rprintf("\tRegion: [%u, %u]\n", c_region[0], c_region[1]);
+			} else {
+				Rprintf("\tRegion: NA\n");
+			}
+			Rprintf("\tMAF filter: > %g\n", dbview->maf_threshold);
+			Rprintf("\tAll SNPs: %u\n", dbview->n_unfiltered_markers);
+			Rprintf("\tFiltered SNPs: %u\n", dbview->n_markers);
+			Rprintf("\tHaplotypes: %u\n", dbview->n_haplotypes);
+			Rprintf("\tUsed memory (Mb): %.3f\n", db.get_memory_usage());
+			Rprintf("Done (%.3f sec)\n", execution_time);
+
+			Rprintf("Initializing algorithm...\n");
+			start_time = clock();
+
+			Rprintf("\tD' CI computation method: %s\n", c_ci_method);
+			Rprintf("\tD' likelihood density: ");
+			if (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) {
+				Rprintf("%u\n", c_l_density);
+			} else {
+				Rprintf("NA\n");
+			}
+			Rprintf("\tD' adaptive likelihood grid: ");
+			if (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) {
+				Rprintf("%s\n", c_l_adaptive ? "TRUE" : "FALSE");
+			} else {
+				Rprintf("NA\n");
+			}
+			Rprintf("\tPruning method: %s\n", Algorithm::ALGORITHM_MIGP);
+			Rprintf("\tParameter settings: %u\n", (unsigned int)c_output_files.size());
+
+			ci_cache = new CICache();
+
+			sweep = new Sweep();
+			sweep->set_dbview(dbview);
+			sweep->set_ci_method(c_ci_method);
+			sweep->set_likelihood_density(c_l_density);
+			sweep->set_adaptive_likelihood(c_l_adaptive);
+			sweep->set_ci_cache(ci_cache);
+			for (unsigned int i = 0u; i < c_output_files.size(); ++i) {
+				Rprintf("\tSetting %u: D' CI >= [%g, %g] for strong LD, <= %g for recombination, strong LD fraction >= %g\n",
+						i + 1u, c_ld_ci_lower.at(i), c_ld_ci_upper.at(i), c_ehr_ci.at(i), c_ld_fraction.at(i));
+				sweep->add_setting(c_ld_ci_lower.at(i), c_ld_ci_upper.at(i), c_ehr_ci.at(i), c_ld_fraction.at(i));
+			}
+
+			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+			Rprintf("Done (%.3f sec)\n", execution_time);
+
+			Rprintf("Processing data...\n");
+			start_time = clock();
+
+			sweep->compute_preliminary_blocks();
+
+			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+
+			Rprintf("\tMemory used by algorithm (Mb): %.3g\n", sweep->get_memory_usage());
+			Rprintf("\tD' CI cache hit rate: %.3g (%.0f of %.0f lookups)\n", ci_cache->get_hit_rate(), ci_cache->get_n_hits(), ci_cache->get_n_lookups());
+			Rprintf("Done (%.3f sec)\n", execution_time);
+
+			Rprintf("Writing results...\n");
+			start_time = clock();
+
+			for (unsigned int i = 0u; i < c_output_files.size(); ++i) {
+				partition = sweep->get_block_partition(i);
+				Rprintf("\tSetting %u: %u preliminary, %u final haplotype blocks, output file: %s\n", i + 1u, sweep->get_n_preliminary_blocks(i), partition->get_n_blocks(), c_output_files.at(i));
+				partition->write(c_output_files.at(i));
+
+				delete partition;
+				partition = NULL;
+			}
+
+			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+			Rprintf("Done (%.3f sec)\n", execution_time);
+
+			delete sweep;
+			sweep = NULL;
+
+			delete ci_cache;
+			ci_cache = NULL;
+		} catch (Exception &e) {
+			delete partition;
+			partition = NULL;
+
+			delete sweep;
+			sweep = NULL;
+
+			delete ci_cache;
+			ci_cache = NULL;
+
+			error("%s", e.what());
+		}
+
+		return R_NilValue;
+	}
+
+	SEXP mig_multi_regions(SEXP phase_file, SEXP output_files, SEXP regions_start, SEXP regions_end, SEXP processes,
+			SEXP phase_file_format, SEXP map_file,
+			SEXP maf, SEXP ci_method, SEXP l_density, SEXP ld_ci, SEXP ehr_ci, SEXP ld_fraction,
+			SEXP pruning_method, SEXP windows, SEXP l_adaptive, SEXP pair_cache_band) {
+
+		const char* c_phase_file = NULL;
+		vector<const char*> c_output_files;
+		const char* c_phase_file_format = NULL;
+		const char* c_map_file = NULL;
+		vector<long int> c_regions_start;
+		vector<long int> c_regions_end;
+		long int c_processes = numeric_limits<long int>::min();
+		vector<double> c_mafs;
+		const char* c_ci_method = NULL;
+		long int c_l_density = numeric_limits<long int>::min();
+		int c_l_adaptive = 0;
+		double c_ld_ci[2] = {numeric_limits<double>::quiet_NaN(), numeric_limits<double>::quiet_NaN()};
+		double c_ehr_ci = numeric_limits<double>::quiet_NaN();
+		double c_ld_fraction = numeric_limits<double>::quiet_NaN();
+		const char* c_pruning_method = NULL;
+		vector<long int> c_windows;
+		long int c_window = numeric_limits<long int>::min();
+		long int c_pair_cache_band = numeric_limits<long int>::min();
+
+//		Validate phase_file argument.
+		if (!isNull(phase_file)) {
+			c_phase_file = validateString(phase_file, "phase_file");
+		} else {
+			error("'%s' argument is NULL.", "phase_file");
+		}
+
+//		Validate output_file argument.
+		if (!isNull(output_files)) {
+			validateStringsLengthFree(output_files, "output_files", c_output_files);
+		} else {
+			error("'%s' argument is NULL.", "output_files");
+		}
+
+//		Validate file_format argument.
+		if (!isNull(phase_file_format)) {
+			c_phase_file_format = validateString(phase_file_format, "file_format");
+			if ((auxiliary::strcmp_ignore_case(c_phase_file_format, Db::VCF) != 0) &&
+					(auxiliary::strcmp_ignore_case(c_phase_file_format, Db::HAPMAP2) != 0) &&
+					(auxiliary::strcmp_ignore_case(c_phase_file_format, Db::IMPUTE2) != 0)) {
+				error("The file format, specified in '%s' argument, must be '%s', '%s' or '%s'.", "phase_file_format", Db::VCF, Db::HAPMAP2, Db::IMPUTE2);
+			}
+		} else {
+			error("'%s' argument is NULL.", "phase_file_format");
+		}
+
+//		Validate legend_file argument.
+		if (auxiliary::strcmp_ignore_case(c_phase_file_format, Db::HAPMAP2) == 0) {
+			if (!isNull(map_file)) {
+				c_map_file = validateString(map_file, "map_file");
+			} else {
+				error("'%s' argument is NULL.", "map_file");
+			}
+		}
+
+//		Validate regions_start and regions_end arguments
+		if (!isNull(regions_start)) {
+			validateIntegersLengthFree(regions_start, "regions_start", c_regions_start);
+		} else {
+			error("'%s' argument is NULL.", "regions_start");
+		}
+
+		if (!isNull(regions_end)) {
+			validateIntegersLengthFree(regions_end, "regions_end", c_regions_end);
+		} else {
+			error("'%s' argument is NULL.", "regions_end");
+		}
+
+		for (unsigned int i = 0u; i < c_regions_start.size(); ++i) {
+			if (c_regions_start.at(0) < 0) {
+				error("The region start positions, specified in '%s' argument, must be positive.", "regions_start");
+			}
+		}
 
 		for (unsigned int i = 0u; i < c_regions_end.size(); ++i) {
 			if (c_regions_end.at(0) < 0) {
@@ -636,18 +1469,1036 @@ extern "C" {
 			}
 		}
 
-		if (c_output_files.size() != c_regions_start.size()) {
-			error("The number of the specified output files must correspond to the number of the specified regions.");
-		}
-
-//		Validate processes argument.
-		if (!isNull(processes)) {
-			c_processes = validateInteger(processes, "processes");
-			if (c_processes < 1) {
-				error("The number of processes, specified in '%s' argument, must be greater than 0.", "processes");
+		if (c_output_files.size() != c_regions_start.size()) {
+			error("The number of the specified output files must correspond to the number of the specified regions.");
+		}
+
+//		Validate processes argument.
+		if (!isNull(processes)) {
+			c_processes = validateInteger(processes, "processes");
+			if (c_processes < 1) {
+				error("The number of processes, specified in '%s' argument, must be greater than 0.", "processes");
+			}
+		} else {
+			error("'%s' argument is NULL.", "processes");
+		}
+
+//		Validate maf argument.
+		if (!isNull(maf)) {
+			validateDoublesLengthFree(maf, "maf", c_mafs);
+			if (c_mafs.size() == 1u) {
+				c_mafs.resize(c_output_files.size(), c_mafs.at(0));
+			} else if (c_mafs.size() != c_output_files.size()) {
+				error("The number of the minor allele frequencies, specified in '%s' argument, must be 1 or correspond to the number of the specified regions.", "maf");
+			}
+			for (unsigned int i = 0u; i < c_mafs.size(); ++i) {
+				if ((c_mafs.at(i) < 0.0) || (c_mafs.at(i) > 0.5)) {
+					error("The minor allele frequency, specified in '%s' argument, must be in [0, 0.5] interval.", "maf");
+				}
+			}
+		} else {
+			error("'%s' argument is NULL.", "maf");
+		}
+
+//		Validate ci_method argument.
+		if (!isNull(ci_method)) {
+			c_ci_method = validateString(ci_method, "ci_method");
+			if ((auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) != 0) &&
+					(auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_AV) != 0)) {
+				error("The method to compute the confidence interval (CI) of D', specified in '%s' argument, must be '%s' or '%s'.", "ci_method", CI::CI_WP, CI::CI_AV);
+			}
+		} else {
+			error("'%s' argument is NULL.", "ci_method");
+		}
+
+//		Validate likelihood density argument if WP method to compute D' CI was specified.
+		if (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) {
+			if (!isNull(l_density)) {
+				c_l_density = validateInteger(l_density, "l_density");
+				if (c_l_density <= 0) {
+					error("The number of likelihood estimation points to compute confidence interval, specified in '%s' argument, must be strictly greater then 0.", "l_density");
+				}
+			} else {
+				error("'%s' argument is NULL.", "l_density");
+			}
+
+			if (!isNull(l_adaptive)) {
+				c_l_adaptive = validateBoolean(l_adaptive, "l_adaptive");
+				if (c_l_adaptive == NA_LOGICAL) {
+					error("'%s' argument contains NA value.", "l_adaptive");
+				}
+			} else {
+				error("'%s' argument is NULL.", "l_adaptive");
+			}
+		}
+
+//		Validate ld_ci argument.
+		if (!isNull(ld_ci)) {
+			validateDoubles(ld_ci, "ld_ci", c_ld_ci, 2u);
+			if ((c_ld_ci[0] < 0.0) || (c_ld_ci[0] > 1.0)) {
+				error("The lower bound of confidence interval, specified in '%s' argument, must be in [0, 1] interval.", "ld_ci");
+			}
+			if ((c_ld_ci[1] < 0.0) || (c_ld_ci[1] > 1.0)) {
+				error("The upper bound of confidence interval, specified in '%s' argument, must be in [0, 1] interval.", "ld_ci");
+			}
+			if (c_ld_ci[0] >= c_ld_ci[1]) {
+				error("The upper bound of confidence interval, specified in '%s' argument, must be greater than the lower bound.", "ld_ci");
+			}
+		} else {
+			error("'%s' argument is NULL.", "ld_ci");
+		}
+
+//		Validate ehr_ci argument.
+		if (!isNull(ehr_ci)) {
+			c_ehr_ci = validateDouble(ehr_ci, "ehr_ci");
+			if ((c_ehr_ci < 0.0) || (c_ehr_ci > 1.0)) {
+				error("The upper bound of confidence interval, specified in '%s' argument, must be in [0, 1] interval.", "ehr_ci");
+			}
+		} else {
+			error("'%s' argument is NULL.", "ehr_ci");
+		}
+
+//		Validate ld_fraction argument.
+		if (!isNull(ld_fraction)) {
+			c_ld_fraction = validateDouble(ld_fraction, "ld_fraction");
+			if ((c_ld_fraction <= 0.0) || (c_ld_fraction > 1.0)) {
+				error("The fraction of strong LD SNP pairs within a haplotype block, specified in '%s' argument, must be in (0.0, 1.0] interval.", "ld_fraction");
+			}
+		} else {
+			error("'%s' argument is NULL.", "ld_fraction");
+		}
+
+//		Validate pruning_method argument.
+		if (!isNull(pruning_method)) {
+			c_pruning_method = validateString(pruning_method, "pruning_method");
+			if ((auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIG) != 0) &&
+					(auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGP) != 0) &&
+					(auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) != 0)) {
+				error("The search space pruning method, specified in '%s' argument, must be '%s', '%s' or '%s'.",
+						"file_format", Algorithm::ALGORITHM_MIG, Algorithm::ALGORITHM_MIGP, Algorithm::ALGORITHM_MIGPP);
+			}
+		} else {
+			error("'%s' argument is NULL.", "pruning_method");
+		}
+
+//		Validate window argument if MIG++ search space pruning method was specified.
+		if (auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) {
+			if (!isNull(windows)) {
+				validateIntegersLengthFree(windows, "windows", c_windows);
+
+				for (unsigned int i = 0u; i < c_windows.size(); ++i) {
+					if (c_windows.at(i) <= 0) {
+						error("The window sizes, specified in '%s' argument, must be strictly greater than 0.", "windows");
+					}
+				}
+
+				if (c_output_files.size() != c_windows.size()) {
+					error("The number of the specified output files must correspond to the number of the specified windows.");
+				}
+			}
+		}
+
+//		Validate pair_cache_band argument.
+		if (!isNull(pair_cache_band)) {
+			c_pair_cache_band = validateInteger(pair_cache_band, "pair_cache_band");
+			if (c_pair_cache_band < 1) {
+				error("The band of the pair class cache, specified in '%s' argument, must be strictly greater than 0.", "pair_cache_band");
+			}
+		}
+
+		Algorithm* algorithm = NULL;
+		vector<Algorithm*> algorithms;
+
+		Partition* partition = NULL;
+		vector<Partition*> partitions;
+
+		CICache* ci_cache = NULL;
+		PairClassCache* class_cache = NULL;
+
+		try {
+			clock_t start_time = 0;
+			double start_time_omp = 0.0;
+			double execution_time = 0.0;
+
+			Db db;
+			const DbView* dbview = NULL;
+			vector<const DbView*> dbviews;
+			bool all_empty = true;
+			int omp_i = 0;
+			unsigned int first_index = 0u;
+			unsigned int last_index = 0u;
+
+			Rprintf("Loading data...\n");
+
+			start_time = clock();
+			db.set_hap_file(c_phase_file);
+			db.set_map_file(c_map_file);
+			db.load(0u, numeric_limits<unsigned long int>::max(), c_phase_file_format);
+			for (unsigned int i = 0u; i < c_output_files.size(); ++i) {
+				dbview = db.create_view(c_mafs.at(i), c_regions_start.at(i), c_regions_end.at(i));
+				dbviews.push_back(dbview);
+				if ((all_empty == true) && (dbview != NULL)) {
+					all_empty = false;
+				}
+			}
+			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+
+			if (all_empty == true) {
+				Rprintf("\tNot enough SNPs (<= 1) in any of the specified regions.\n");
+				Rprintf("Done (%.3f sec)\n", execution_time);
+				return R_NilValue;
+			}
+
+			Rprintf("\tPhase file: %s\n", c_phase_file);
+			Rprintf("\tMap file: %s\n", c_map_file == NULL ? "NA" : c_map_file);
+			Rprintf("\tRegions:\n");
+			for (unsigned int i = 0u; i < dbviews.size(); ++i) {
+				dbview = dbviews.at(i);
+				if (dbview != NULL) {
+					Rprintf("\t- Region: [%u, %u]\n", c_regions_start.at(i), c_regions_end.at(i));
+					Rprintf("\t--  MAF filter: > %g\n", dbview->maf_threshold);
+					Rprintf("\t--  All SNPs: %u\n", dbview->n_unfiltered_markers);
+					Rprintf("\t--  Filtered SNPs: %u\n", dbview->n_markers);
+					Rprintf("\t--  Haplotypes: %u\n", dbview->n_haplotypes);
+				}
+			}
+			Rprintf("\tUsed memory (Mb): %.3f\n", db.get_memory_usage());
+			Rprintf("Done (%.3f sec)\n", execution_time);
+
+			Rprintf("Initializing algorithm...\n");
+
+			start_time = clock();
+			if (c_windows.size() == 0) {
+				for (unsigned int i = 0u; i < dbviews.size(); ++i) {
+					c_window = numeric_limits<long int>::min();
+					dbview = dbviews.at(i);
+					if (dbview != NULL) {
+						c_window = (long int)(((double)dbview->n_markers * (1.0 - c_ld_fraction)) / 2.0);
+						if (c_window <= 0) {
+							c_window = 1;
+						}
+					}
+					c_windows.push_back(c_window);
+				}
+			}
+
+			/* one cache is shared by all regions: they are views of the same data, processed with the same CI settings */
+			if ((auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) || (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_AV) == 0)) {
+				ci_cache = new CICache();
+			}
+
+			/* the pair classes are shared as well: they are keyed by the marker indices in the Db, so overlapping regions classify every pair once */
+			if (c_pair_cache_band != numeric_limits<long int>::min()) {
+				first_index = numeric_limits<unsigned int>::max();
+				last_index = 0u;
+				for (unsigned int i = 0u; i < dbviews.size(); ++i) {
+					dbview = dbviews.at(i);
+					if (dbview != NULL) {
+						first_index = dbview->indices[0] < first_index ? dbview->indices[0] : first_index;
+						last_index = dbview->indices[dbview->n_markers - 1u] > last_index ? dbview->indices[dbview->n_markers - 1u] : last_index;
+					}
+				}
+				class_cache = new PairClassCache(first_index, last_index - first_index + 1u, (unsigned int)c_pair_cache_band);
+			}
+
+			for (unsigned int i = 0u; i < dbviews.size(); ++i) {
+				algorithm = NULL;
+				dbview = dbviews.at(i);
+				if (dbview != NULL) {
+					algorithm = AlgorithmFactory::create(c_pruning_method, c_windows.at(i));
+					algorithm->set_dbview(dbview);
+					algorithm->set_ci_method(c_ci_method);
+					algorithm->set_likelihood_density(c_l_density);
+					algorithm->set_adaptive_likelihood(c_l_adaptive);
+					algorithm->set_ci_cache(ci_cache);
+					algorithm->set_class_cache(class_cache);
+					algorithm->set_strong_pair_cl(c_ld_ci[0]);
+					algorithm->set_strong_pair_cu(c_ld_ci[1]);
+					algorithm->set_recomb_pair_cu(c_ehr_ci);
+					algorithm->set_strong_pairs_fraction(c_ld_fraction);
+				}
+				algorithms.push_back(algorithm);
+			}
+			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+
+			Rprintf("\tD' CI computation method: %s\n", c_ci_method);
+			Rprintf("\tD' likelihood density: ");
+			if (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) {
+				Rprintf("%u\n", c_l_density);
+			} else {
+				Rprintf("NA\n");
+			}
+			Rprintf("\tD' adaptive likelihood grid: ");
+			if (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) {
+				Rprintf("%s\n", c_l_adaptive ? "TRUE" : "FALSE");
+			} else {
+				Rprintf("NA\n");
+			}
+			Rprintf("\tD' CI lower bound for strong LD: >= %g\n", c_ld_ci[0]);
+			Rprintf("\tD' CI upper bound for strong LD: >= %g\n", c_ld_ci[1]);
+			Rprintf("\tD' CI upper bound for recombination: <= %g\n", c_ehr_ci);
+			Rprintf("\tFraction of strong LD SNP pairs: >= %g\n", c_ld_fraction);
+			Rprintf("\tPruning method: %s\n", c_pruning_method);
+			Rprintf("\tPair counting kernel: %s\n", PairCounter::get_kernel_name());
+			Rprintf("\tPair class cache band: ");
+			if (class_cache != NULL) {
+				Rprintf("%u\n", class_cache->get_band());
+			} else {
+				Rprintf("NA\n");
+			}
+
+
+			Rprintf("\tWindows: ");
+			if (auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) {
+				Rprintf("\n");
+				for (unsigned int i = 0u; i < dbviews.size(); ++i) {
+					dbview = dbviews.at(i);
+					if (dbview != NULL) {
+						Rprintf("\t- Region: [%u, %u]\n", c_regions_start.at(i), c_regions_end.at(i));
+						Rprintf("\t-- Window: %ld\n", c_windows.at(i));
+					}
+				}
+			} else {
+				Rprintf("NA\n", c_window);
+			}
+
+
+			Rprintf("Done (%.3f sec)\n", execution_time);
+
+			Rprintf("Processing data (%d processes)...\n", c_processes);
+
+#ifdef	_OPENMP
+			start_time_omp = omp_get_wtime();
+#else
+			start_time = clock();
+#endif
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(c_processes) private(omp_i, algorithm) schedule(dynamic, 1)
+#endif
+			for (omp_i = 0; omp_i < (int)algorithms.size(); ++omp_i) {
+				algorithm = algorithms.at(omp_i);
+				if (algorithm != NULL) {
+					algorithm->compute_preliminary_blocks();
+				}
+			}
+
+			for (unsigned int i = 0; i < algorithms.size(); ++i) {
+				partition = NULL;
+				algorithm = algorithms.at(i);
+				if (algorithm != NULL) {
+					partition = algorithm->get_block_partition();
+				}
+				partitions.push_back(partition);
+			}
+
+#ifdef	_OPENMP
+			execution_time = omp_get_wtime() - start_time_omp;
+#else
+			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+#endif
+
+			for (unsigned int i = 0u; i < dbviews.size(); ++i) {
+				dbview = dbviews.at(i);
+				if (dbview != NULL) {
+					algorithm = algorithms.at(i);
+					partition = partitions.at(i);
+					Rprintf("\t- Region: [%u, %u]\n", c_regions_start.at(i), c_regions_end.at(i));
+					Rprintf("\t-- Preliminary haplotype blocks: %u\n", algorithm->get_n_preliminary_blocks());
+					Rprintf("\t-- Final haplotype blocks: %u\n", partition->get_n_blocks());
+					Rprintf("\t-- Memory used for preliminary haplotype blocks (Mb): %.3g\n", algorithm->get_memory_usage_preliminary_blocks());
+					Rprintf("\t-- Memory used for final haplotype blocks (Mb): %.3g\n", partition->get_memory_usage());
+					Rprintf("\t-- Memory used by algorithm (Mb): %.3g\n", algorithm->get_memory_usage());
+					Rprintf("\t-- Total used memory (Mb): %.3g\n", algorithm->get_memory_usage_preliminary_blocks() + partition->get_memory_usage() + algorithm->get_memory_usage());
+				}
+			}
+			if (ci_cache != NULL) {
+				Rprintf("\tD' CI cache hit rate: %.3g (%.0f of %.0f lookups)\n", ci_cache->get_hit_rate(), ci_cache->get_n_hits(), ci_cache->get_n_lookups());
+				Rprintf("\tMemory used by D' CI cache (Mb): %.3g\n", ci_cache->get_memory_usage());
+			}
+			if (class_cache != NULL) {
+				Rprintf("\tMemory used by pair class cache (Mb): %.3g\n", class_cache->get_memory_usage());
+			}
+			Rprintf("Done (%.3f sec)\n", execution_time);
+
+			Rprintf("Writing results...\n");
+
+			start_time = clock();
+			for (unsigned int i = 0; i < partitions.size(); ++i) {
+				Rprintf("\tOutput file: %s\n", c_output_files.at(i));
+
+				partition = partitions.at(i);
+				if (partition != NULL) {
+					partition->write(c_output_files.at(i));
+				}
+			}
+			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+
+			Rprintf("Done (%.3f sec)\n", execution_time);
+
+			for (unsigned int i = 0u; i < partitions.size(); ++i) {
+				partition = partitions.at(i);
+				if (partition != NULL) {
+					delete partition;
+				}
+			}
+			partitions.clear();
+
+			for (unsigned int i = 0u; i < algorithms.size(); ++i) {
+				algorithm = algorithms.at(i);
+				if (algorithm != NULL) {
+					delete algorithm;
+				}
+			}
+			algorithms.clear();
+
+			delete ci_cache;
+			ci_cache = NULL;
+
+			delete class_cache;
+			class_cache = NULL;
+
+		} catch (Exception &e) {
+			for (unsigned int i = 0u; i < partitions.size(); ++i) {
+				partition = partitions.at(i);
+				if (partition != NULL) {
+					delete partition;
+				}
+			}
+			partitions.clear();
+
+			for (unsigned int i = 0u; i < algorithms.size(); ++i) {
+				algorithm = algorithms.at(i);
+				if (algorithm != NULL) {
+					delete algorithm;
+				}
+			}
+			algorithms.clear();
+
+			delete ci_cache;
+			ci_cache = NULL;
+
+			delete class_cache;
+			class_cache = NULL;
+
+			error("%s", e.what());
+		}
+
+		return R_NilValue;
+	}
+
+	SEXP mig_populations(SEXP phase_file, SEXP output_files, SEXP population_samples, SEXP population_sizes, SEXP processes,
+			SEXP phase_file_format, SEXP map_file, SEXP region,
+			SEXP maf, SEXP ci_method, SEXP l_density, SEXP ld_ci, SEXP ehr_ci, SEXP ld_fraction,
+			SEXP pruning_method, SEXP windows, SEXP l_adaptive) {
+
+		const char* c_phase_file = NULL;
+		vector<const char*> c_output_files;
+		const char* c_phase_file_format = NULL;
+		const char* c_map_file = NULL;
+		vector<long int> c_population_samples;
+		vector<long int> c_population_sizes;
+		vector<unsigned int> c_samples;
+		long int c_processes = numeric_limits<long int>::min();
+		long int c_region[2] = {numeric_limits<long int>::min(), numeric_limits<long int>::min()};
+		vector<double> c_mafs;
+		const char* c_ci_method = NULL;
+		long int c_l_density = numeric_limits<long int>::min();
+		int c_l_adaptive = 0;
+		double c_ld_ci[2] = {numeric_limits<double>::quiet_NaN(), numeric_limits<double>::quiet_NaN()};
+		double c_ehr_ci = numeric_limits<double>::quiet_NaN();
+		double c_ld_fraction = numeric_limits<double>::quiet_NaN();
+		const char* c_pruning_method = NULL;
+		vector<long int> c_windows;
+		long int c_window = numeric_limits<long int>::min();
+		unsigned long int n_samples = 0u;
+
+//		Validate phase_file argument.
+		if (!isNull(phase_file)) {
+			c_phase_file = validateString(phase_file, "phase_file");
+		} else {
+			error("'%s' argument is NULL.", "phase_file");
+		}
+
+//		Validate output_file argument.
+		if (!isNull(output_files)) {
+			validateStringsLengthFree(output_files, "output_files", c_output_files);
+		} else {
+			error("'%s' argument is NULL.", "output_files");
+		}
+
+//		Validate file_format argument.
+		if (!isNull(phase_file_format)) {
+			c_phase_file_format = validateString(phase_file_format, "file_format");
+			if ((auxiliary::strcmp_ignore_case(c_phase_file_format, Db::VCF) != 0) &&
+					(auxiliary::strcmp_ignore_case(c_phase_file_format, Db::HAPMAP2) != 0) &&
+					(auxiliary::strcmp_ignore_case(c_phase_file_format, Db::IMPUTE2) != 0)) {
+				error("The file format, specified in '%s' argument, must be '%s', '%s' or '%s'.", "phase_file_format", Db::VCF, Db::HAPMAP2, Db::IMPUTE2);
+			}
+		} else {
+			error("'%s' argument is NULL.", "phase_file_format");
+		}
+
+//		Validate legend_file argument.
+		if (auxiliary::strcmp_ignore_case(c_phase_file_format, Db::HAPMAP2) == 0) {
+			if (!isNull(map_file)) {
+				c_map_file = validateString(map_file, "map_file");
+			} else {
+				error("'%s' argument is NULL.", "map_file");
+			}
+		}
+
+//		Validate population_samples and population_sizes arguments.
+		if (!isNull(population_samples)) {
+			validateIntegersLengthFree(population_samples, "populations", c_population_samples);
+		} else {
+			error("'%s' argument is NULL.", "populations");
+		}
+
+		if (!isNull(population_sizes)) {
+			validateIntegersLengthFree(population_sizes, "populations", c_population_sizes);
+		} else {
+			error("'%s' argument is NULL.", "populations");
+		}
+
+		for (unsigned int i = 0u; i < c_population_sizes.size(); ++i) {
+			if (c_population_sizes.at(i) <= 0) {
+				error("Every population, specified in '%s' argument, must have at least one sample.", "populations");
+			}
+			n_samples += c_population_sizes.at(i);
+		}
+
+		if (n_samples != c_population_samples.size()) {
+			error("The number of samples, specified in '%s' argument, does not correspond to the population sizes.", "populations");
+		}
+
+		for (unsigned int i = 0u; i < c_population_samples.size(); ++i) {
+			if (c_population_samples.at(i) <= 0) {
+				error("The sample indices, specified in '%s' argument, must be strictly greater than 0.", "populations");
+			}
+			c_samples.push_back((unsigned int)(c_population_samples.at(i) - 1));
+		}
+
+		if (c_output_files.size() != c_population_sizes.size()) {
+			error("The number of the specified output files must correspond to the number of the specified populations.");
+		}
+
+//		Validate processes argument.
+		if (!isNull(processes)) {
+			c_processes = validateInteger(processes, "processes");
+			if (c_processes < 1) {
+				error("The number of processes, specified in '%s' argument, must be greater than 0.", "processes");
+			}
+		} else {
+			error("'%s' argument is NULL.", "processes");
+		}
+
+//		Validate region argument.
+		if (!isNull(region)) {
+			validateIntegers(region, "region", c_region, 2u);
+			if (c_region[0] < 0) {
+				error("The region start position, specified in '%s' argument, must be positive.", "region");
+			}
+			if (c_region[1] < 0) {
+				error("The region end position, specified in '%s' argument, must be positive.", "region");
+			}
+			if (c_region[0] >= c_region[1]) {
+				error("The region end position, specified in '%s' argument, must be strictly greater than the region start position.", "region");
+			}
+		}
+
+//		Validate maf argument.
+		if (!isNull(maf)) {
+			validateDoublesLengthFree(maf, "maf", c_mafs);
+			if (c_mafs.size() == 1u) {
+				c_mafs.resize(c_output_files.size(), c_mafs.at(0));
+			} else if (c_mafs.size() != c_output_files.size()) {
+				error("The number of the minor allele frequencies, specified in '%s' argument, must be 1 or correspond to the number of the specified populations.", "maf");
+			}
+			for (unsigned int i = 0u; i < c_mafs.size(); ++i) {
+				if ((c_mafs.at(i) < 0.0) || (c_mafs.at(i) > 0.5)) {
+					error("The minor allele frequency, specified in '%s' argument, must be in [0, 0.5] interval.", "maf");
+				}
+			}
+		} else {
+			error("'%s' argument is NULL.", "maf");
+		}
+
+//		Validate ci_method argument.
+		if (!isNull(ci_method)) {
+			c_ci_method = validateString(ci_method, "ci_method");
+			if ((auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) != 0) &&
+					(auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_AV) != 0)) {
+				error("The method to compute the confidence interval (CI) of D', specified in '%s' argument, must be '%s' or '%s'.", "ci_method", CI::CI_WP, CI::CI_AV);
+			}
+		} else {
+			error("'%s' argument is NULL.", "ci_method");
+		}
+
+//		Validate likelihood density argument if WP method to compute D' CI was specified.
+		if (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) {
+			if (!isNull(l_density)) {
+				c_l_density = validateInteger(l_density, "l_density");
+				if (c_l_density <= 0) {
+					error("The number of likelihood estimation points to compute confidence interval, specified in '%s' argument, must be strictly greater then 0.", "l_density");
+				}
+			} else {
+				error("'%s' argument is NULL.", "l_density");
+			}
+
+			if (!isNull(l_adaptive)) {
+				c_l_adaptive = validateBoolean(l_adaptive, "l_adaptive");
+				if (c_l_adaptive == NA_LOGICAL) {
+					error("'%s' argument contains NA value.", "l_adaptive");
+				}
+			} else {
+				error("'%s' argument is NULL.", "l_adaptive");
+			}
+		}
+
+//		Validate ld_ci argument.
+		if (!isNull(ld_ci)) {
+			validateDoubles(ld_ci, "ld_ci", c_ld_ci, 2u);
+			if ((c_ld_ci[0] < 0.0) || (c_ld_ci[0] > 1.0)) {
+				error("The lower bound of confidence interval, specified in '%s' argument, must be in [0, 1] interval.", "ld_ci");
+			}
+			if ((c_ld_ci[1] < 0.0) || (c_ld_ci[1] > 1.0)) {
+				error("The upper bound of confidence interval, specified in '%s' argument, must be in [0, 1] interval.", "ld_ci");
+			}
+			if (c_ld_ci[0] >= c_ld_ci[1]) {
+				error("The upper bound of confidence interval, specified in '%s' argument, must be greater than the lower bound.", "ld_ci");
+			}
+		} else {
+			error("'%s' argument is NULL.", "ld_ci");
+		}
+
+//		Validate ehr_ci argument.
+		if (!isNull(ehr_ci)) {
+			c_ehr_ci = validateDouble(ehr_ci, "ehr_ci");
+			if ((c_ehr_ci < 0.0) || (c_ehr_ci > 1.0)) {
+				error("The upper bound of confidence interval, specified in '%s' argument, must be in [0, 1] interval.", "ehr_ci");
+			}
+		} else {
+			error("'%s' argument is NULL.", "ehr_ci");
+		}
+
+//		Validate ld_fraction argument.
+		if (!isNull(ld_fraction)) {
+			c_ld_fraction = validateDouble(ld_fraction, "ld_fraction");
+			if ((c_ld_fraction <= 0.0) || (c_ld_fraction > 1.0)) {
+				error("The fraction of strong LD SNP pairs within a haplotype block, specified in '%s' argument, must be in (0.0, 1.0] interval.", "ld_fraction");
+			}
+		} else {
+			error("'%s' argument is NULL.", "ld_fraction");
+		}
+
+//		Validate pruning_method argument.
+		if (!isNull(pruning_method)) {
+			c_pruning_method = validateString(pruning_method, "pruning_method");
+			if ((auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIG) != 0) &&
+					(auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGP) != 0) &&
+					(auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) != 0)) {
+				error("The search space pruning method, specified in '%s' argument, must be '%s', '%s' or '%s'.",
+						"file_format", Algorithm::ALGORITHM_MIG, Algorithm::ALGORITHM_MIGP, Algorithm::ALGORITHM_MIGPP);
+			}
+		} else {
+			error("'%s' argument is NULL.", "pruning_method");
+		}
+
+//		Validate window argument if MIG++ search space pruning method was specified.
+		if (auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) {
+			if (!isNull(windows)) {
+				validateIntegersLengthFree(windows, "windows", c_windows);
+
+				for (unsigned int i = 0u; i < c_windows.size(); ++i) {
+					if (c_windows.at(i) <= 0) {
+						error("The window sizes, specified in '%s' argument, must be strictly greater than 0.", "windows");
+					}
+				}
+
+				if (c_output_files.size() != c_windows.size()) {
+					error("The number of the specified output files must correspond to the number of the specified windows.");
+				}
+			}
+		}
+
+		Algorithm* algorithm = NULL;
+		vector<Algorithm*> algorithms;
+
+		Partition* partition = NULL;
+		vector<Partition*> partitions;
+
+		CICache* ci_cache = NULL;
+
+		try {
+			clock_t start_time = 0;
+			double start_time_omp = 0.0;
+			double execution_time = 0.0;
+
+			Db db;
+			const DbView* dbview = NULL;
+			vector<const DbView*> dbviews;
+			bool all_empty = true;
+			bool population_failed = false;
+			string population_failure;
+			int omp_i = 0;
+			unsigned int first_sample = 0u;
+			unsigned long int start_position = c_region[0] == numeric_limits<long int>::min() ? 0u : (unsigned long int)c_region[0];
+			unsigned long int end_position = c_region[1] == numeric_limits<long int>::min() ? numeric_limits<unsigned long int>::max() : (unsigned long int)c_region[1];
+
+			Rprintf("Loading data...\n");
+
+			/* the phase file is loaded once; every population is a masked view of the same bitplanes */
+			start_time = clock();
+			db.set_hap_file(c_phase_file);
+			db.set_map_file(c_map_file);
+			db.load(start_position, end_position, c_phase_file_format);
+			for (unsigned int i = 0u; i < c_output_files.size(); ++i) {
+				dbview = db.create_population_view(c_mafs.at(i), start_position, end_position, &c_samples.at(first_sample), (unsigned int)c_population_sizes.at(i));
+				first_sample += (unsigned int)c_population_sizes.at(i);
+				dbviews.push_back(dbview);
+				if ((all_empty == true) && (dbview != NULL)) {
+					all_empty = false;
+				}
+			}
+			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+
+			if (all_empty == true) {
+				Rprintf("\tNot enough SNPs (<= 1) in any of the specified populations.\n");
+				Rprintf("Done (%.3f sec)\n", execution_time);
+				return R_NilValue;
+			}
+
+			Rprintf("\tPhase file: %s\n", c_phase_file);
+			Rprintf("\tMap file: %s\n", c_map_file == NULL ? "NA" : c_map_file);
+			if ((c_region[0] != numeric_limits<long int>::min()) && (c_region[1] != numeric_limits<long int>::min())) {
+				Rprintf("\tRegion: [%u, %u]\n", c_region[0], c_region[1]);
+			} else {
+				Rprintf("\tRegion: NA\n");
+			}
+			Rprintf("\tPopulations:\n");
+			for (unsigned int i = 0u; i < dbviews.size(); ++i) {
+				dbview = dbviews.at(i);
+				Rprintf("\t- Population %u: %ld samples\n", i + 1u, c_population_sizes.at(i));
+				if (dbview != NULL) {
+					Rprintf("\t--  MAF filter: > %g\n", dbview->maf_threshold);
+					Rprintf("\t--  All SNPs: %u\n", dbview->n_unfiltered_markers);
+					Rprintf("\t--  Filtered SNPs: %u\n", dbview->n_markers);
+					Rprintf("\t--  Haplotypes: %u\n", dbview->n_haplotypes);
+				} else {
+					Rprintf("\t--  Not enough SNPs (<= 1)\n");
+				}
+			}
+			Rprintf("\tUsed memory (Mb): %.3f\n", db.get_memory_usage());
+			Rprintf("Done (%.3f sec)\n", execution_time);
+
+			Rprintf("Initializing algorithm...\n");
+
+			start_time = clock();
+			if (c_windows.size() == 0) {
+				for (unsigned int i = 0u; i < dbviews.size(); ++i) {
+					c_window = numeric_limits<long int>::min();
+					dbview = dbviews.at(i);
+					if (dbview != NULL) {
+						c_window = (long int)(((double)dbview->n_markers * (1.0 - c_ld_fraction)) / 2.0);
+						if (c_window <= 0) {
+							c_window = 1;
+						}
+					}
+					c_windows.push_back(c_window);
+				}
+			}
+
+			/* the CI cache is keyed by the 2x2 tables, so it is shared by all populations (unlike the pair classes, which differ between populations) */
+			if ((auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) || (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_AV) == 0)) {
+				ci_cache = new CICache();
+			}
+
+			for (unsigned int i = 0u; i < dbviews.size(); ++i) {
+				algorithm = NULL;
+				dbview = dbviews.at(i);
+				if (dbview != NULL) {
+					algorithm = AlgorithmFactory::create(c_pruning_method, c_windows.at(i));
+					algorithm->set_dbview(dbview);
+					algorithm->set_ci_method(c_ci_method);
+					algorithm->set_likelihood_density(c_l_density);
+					algorithm->set_adaptive_likelihood(c_l_adaptive);
+					algorithm->set_ci_cache(ci_cache);
+					algorithm->set_strong_pair_cl(c_ld_ci[0]);
+					algorithm->set_strong_pair_cu(c_ld_ci[1]);
+					algorithm->set_recomb_pair_cu(c_ehr_ci);
+					algorithm->set_strong_pairs_fraction(c_ld_fraction);
+				}
+				algorithms.push_back(algorithm);
+			}
+			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+
+			Rprintf("\tD' CI computation method: %s\n", c_ci_method);
+			Rprintf("\tD' likelihood density: ");
+			if (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) {
+				Rprintf("%u\n", c_l_density);
+			} else {
+				Rprintf("NA\n");
+			}
+			Rprintf("\tD' adaptive likelihood grid: ");
+			if (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) {
+				Rprintf("%s\n", c_l_adaptive ? "TRUE" : "FALSE");
+			} else {
+				Rprintf("NA\n");
+			}
+			Rprintf("\tD' CI lower bound for strong LD: >= %g\n", c_ld_ci[0]);
+			Rprintf("\tD' CI upper bound for strong LD: >= %g\n", c_ld_ci[1]);
+			Rprintf("\tD' CI upper bound for recombination: <= %g\n", c_ehr_ci);
+			Rprintf("\tFraction of strong LD SNP pairs: >= %g\n", c_ld_fraction);
+			Rprintf("\tPruning method: %s\n", c_pruning_method);
+			Rprintf("\tPair counting kernel: %s\n", PairCounter::get_kernel_name());
+
+			Rprintf("\tWindows: ");
+			if (auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) {
+				Rprintf("\n");
+				for (unsigned int i = 0u; i < dbviews.size(); ++i) {
+					dbview = dbviews.at(i);
+					if (dbview != NULL) {
+						Rprintf("\t- Population %u\n", i + 1u);
+						Rprintf("\t-- Window: %ld\n", c_windows.at(i));
+					}
+				}
+			} else {
+				Rprintf("NA\n");
+			}
+
+			Rprintf("Done (%.3f sec)\n", execution_time);
+
+			Rprintf("Processing data (%d processes)...\n", c_processes);
+
+#ifdef	_OPENMP
+			start_time_omp = omp_get_wtime();
+#else
+			start_time = clock();
+#endif
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(c_processes) private(omp_i, algorithm) schedule(dynamic, 1)
+#endif
+			for (omp_i = 0; omp_i < (int)algorithms.size(); ++omp_i) {
+				algorithm = algorithms.at(omp_i);
+				if (algorithm != NULL) {
+					/* exceptions must not leave the parallel region */
+					try {
+						algorithm->compute_preliminary_blocks();
+					} catch (Exception &e) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+						{
+							if (!population_failed) {
+								population_failure = e.what();
+							}
+							population_failed = true;
+						}
+					}
+				}
+			}
+
+			if (population_failed) {
+				throw Exception(__FILE__, __LINE__, "%s", population_failure.c_str());
+			}
+
+			for (unsigned int i = 0; i < algorithms.size(); ++i) {
+				partition = NULL;
+				algorithm = algorithms.at(i);
+				if (algorithm != NULL) {
+					partition = algorithm->get_block_partition();
+				}
+				partitions.push_back(partition);
+			}
+
+#ifdef	_OPENMP
+			execution_time = omp_get_wtime() - start_time_omp;
+#else
+			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+#endif
+
+			for (unsigned int i = 0u; i < dbviews.size(); ++i) {
+				dbview = dbviews.at(i);
+				if (dbview != NULL) {
+					algorithm = algorithms.at(i);
+					partition = partitions.at(i);
+					Rprintf("\t- Population %u\n", i + 1u);
+					Rprintf("\t-- Preliminary haplotype blocks: %u\n", algorithm->get_n_preliminary_blocks());
+					Rprintf("\t-- Final haplotype blocks: %u\n", partition->get_n_blocks());
+					Rprintf("\t-- Memory used for preliminary haplotype blocks (Mb): %.3g\n", algorithm->get_memory_usage_preliminary_blocks());
+					Rprintf("\t-- Memory used for final haplotype blocks (Mb): %.3g\n", partition->get_memory_usage());
+					Rprintf("\t-- Memory used by algorithm (Mb): %.3g\n", algorithm->get_memory_usage());
+					Rprintf("\t-- Total used memory (Mb): %.3g\n", algorithm->get_memory_usage_preliminary_blocks() + partition->get_memory_usage() + algorithm->get_memory_usage());
+				}
+			}
+			if (ci_cache != NULL) {
+				Rprintf("\tD' CI cache hit rate: %.3g (%.0f of %.0f lookups)\n", ci_cache->get_hit_rate(), ci_cache->get_n_hits(), ci_cache->get_n_lookups());
+				Rprintf("\tMemory used by D' CI cache (Mb): %.3g\n", ci_cache->get_memory_usage());
+			}
+			Rprintf("Done (%.3f sec)\n", execution_time);
+
+			Rprintf("Writing results...\n");
+
+			start_time = clock();
+			for (unsigned int i = 0; i < partitions.size(); ++i) {
+				Rprintf("\tOutput file: %s\n", c_output_files.at(i));
+
+				partition = partitions.at(i);
+				if (partition != NULL) {
+					partition->write(c_output_files.at(i));
+				}
+			}
+			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+
+			Rprintf("Done (%.3f sec)\n", execution_time);
+
+			for (unsigned int i = 0u; i < partitions.size(); ++i) {
+				partition = partitions.at(i);
+				if (partition != NULL) {
+					delete partition;
+				}
+			}
+			partitions.clear();
+
+			for (unsigned int i = 0u; i < algorithms.size(); ++i) {
+				algorithm = algorithms.at(i);
+				if (algorithm != NULL) {
+					delete algorithm;
+				}
+			}
+			algorithms.clear();
+
+			delete ci_cache;
+			ci_cache = NULL;
+
+		} catch (Exception &e) {
+			for (unsigned int i = 0u; i < partitions.size(); ++i) {
+				partition = partitions.at(i);
+				if (partition != NULL) {
+					delete partition;
+				}
+			}
+			partitions.clear();
+
+			for (unsigned int i = 0u; i < algorithms.size(); ++i) {
+				algorithm = algorithms.at(i);
+				if (algorithm != NULL) {
+					delete algorithm;
+				}
+			}
+			algorithms.clear();
+
+			delete ci_cache;
+			ci_cache = NULL;
+
+			error("%s", e.what());
+		}
+
+		return R_NilValue;
+	}
+
+	SEXP mig_bootstrap(SEXP phase_file, SEXP output_file, SEXP replicates, SEXP processes, SEXP seed,
+			SEXP phase_file_format, SEXP map_file, SEXP region,
+			SEXP maf, SEXP ci_method, SEXP l_density, SEXP ld_ci, SEXP ehr_ci, SEXP ld_fraction,
+			SEXP pruning_method, SEXP window, SEXP l_adaptive) {
+
+		const char* c_phase_file = NULL;
+		const char* c_output_file = NULL;
+		long int c_replicates = numeric_limits<long int>::min();
+		long int c_processes = numeric_limits<long int>::min();
+		double c_seed = numeric_limits<double>::quiet_NaN();
+		const char* c_phase_file_format = NULL;
+		const char* c_map_file = NULL;
+		long int c_region[2] = {numeric_limits<long int>::min(), numeric_limits<long int>::min()};
+		double c_maf = numeric_limits<double>::quiet_NaN();
+		const char* c_ci_method = NULL;
+		long int c_l_density = numeric_limits<long int>::min();
+		int c_l_adaptive = 0;
+		double c_ld_ci[2] = {numeric_limits<double>::quiet_NaN(), numeric_limits<double>::quiet_NaN()};
+		double c_ehr_ci = numeric_limits<double>::quiet_NaN();
+		double c_ld_fraction = numeric_limits<double>::quiet_NaN();
+		const char* c_pruning_method = NULL;
+		long int c_window = numeric_limits<long int>::min();
+
+//		Validate phase_file argument.
+		if (!isNull(phase_file)) {
+			c_phase_file = validateString(phase_file, "phase_file");
+		} else {
+			error("'%s' argument is NULL.", "phase_file");
+		}
+
+//		Validate output_file argument.
+		if (!isNull(output_file)) {
+			c_output_file = validateString(output_file, "output_file");
+		} else {
+			error("'%s' argument is NULL.", "output_file");
+		}
+
+//		Validate replicates argument.
+		if (!isNull(replicates)) {
+			c_replicates = validateInteger(replicates, "replicates");
+			if (c_replicates < 1) {
+				error("The number of bootstrap replicates, specified in '%s' argument, must be greater than 0.", "replicates");
+			}
+		} else {
+			error("'%s' argument is NULL.", "replicates");
+		}
+
+//		Validate processes argument.
+		if (!isNull(processes)) {
+			c_processes = validateInteger(processes, "processes");
+			if (c_processes < 1) {
+				error("The number of processes, specified in '%s' argument, must be greater than 0.", "processes");
+			}
+		} else {
+			error("'%s' argument is NULL.", "processes");
+		}
+
+//		Validate seed argument.
+		if (!isNull(seed)) {
+			c_seed = validateDouble(seed, "seed");
+			if ((c_seed < 0.0) || (c_seed != floor(c_seed))) {
+				error("The seed, specified in '%s' argument, must be a non-negative integer.", "seed");
+			}
+		} else {
+			error("'%s' argument is NULL.", "seed");
+		}
+
+//		Validate file_format argument.
+		if (!isNull(phase_file_format)) {
+			c_phase_file_format = validateString(phase_file_format, "file_format");
+			if ((auxiliary::strcmp_ignore_case(c_phase_file_format, Db::VCF) != 0) &&
+					(auxiliary::strcmp_ignore_case(c_phase_file_format, Db::HAPMAP2) != 0) &&
+					(auxiliary::strcmp_ignore_case(c_phase_file_format, Db::IMPUTE2) != 0)) {
+				error("The file format, specified in '%s' argument, must be '%s', '%s' or '%s'.", "phase_file_format", Db::VCF, Db::HAPMAP2, Db::IMPUTE2);
+			}
+		} else {
+			error("'%s' argument is NULL.", "phase_file_format");
+		}
+
+//		Validate legend_file argument.
+		if (auxiliary::strcmp_ignore_case(c_phase_file_format, Db::HAPMAP2) == 0) {
+			if (!isNull(map_file)) {
+				c_map_file = validateString(map_file, "map_file");
+			} else {
+				error("'%s' argument is NULL.", "map_file");
+			}
+		}
+
+//		Validate region argument.
+		if (!isNull(region)) {
+			validateIntegers(region, "region", c_region, 2u);
+			if (c_region[0] < 0) {
+				error("The region start position, specified in '%s' argument, must be positive.", "region");
+			}
+			if (c_region[1] < 0) {
+				error("The region end position, specified in '%s' argument, must be positive.", "region");
+			}
+			if (c_region[0] >= c_region[1]) {
+				error("The region end position, specified in '%s' argument, must be strictly greater than the region start position.", "region");
 			}
-		} else {
-			error("'%s' argument is NULL.", "processes");
 		}
 
 //		Validate maf argument.
@@ -681,6 +2532,15 @@ extern "C" {
 			} else {
 				error("'%s' argument is NULL.", "l_density");
 			}
+
+			if (!isNull(l_adaptive)) {
+				c_l_adaptive = validateBoolean(l_adaptive, "l_adaptive");
+				if (c_l_adaptive == NA_LOGICAL) {
+					error("'%s' argument contains NA value.", "l_adaptive");
+				}
+			} else {
+				error("'%s' argument is NULL.", "l_adaptive");
+			}
 		}
 
 //		Validate ld_ci argument.
@@ -734,26 +2594,16 @@ extern "C" {
 
 //		Validate window argument if MIG++ search space pruning method was specified.
 		if (auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) {
-			if (!isNull(windows)) {
-				validateIntegersLengthFree(windows, "windows", c_windows);
-
-				for (unsigned int i = 0u; i < c_windows.size(); ++i) {
-					if (c_windows.at(i) <= 0) {
-						error("The window sizes, specified in '%s' argument, must be strictly greater than 0.", "windows");
-					}
-				}
-
-				if (c_output_files.size() != c_windows.size()) {
-					error("The number of the specified output files must correspond to the number of the specified windows.");
+			if (!isNull(window)) {
+				c_window = validateInteger(window, "window");
+				if (c_window <= 0) {
+					error("The window size, specified in '%s' argument, must be strictly greater than 0.", "window");
 				}
 			}
 		}
 
-		Algorithm* algorithm = NULL;
-		vector<Algorithm*> algorithms;
-
-		Partition* partition = NULL;
-		vector<Partition*> partitions;
+		BlockStability* stability = NULL;
+		CICache* ci_cache = NULL;
 
 		try {
 			clock_t start_time = 0;
@@ -762,8 +2612,11 @@ extern "C" {
 
 			Db db;
 			const DbView* dbview = NULL;
-			vector<const DbView*> dbviews;
-			bool all_empty = true;
+			BootstrapReplicate* replicate = NULL;
+			Algorithm* algorithm = NULL;
+			Partition* partition = NULL;
+			bool replicate_failed = false;
+			string replicate_failure;
 			int omp_i = 0;
 
 			Rprintf("Loading data...\n");
@@ -771,71 +2624,41 @@ extern "C" {
 			start_time = clock();
 			db.set_hap_file(c_phase_file);
 			db.set_map_file(c_map_file);
-			db.load(0u, numeric_limits<unsigned long int>::max(), c_phase_file_format);
-			for (unsigned int i = 0u; i < c_output_files.size(); ++i) {
-				dbview = db.create_view(c_maf, c_regions_start.at(i), c_regions_end.at(i));
-				dbviews.push_back(dbview);
-				if ((all_empty == true) && (dbview != NULL)) {
-					all_empty = false;
-				}
-			}
+			db.load(c_region[0] == numeric_limits<long int>::min() ? 0u : (unsigned long int)c_region[0], c_region[1] == numeric_limits<long int>::min() ? numeric_limits<unsigned long int>::max() : (unsigned long int)c_region[1], c_phase_file_format);
+			dbview = db.create_view(c_maf, c_region[0] == numeric_limits<long int>::min() ? 0u : (unsigned long int)c_region[0], c_region[1] == numeric_limits<long int>::min() ? numeric_limits<unsigned long int>::max() : (unsigned long int)c_region[1]);
 			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
 
-			if (all_empty == true) {
-				Rprintf("\tNot enough SNPs (<= 1) in any of the specified regions.\n");
+			if (dbview == NULL) {
+				Rprintf("\tNot enough SNPs (<= 1) in the specified region.\n");
 				Rprintf("Done (%.3f sec)\n", execution_time);
 				return R_NilValue;
 			}
 
 			Rprintf("\tPhase file: %s\n", c_phase_file);
 			Rprintf("\tMap file: %s\n", c_map_file == NULL ? "NA" : c_map_file);
-			Rprintf("\tRegions:\n");
-			for (unsigned int i = 0u; i < dbviews.size(); ++i) {
-				dbview = dbviews.at(i);
-				if (dbview != NULL) {
-					Rprintf("\t- Region: [%u, %u]\n", c_regions_start.at(i), c_regions_end.at(i));
-					Rprintf("\t--  MAF filter: > %g\n", dbview->maf_threshold);
-					Rprintf("\t--  All SNPs: %u\n", dbview->n_unfiltered_markers);
-					Rprintf("\t--  Filtered SNPs: %u\n", dbview->n_markers);
-					Rprintf("\t--  Haplotypes: %u\n", dbview->n_haplotypes);
-				}
+			if ((c_region[0] != numeric_limits<long int>::min()) && (c_region[1] != numeric_limits<long int>::min())) {
+				Rprintf("\tRegion: [%u, %u]\n", c_region[0], c_region[1]);
+			} else {
+				Rprintf("\tRegion: NA\n");
 			}
+			Rprintf("\tMAF filter: > %g\n", dbview->maf_threshold);
+			Rprintf("\tAll SNPs: %u\n", dbview->n_unfiltered_markers);
+			Rprintf("\tFiltered SNPs: %u\n", dbview->n_markers);
+			Rprintf("\tHaplotypes: %u\n", dbview->n_haplotypes);
 			Rprintf("\tUsed memory (Mb): %.3f\n", db.get_memory_usage());
 			Rprintf("Done (%.3f sec)\n", execution_time);
 
 			Rprintf("Initializing algorithm...\n");
-
 			start_time = clock();
-			if (c_windows.size() == 0) {
-				for (unsigned int i = 0u; i < dbviews.size(); ++i) {
-					c_window = numeric_limits<long int>::min();
-					dbview = dbviews.at(i);
-					if (dbview != NULL) {
-						c_window = (long int)(((double)dbview->n_markers * (1.0 - c_ld_fraction)) / 2.0);
-						if (c_window <= 0) {
-							c_window = 1;
-						}
-					}
-					c_windows.push_back(c_window);
-				}
-			}
 
-			for (unsigned int i = 0u; i < dbviews.size(); ++i) {
-				algorithm = NULL;
-				dbview = dbviews.at(i);
-				if (dbview != NULL) {
-					algorithm = AlgorithmFactory::create(c_pruning_method, c_windows.at(i));
-					algorithm->set_dbview(dbview);
-					algorithm->set_ci_method(c_ci_method);
-					algorithm->set_likelihood_density(c_l_density);
-					algorithm->set_strong_pair_cl(c_ld_ci[0]);
-					algorithm->set_strong_pair_cu(c_ld_ci[1]);
-					algorithm->set_recomb_pair_cu(c_ehr_ci);
-					algorithm->set_strong_pairs_fraction(c_ld_fraction);
-				}
-				algorithms.push_back(algorithm);
+			/* the SNPs (and the MAF filter) are those of the loaded data, so that the replicates are comparable marker by marker */
+			stability = new BlockStability(dbview);
+			stability->seed = (uint64_t)c_seed;
+
+			/* the CI cache is keyed by the 2x2 tables, so it is shared by all replicates */
+			if ((auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) || (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_AV) == 0)) {
+				ci_cache = new CICache();
 			}
-			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
 
 			Rprintf("\tD' CI computation method: %s\n", c_ci_method);
 			Rprintf("\tD' likelihood density: ");
@@ -844,28 +2667,34 @@ extern "C" {
 			} else {
 				Rprintf("NA\n");
 			}
+			Rprintf("\tD' adaptive likelihood grid: ");
+			if (auxiliary::strcmp_ignore_case(c_ci_method, CI::CI_WP) == 0) {
+				Rprintf("%s\n", c_l_adaptive ? "TRUE" : "FALSE");
+			} else {
+				Rprintf("NA\n");
+			}
 			Rprintf("\tD' CI lower bound for strong LD: >= %g\n", c_ld_ci[0]);
 			Rprintf("\tD' CI upper bound for strong LD: >= %g\n", c_ld_ci[1]);
 			Rprintf("\tD' CI upper bound for recombination: <= %g\n", c_ehr_ci);
 			Rprintf("\tFraction of strong LD SNP pairs: >= %g\n", c_ld_fraction);
 			Rprintf("\tPruning method: %s\n", c_pruning_method);
-
-
-			Rprintf("\tWindows: ");
+			Rprintf("\tPair counting kernel: %s\n", PairCounter::get_kernel_name());
+			Rprintf("\tWindow: ");
 			if (auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) {
-				Rprintf("\n");
-				for (unsigned int i = 0u; i < dbviews.size(); ++i) {
-					dbview = dbviews.at(i);
-					if (dbview != NULL) {
-						Rprintf("\t- Region: [%u, %u]\n", c_regions_start.at(i), c_regions_end.at(i));
-						Rprintf("\t-- Window: %ld\n", c_windows.at(i));
+				if (c_window == numeric_limits<long int>::min()) {
+					c_window = (long int)(((double)dbview->n_markers * (1.0 - c_ld_fraction)) / 2.0);
+					if (c_window <= 0) {
+						c_window = 1;
 					}
 				}
+				Rprintf("%ld\n", c_window);
 			} else {
-				Rprintf("NA\n", c_window);
+				Rprintf("NA\n");
 			}
+			Rprintf("\tBootstrap replicates: %ld\n", c_replicates);
+			Rprintf("\tBootstrap seed: %.0f\n", c_seed);
 
-
+			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
 			Rprintf("Done (%.3f sec)\n", execution_time);
 
 			Rprintf("Processing data (%d processes)...\n", c_processes);
@@ -876,24 +2705,60 @@ extern "C" {
 			start_time = clock();
 #endif
 
+			/* every replicate is a view of the loaded data with the multiplicities of the resampled haplotypes */
 #ifdef _OPENMP
-#pragma omp parallel for num_threads(c_processes) private(omp_i, algorithm) schedule(dynamic, 1)
+#pragma omp parallel for num_threads(c_processes) private(omp_i, replicate, algorithm, partition) schedule(dynamic, 1)
 #endif
-			for (omp_i = 0; omp_i < (int)algorithms.size(); ++omp_i) {
-				algorithm = algorithms.at(omp_i);
-				if (algorithm != NULL) {
+			for (omp_i = 0; omp_i < (int)c_replicates; ++omp_i) {
+				replicate = NULL;
+				algorithm = NULL;
+				partition = NULL;
+
+				try {
+					replicate = new BootstrapReplicate(dbview, (uint64_t)c_seed, (unsigned int)omp_i);
+
+					algorithm = AlgorithmFactory::create(c_pruning_method, c_window);
+					algorithm->set_dbview(replicate->get_view());
+					algorithm->set_ci_method(c_ci_method);
+					algorithm->set_likelihood_density(c_l_density);
+					algorithm->set_adaptive_likelihood(c_l_adaptive);
+					algorithm->set_ci_cache(ci_cache);
+					algorithm->set_strong_pair_cl(c_ld_ci[0]);
+					algorithm->set_strong_pair_cu(c_ld_ci[1]);
+					algorithm->set_recomb_pair_cu(c_ehr_ci);
+					algorithm->set_strong_pairs_fraction(c_ld_fraction);
+
 					algorithm->compute_preliminary_blocks();
-					algorithm->sort_preliminary_blocks();
+					partition = algorithm->get_block_partition();
+
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+					stability->add(partition);
+				} catch (Exception &e) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+					{
+						if (!replicate_failed) {
+							replicate_failure = e.what();
+						}
+						replicate_failed = true;
+					}
 				}
-			}
 
-			for (unsigned int i = 0; i < algorithms.size(); ++i) {
+				delete partition;
 				partition = NULL;
-				algorithm = algorithms.at(i);
-				if (algorithm != NULL) {
-					partition = algorithm->get_block_partition();
-				}
-				partitions.push_back(partition);
+
+				delete algorithm;
+				algorithm = NULL;
+
+				delete replicate;
+				replicate = NULL;
+			}
+
+			if (replicate_failed) {
+				throw Exception(__FILE__, __LINE__, "%s", replicate_failure.c_str());
 			}
 
 #ifdef	_OPENMP
@@ -902,69 +2767,34 @@ extern "C" {
 			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
 #endif
 
-			for (unsigned int i = 0u; i < dbviews.size(); ++i) {
-				dbview = dbviews.at(i);
-				if (dbview != NULL) {
-					algorithm = algorithms.at(i);
-					partition = partitions.at(i);
-					Rprintf("\t- Region: [%u, %u]\n", c_regions_start.at(i), c_regions_end.at(i));
-					Rprintf("\t-- Preliminary haplotype blocks: %u\n", algorithm->get_n_preliminary_blocks());
-					Rprintf("\t-- Final haplotype blocks: %u\n", partition->get_n_blocks());
-					Rprintf("\t-- Memory used for preliminary haplotype blocks (Mb): %.3g\n", algorithm->get_memory_usage_preliminary_blocks());
-					Rprintf("\t-- Memory used for final haplotype blocks (Mb): %.3g\n", partition->get_memory_usage());
-					Rprintf("\t-- Memory used by algorithm (Mb): %.3g\n", algorithm->get_memory_usage());
-					Rprintf("\t-- Total used memory (Mb): %.3g\n", algorithm->get_memory_usage_preliminary_blocks() + partition->get_memory_usage() + algorithm->get_memory_usage());
-				}
+			Rprintf("\tMean haplotype blocks per replicate: %.3f\n", stability->get_mean_n_blocks());
+			Rprintf("\tMemory used for block boundary frequencies (Mb): %.3g\n", stability->get_memory_usage());
+			if (ci_cache != NULL) {
+				Rprintf("\tD' CI cache hit rate: %.3g (%.0f of %.0f lookups)\n", ci_cache->get_hit_rate(), ci_cache->get_n_hits(), ci_cache->get_n_lookups());
+				Rprintf("\tMemory used by D' CI cache (Mb): %.3g\n", ci_cache->get_memory_usage());
 			}
 			Rprintf("Done (%.3f sec)\n", execution_time);
 
 			Rprintf("Writing results...\n");
 
 			start_time = clock();
-			for (unsigned int i = 0; i < partitions.size(); ++i) {
-				Rprintf("\tOutput file: %s\n", c_output_files.at(i));
-
-				partition = partitions.at(i);
-				if (partition != NULL) {
-					partition->write(c_output_files.at(i));
-				}
-			}
+			Rprintf("\tOutput file: %s\n", c_output_file);
+			stability->write(c_output_file);
 			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
 
 			Rprintf("Done (%.3f sec)\n", execution_time);
 
-			for (unsigned int i = 0u; i < partitions.size(); ++i) {
-				partition = partitions.at(i);
-				if (partition != NULL) {
-					delete partition;
-				}
-			}
-			partitions.clear();
-
-			for (unsigned int i = 0u; i < algorithms.size(); ++i) {
-				algorithm = algorithms.at(i);
-				if (algorithm != NULL) {
-					delete algorithm;
-				}
-			}
-			algorithms.clear();
+			delete stability;
+			stability = NULL;
 
+			delete ci_cache;
+			ci_cache = NULL;
 		} catch (Exception &e) {
-			for (unsigned int i = 0u; i < partitions.size(); ++i) {
-				partition = partitions.at(i);
-				if (partition != NULL) {
-					delete partition;
-				}
-			}
-			partitions.clear();
+			delete stability;
+			stability = NULL;
 
-			for (unsigned int i = 0u; i < algorithms.size(); ++i) {
-				algorithm = algorithms.at(i);
-				if (algorithm != NULL) {
-					delete algorithm;
-				}
-			}
-			algorithms.clear();
+			delete ci_cache;
+			ci_cache = NULL;
 
 			error("%s", e.what());
 		}
@@ -974,7 +2804,8 @@ extern "C" {
 
 	SEXP mig_rsq(SEXP phase_file, SEXP output_file, SEXP phase_file_format, SEXP map_file,
 			SEXP region, SEXP maf, SEXP weak_rsq, SEXP strong_rsq, SEXP fraction,
-			SEXP pruning_method, SEXP window) {
+			SEXP pruning_method, SEXP window, SEXP tight_bounds, SEXP max_span_bp, SEXP max_span_snps, SEXP collapse_columns,
+			SEXP sample_haplotypes, SEXP sample_confidence) {
 
 		const char* c_phase_file = NULL;
 		const char* c_output_file = NULL;
@@ -987,6 +2818,12 @@ extern "C" {
 		double c_fraction = numeric_limits<double>::quiet_NaN();
 		const char* c_pruning_method = NULL;
 		long int c_window = numeric_limits<long int>::min();
+		int c_tight_bounds = 0;
+		long int c_max_span_bp = 0;
+		long int c_max_span_snps = 0;
+		int c_collapse_columns = 0;
+		long int c_sample_haplotypes = 0;
+		double c_sample_confidence = numeric_limits<double>::quiet_NaN();
 
 //		Validate phase_file argument.
 		if (!isNull(phase_file)) {
@@ -1100,12 +2937,67 @@ extern "C" {
 			}
 		}
 
+//		Validate tight_bounds argument.
+		if (!isNull(tight_bounds)) {
+			c_tight_bounds = validateBoolean(tight_bounds, "tight_bounds");
+			if (c_tight_bounds == NA_LOGICAL) {
+				error("'%s' argument contains NA value.", "tight_bounds");
+			}
+		} else {
+			error("'%s' argument is NULL.", "tight_bounds");
+		}
+
+//		Validate max_span_bp argument.
+		if (!isNull(max_span_bp)) {
+			c_max_span_bp = validateInteger(max_span_bp, "max_span_bp");
+			if (c_max_span_bp <= 0) {
+				error("The maximal haplotype block span, specified in '%s' argument, must be strictly greater than 0 base-pairs.", "max_span_bp");
+			}
+		}
+
+//		Validate max_span_snps argument.
+		if (!isNull(max_span_snps)) {
+			c_max_span_snps = validateInteger(max_span_snps, "max_span_snps");
+			if (c_max_span_snps < 2) {
+				error("The maximal haplotype block span, specified in '%s' argument, must be at least 2 SNPs.", "max_span_snps");
+			}
+		}
+
+//		Validate collapse_columns argument.
+		if (!isNull(collapse_columns)) {
+			c_collapse_columns = validateBoolean(collapse_columns, "collapse_columns");
+			if (c_collapse_columns == NA_LOGICAL) {
+				error("'%s' argument contains NA value.", "collapse_columns");
+			}
+		} else {
+			error("'%s' argument is NULL.", "collapse_columns");
+		}
+
+//		Validate sample_haplotypes argument.
+		if (!isNull(sample_haplotypes)) {
+			c_sample_haplotypes = validateInteger(sample_haplotypes, "sample_haplotypes");
+			if (c_sample_haplotypes <= 0) {
+				error("The number of sampled haplotypes, specified in '%s' argument, must be strictly greater than 0.", "sample_haplotypes");
+			}
+		}
+
+//		Validate sample_confidence argument.
+		if (!isNull(sample_confidence)) {
+			c_sample_confidence = validateDouble(sample_confidence, "sample_confidence");
+			if ((c_sample_confidence <= 0.0) || (c_sample_confidence >= 1.0)) {
+				error("The confidence of the sampled SNP pair classes, specified in '%s' argument, must be in (0, 1) interval.", "sample_confidence");
+			}
+		} else {
+			error("'%s' argument is NULL.", "sample_confidence");
+		}
+
 		Algorithm* algorithm = NULL;
 		Partition* partition = NULL;
 
 		try {
 			clock_t start_time = 0;
 			double execution_time = 0.0;
+			unsigned long int n_tight_calculations = 0u;
 
 			Db db;
 			const DbView* dbview = NULL;
@@ -1146,6 +3038,7 @@ extern "C" {
 			Rprintf("\tStrong LD SNP pairs r^2: >= %g\n", c_strong_rsq);
 			Rprintf("\tFraction of strong LD SNP pairs: >= %g\n", c_fraction);
 			Rprintf("\tPruning method: %s\n", c_pruning_method);
+			Rprintf("\tPair counting kernel: %s\n", PairCounter::get_kernel_name());
 			Rprintf("\tWindow: ");
 			if (auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIGPP) == 0) {
 				if (c_window == numeric_limits<long int>::min()) {
@@ -1158,6 +3051,26 @@ extern "C" {
 			} else {
 				Rprintf("NA\n", c_window);
 			}
+			Rprintf("\tTight pruning bounds: %s\n", c_tight_bounds ? "TRUE" : "FALSE");
+			Rprintf("\tMaximum block span (bp): ");
+			if (c_max_span_bp > 0) {
+				Rprintf("%ld\n", c_max_span_bp);
+			} else {
+				Rprintf("NA\n");
+			}
+			Rprintf("\tMaximum block span (SNPs): ");
+			if (c_max_span_snps > 0) {
+				Rprintf("%ld\n", c_max_span_snps);
+			} else {
+				Rprintf("NA\n");
+			}
+			Rprintf("\tCollapse identical SNP columns: %s\n", c_collapse_columns ? "TRUE" : "FALSE");
+			Rprintf("\tSampled haplotypes: ");
+			if ((c_sample_haplotypes > 0) && ((unsigned long int)c_sample_haplotypes < dbview->n_haplotypes)) {
+				Rprintf("%ld (confidence %g)\n", c_sample_haplotypes, c_sample_confidence);
+			} else {
+				Rprintf("NA\n");
+			}
 
 			algorithm = AlgorithmFactory::create(c_pruning_method, c_window);
 
@@ -1165,6 +3078,10 @@ extern "C" {
 			algorithm->set_weak_pair_rsq(c_weak_rsq);
 			algorithm->set_strong_pair_rsq(c_strong_rsq);
 			algorithm->set_strong_pairs_fraction(c_fraction);
+			algorithm->set_tight_bounds(c_tight_bounds);
+			algorithm->set_max_span((unsigned long int)c_max_span_bp, (unsigned int)c_max_span_snps);
+			algorithm->set_collapse_columns(c_collapse_columns);
+			algorithm->set_haplotype_sample((unsigned int)c_sample_haplotypes, c_sample_confidence);
 
 			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
 			Rprintf("Done (%.3f sec)\n", execution_time);
@@ -1173,9 +3090,17 @@ extern "C" {
 			start_time = clock();
 
 			algorithm->compute_preliminary_blocks_rsq();
+			if (c_collapse_columns) {
+				Rprintf("\tSNP column groups: %u\n", algorithm->get_n_column_groups());
+			}
 			Rprintf("\tPreliminary haplotype blocks: %u\n", algorithm->get_n_preliminary_blocks());
+			Rprintf("\tScanned SNP pairs: %lu (%.2f%% pruned)\n", algorithm->get_n_calculations(),
+					100.0 * (1.0 - algorithm->get_n_calculations() / ((dbview->n_markers * (double)(dbview->n_markers - 1u)) / 2.0)));
+			if (algorithm->get_n_sampled_pairs() > 0u) {
+				Rprintf("\tSNP pairs recounted on all haplotypes: %lu of %lu (%.2f%%)\n", algorithm->get_n_exact_pairs(), algorithm->get_n_sampled_pairs(),
+						100.0 * algorithm->get_n_exact_pairs() / (double)algorithm->get_n_sampled_pairs());
+			}
 
-			algorithm->sort_preliminary_blocks();
 			partition = algorithm->get_block_partition();
 
 			execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
@@ -1186,6 +3111,18 @@ extern "C" {
 			Rprintf("\tMemory used for final haplotype blocks (Mb): %.3g\n", partition->get_memory_usage());
 			Rprintf("\tMemory used by algorithm (Mb): %.3g\n", algorithm->get_memory_usage());
 			Rprintf("\tTotal used memory (Mb): %.3g\n", algorithm->get_memory_usage_preliminary_blocks() + partition->get_memory_usage() + algorithm->get_memory_usage());
+
+			/* the pairs scanned under the untightened bound are known only by running without the tight bounds (not timed) */
+			if ((c_tight_bounds) && (auxiliary::strcmp_ignore_case(c_pruning_method, Algorithm::ALGORITHM_MIG) != 0)) {
+				n_tight_calculations = algorithm->get_n_calculations();
+
+				algorithm->set_tight_bounds(false);
+				algorithm->compute_preliminary_blocks_rsq();
+
+				Rprintf("\tScanned SNP pairs without tight bounds: %lu (%.2f%% saved)\n", algorithm->get_n_calculations(),
+						algorithm->get_n_calculations() > 0u ? 100.0 * (1.0 - n_tight_calculations / (double)algorithm->get_n_calculations()) : 0.0);
+			}
+
 			Rprintf("Done (%.3f sec)\n", execution_time);
 
 			Rprintf("Writing results...\n");
@@ -23,32 +23,37 @@ const char* Algorithm::ALGORITHM_MIG = "MIG";
 const char* Algorithm::ALGORITHM_MIGP = "MIG+";
 const char* Algorithm::ALGORITHM_MIGPP = "MIG++";
 
-const unsigned int Algorithm::PRELIMINARY_BLOCKS_SIZE_INIT = 100000;
-const unsigned int Algorithm::PRELIMINARY_BLOCKS_SIZE_INCREMENT = 10000;
-
 const double Algorithm::EPSILON = 0.000000001;
+const int64_t Algorithm::MAX_WEIGHT_DENOMINATOR = 1000000;
+const uint64_t Algorithm::DEFAULT_SAMPLE_SEED = 20130101u;
 
 Algorithm::Algorithm() throw (Exception) :
-		db(NULL), ci_method(NULL),
+		db(NULL), ci_method(NULL), adaptive_likelihood(false), ci_cache(NULL), class_cache(NULL), n_threads(1u),
 		pos_strong_pair_cl(0.7), neg_strong_pair_cl(-0.7),
 		pos_strong_pair_cu(0.98), neg_strong_pair_cu(-0.98),
 		pos_recomb_pair_cu(0.9), neg_recomb_pair_cu(0.9),
 		strong_pair_rsq(0.8),
 		strong_pairs_fraction(0.95), strong_pair_weight(0.05), recomb_pair_weight(0.95),
-		preliminary_blocks(NULL), n_preliminary_blocks(0u), preliminary_blocks_size(PRELIMINARY_BLOCKS_SIZE_INIT),
-		rsq_preliminary_blocks(false) {
+		integer_weights(false), weight_denominator(20), strong_pair_int_weight(1), recomb_pair_int_weight(19),
+		rsq_preliminary_blocks(false), n_calculations(0u), tight_bounds(false), strong_pair_bound(NULL),
+		max_span_bp(0u), max_span_markers(0u), collapse_columns(false), column_groups(NULL),
+		sample_size(0u), sample_confidence(0.999), sample_seed(DEFAULT_SAMPLE_SEED), haplotype_sample(NULL), n_sampled_pairs(0u), n_exact_pairs(0u) {
 
-	preliminary_blocks = (preliminary_block*)malloc(preliminary_blocks_size * sizeof(preliminary_block));
-	if (preliminary_blocks == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
 }
 
 Algorithm::~Algorithm() {
 	db = NULL;
+	ci_cache = NULL;
+	class_cache = NULL;
+
+	delete strong_pair_bound;
+	strong_pair_bound = NULL;
 
-	free(preliminary_blocks);
-	preliminary_blocks = NULL;
+	delete column_groups;
+	column_groups = NULL;
+
+	delete haplotype_sample;
+	haplotype_sample = NULL;
 }
 
 void Algorithm::set_dbview(const DbView* db) {
@@ -63,6 +68,22 @@ void Algorithm::set_likelihood_density(unsigned int likelihood_density) {
 	this->likelihood_density = likelihood_density;
 }
 
+void Algorithm::set_adaptive_likelihood(bool adaptive_likelihood) {
+	this->adaptive_likelihood = adaptive_likelihood;
+}
+
+void Algorithm::set_ci_cache(CICache* ci_cache) {
+	this->ci_cache = ci_cache;
+}
+
+void Algorithm::set_class_cache(PairClassCache* class_cache) {
+	this->class_cache = class_cache;
+}
+
+void Algorithm::set_n_threads(unsigned int n_threads) {
+	this->n_threads = n_threads > 0u ? n_threads : 1u;
+}
+
 void Algorithm::set_strong_pair_cl(double ci_lower_bound) {
 	pos_strong_pair_cl = ci_lower_bound;
 	neg_strong_pair_cl = -pos_strong_pair_cl;
@@ -90,19 +111,179 @@ void Algorithm::set_strong_pairs_fraction(double fraction) {
 	strong_pairs_fraction = fraction;
 	strong_pair_weight = 1.0 - strong_pairs_fraction;
 	recomb_pair_weight = strong_pairs_fraction;
+
+	set_int_weights();
 }
 
-void Algorithm::sort_preliminary_blocks() {
-	qsort(preliminary_blocks, n_preliminary_blocks, sizeof(preliminary_block), preliminary_blocks_cmp);
+void Algorithm::set_integer_weights(bool integer_weights) {
+	this->integer_weights = integer_weights;
 }
 
-Partition* Algorithm::get_block_partition() throw (Exception) {
-	Partition* partition = NULL;
+void Algorithm::set_int_weights() {
+	long double x = strong_pairs_fraction;
+	long double a = 0.0;
+
+	int64_t p = 1, q = 0;
+	int64_t previous_p = 0, previous_q = 1;
+	int64_t next_p = 0, next_q = 0;
+
+	weight_denominator = 0;
+	strong_pair_int_weight = 0;
+	recomb_pair_int_weight = 0;
+
+	/* continued fraction convergents of strong_pairs_fraction */
+	while (x < MAX_WEIGHT_DENOMINATOR) {
+		a = floorl(x);
 
-	bool* used_markers = NULL;
+		next_p = (int64_t)a * p + previous_p;
+		next_q = (int64_t)a * q + previous_q;
+		if (next_q > MAX_WEIGHT_DENOMINATOR) {
+			break;
+		}
+
+		previous_p = p;
+		previous_q = q;
+		p = next_p;
+		q = next_q;
+
+		if (auxiliary::fcmp(p / (double)q, strong_pairs_fraction, EPSILON) == 0) {
+			weight_denominator = q;
+			strong_pair_int_weight = q - p;
+			recomb_pair_int_weight = p;
+			break;
+		}
 
-	unsigned int start = 0u;
-	unsigned int end = 0u;
+		x = 1.0 / (x - a);
+	}
+}
+
+void Algorithm::set_tight_bounds(bool tight_bounds) {
+	this->tight_bounds = tight_bounds;
+}
+
+void Algorithm::set_max_span(unsigned long int max_span_bp, unsigned int max_span_markers) {
+	this->max_span_bp = max_span_bp;
+	this->max_span_markers = max_span_markers;
+}
+
+void Algorithm::set_collapse_columns(bool collapse_columns) {
+	this->collapse_columns = collapse_columns;
+}
+
+void Algorithm::set_haplotype_sample(unsigned int sample_size, double sample_confidence, uint64_t sample_seed) {
+	this->sample_size = sample_size;
+	this->sample_confidence = sample_confidence;
+	this->sample_seed = sample_seed;
+}
+
+bool Algorithm::has_max_span() {
+	return (max_span_bp > 0u) || (max_span_markers > 0u);
+}
+
+long int Algorithm::get_span_start(unsigned int marker_i) {
+	unsigned int first = 0u, last = marker_i;
+	unsigned int middle = 0u;
+
+	if ((max_span_markers > 0u) && (marker_i >= max_span_markers)) {
+		first = marker_i - max_span_markers + 1u;
+	}
+
+	if (max_span_bp > 0u) {
+		while (first < last) {
+			middle = first + (last - first) / 2u;
+			if (db->positions[marker_i] - db->positions[middle] > max_span_bp) {
+				first = middle + 1u;
+			} else {
+				last = middle;
+			}
+		}
+	}
+
+	return first;
+}
+
+long int Algorithm::get_span_end(unsigned int marker_j) {
+	unsigned int first = marker_j, last = db->n_markers - 1u;
+	unsigned int middle = 0u;
+
+	if ((max_span_markers > 0u) && (db->n_markers - marker_j > max_span_markers)) {
+		last = marker_j + max_span_markers - 1u;
+	}
+
+	if (max_span_bp > 0u) {
+		while (first < last) {
+			middle = last - (last - first) / 2u;
+			if (db->positions[middle] - db->positions[marker_j] > max_span_bp) {
+				last = middle - 1u;
+			} else {
+				first = middle;
+			}
+		}
+	}
+
+	return last;
+}
+
+bool Algorithm::is_int_weighted() {
+	/* |w| stays below 8 * n^2 * q in all MIG variants */
+	return integer_weights && (weight_denominator > 0) &&
+			(8.0 * weight_denominator * db->n_markers * (double)db->n_markers < (double)numeric_limits<int64_t>::max());
+}
+
+bool Algorithm::is_strong_fraction(unsigned long int n_strong_pairs, unsigned long int n_recomb_pairs) {
+	if (integer_weights && (weight_denominator > 0) &&
+			(weight_denominator * ((double)n_strong_pairs + n_recomb_pairs) < (double)numeric_limits<int64_t>::max())) {
+		return is_nonnegative(strong_pair_int_weight * (int64_t)n_strong_pairs - recomb_pair_int_weight * (int64_t)n_recomb_pairs);
+	}
+
+	return is_nonnegative((long double)strong_pair_weight * n_strong_pairs - (long double)recomb_pair_weight * n_recomb_pairs);
+}
+
+size_t Algorithm::get_weight_size() {
+	return is_int_weighted() ? sizeof(int64_t) : sizeof(long double);
+}
+
+void Algorithm::set_up_ci(CI* ci) {
+	ci->set_dbview(column_groups != NULL ? column_groups->get_view() : db);
+	ci->set_cache(ci_cache);
+	ci->set_class_cache(class_cache);
+	ci->set_pair_thresholds(pos_strong_pair_cl, pos_strong_pair_cu, pos_recomb_pair_cu);
+}
+
+void Algorithm::set_up_strong_pair_bound() throw (Exception) {
+	delete strong_pair_bound;
+	strong_pair_bound = NULL;
+
+	/* the D' CI of a pair is not capped by the allele frequencies, so the bound helps only with r^2 pair classes */
+	if (tight_bounds && rsq_preliminary_blocks) {
+		strong_pair_bound = new StrongPairBound(db, strong_pair_rsq);
+	}
+}
+
+void Algorithm::set_up_column_groups() throw (Exception) {
+	delete column_groups;
+	column_groups = NULL;
+
+	if (collapse_columns) {
+		column_groups = new ColumnGroups(db);
+	}
+}
+
+void Algorithm::set_up_haplotype_sample() throw (Exception) {
+	delete haplotype_sample;
+	haplotype_sample = NULL;
+
+	n_sampled_pairs = 0u;
+	n_exact_pairs = 0u;
+
+	/* the sample is taken from the view that is classified */
+	if ((sample_size > 0u) && (sample_size < db->n_haplotypes)) {
+		haplotype_sample = new HaplotypeSample(column_groups != NULL ? column_groups->get_view() : db, sample_size, sample_seed);
+	}
+}
+
+Partition* Algorithm::get_block_partition() throw (Exception) {
+	Partition* partition = NULL;
 
 	partition = new Partition(db);
 
@@ -115,58 +296,45 @@ Partition* Algorithm::get_block_partition() throw (Exception) {
 	partition->weak_pair_rsq = weak_pair_rsq;
 	partition->strong_pair_rsq = strong_pair_rsq;
 	partition->strong_pairs_fraction = strong_pairs_fraction;
+	partition->max_span_bp = max_span_bp;
+	partition->max_span_markers = max_span_markers;
 
-	used_markers = (bool*)malloc(db->n_markers * sizeof(bool));
-	if (used_markers == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+	try {
+		preliminary_blocks.select(db, partition);
+	} catch (Exception &e) {
+		delete partition;
+		partition = NULL;
 
-	for (unsigned int i = 0u; i < db->n_markers; ++i) {
-		used_markers[i] = false;
+		throw;
 	}
 
-	for (unsigned int b = 0u; b < n_preliminary_blocks; ++b) {
-		start = preliminary_blocks[b].start;
-		end = preliminary_blocks[b].end;
-
-		if (used_markers[start] || used_markers[end]) {
-			continue;
-		}
+	return partition;
+}
 
-		partition->add_block(start, end);
+unsigned int Algorithm::get_n_preliminary_blocks() {
+	return preliminary_blocks.get_n_blocks();
+}
 
-		for (unsigned int i = start; i <= end; ++i) {
-			used_markers[i] = true;
-		}
-	}
+unsigned long int Algorithm::get_n_calculations() {
+	return n_calculations;
+}
 
-	free(used_markers);
-	used_markers = NULL;
+unsigned int Algorithm::get_n_column_groups() {
+	return column_groups != NULL ? column_groups->get_n_groups() : db->n_markers;
+}
 
-	return partition;
+unsigned long int Algorithm::get_n_sampled_pairs() {
+	return n_sampled_pairs;
 }
 
-unsigned int Algorithm::get_n_preliminary_blocks() {
-	return n_preliminary_blocks;
+unsigned long int Algorithm::get_n_exact_pairs() {
+	return n_exact_pairs;
 }
 
 double Algorithm::get_memory_usage_preliminary_blocks() {
-	return ((preliminary_blocks_size * sizeof(preliminary_block)) / 1048576.0);
+	return preliminary_blocks.get_memory_usage();
 }
 
 double Algorithm::get_memory_usage() {
 	return 0.0;
 }
-
-int Algorithm::preliminary_blocks_cmp(const void* first, const void* second) {
-	preliminary_block* first_block = (preliminary_block*)first;
-	preliminary_block* second_block = (preliminary_block*)second;
-
-	if (first_block->length_bp > second_block->length_bp) {
-		return -1;
-	} else if (first_block->length_bp < second_block->length_bp) {
-		return 1;
-	} else {
-		return first_block->start - second_block->start;
-	}
-}
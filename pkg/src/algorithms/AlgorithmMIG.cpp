@@ -27,156 +27,65 @@ AlgorithmMIG::~AlgorithmMIG() {
 
 }
 
-void AlgorithmMIG::compute_preliminary_blocks() throw (Exception) {
-	CI* ci = NULL;
-
-	long double* w_values = NULL;
-	long double w_values_sum = 0.0;
+template <class Classifier, class Weight> void AlgorithmMIG::compute_preliminary_blocks(Classifier* classifier, Weight strong_weight, Weight recomb_weight) throw (Exception) {
+	Weight* w_values = NULL;
 
-	double lower_ci = 0.0;
-	double upper_ci = 0.0;
+	unsigned int* pair_classes = NULL;
 
-	preliminary_block* new_strong_pairs = NULL;
+	long int first = 0;
 
-	n_preliminary_blocks = 0u;
-	rsq_preliminary_blocks = false;
+	preliminary_blocks.reset(db->n_markers);
 
-	ci = CIFactory::create(ci_method, likelihood_density);
-	ci->set_dbview(db);
+	n_calculations = 0u;
 
-	w_values = (long double*)malloc(db->n_markers * sizeof(long double));
-	if (w_values == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+	try {
+		w_values = (Weight*)malloc(db->n_markers * sizeof(Weight));
+		pair_classes = (unsigned int*)malloc(db->n_markers * sizeof(unsigned int));
+		if ((w_values == NULL) || (pair_classes == NULL)) {
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+		}
 
-	for (unsigned int i = 0u; i < db->n_markers; ++i) {
-		w_values[i] = 0.0;
-	}
+		for (unsigned int i = 0u; i < db->n_markers; ++i) {
+			w_values[i] = 0;
+		}
 
-	for (unsigned int i = 1u; i < db->n_markers; ++i) {
-		w_values_sum = 0.0;
-		for (long int j = i - 1u; j >= 0; --j) {
-			ci->get_CI(i, j, &lower_ci, &upper_ci);
-			if (!isnan(lower_ci) && !isnan(upper_ci)) {
-				if (((auxiliary::fcmp(lower_ci, pos_strong_pair_cl, EPSILON) >= 0) && (auxiliary::fcmp(upper_ci, pos_strong_pair_cu, EPSILON) >= 0)) ||
-						((auxiliary::fcmp(lower_ci, neg_strong_pair_cu, EPSILON) <= 0) && (auxiliary::fcmp(upper_ci, neg_strong_pair_cl, EPSILON) <= 0))) {
-					w_values_sum += strong_pair_weight;
-					w_values[j] += w_values_sum;
-					if (auxiliary::fcmp(w_values[j], 0.0, EPSILON) >= 0) {
-						if (n_preliminary_blocks >= preliminary_blocks_size) {
-							preliminary_blocks_size += PRELIMINARY_BLOCKS_SIZE_INCREMENT;
-							new_strong_pairs = (preliminary_block*)realloc(preliminary_blocks, preliminary_blocks_size * sizeof(preliminary_block));
-							if (new_strong_pairs == NULL) {
-								delete ci;
-								ci = NULL;
-
-								free(w_values);
-								w_values = NULL;
-
-								throw Exception(__FILE__, __LINE__, "Error in memory reallocation.");
-							}
-							preliminary_blocks = new_strong_pairs;
-							new_strong_pairs = NULL;
-						}
-
-						preliminary_blocks[n_preliminary_blocks].start = j;
-						preliminary_blocks[n_preliminary_blocks].end = i;
-						preliminary_blocks[n_preliminary_blocks].length_bp = db->positions[i] - db->positions[j];
-
-						++n_preliminary_blocks;
-					}
-				} else if ((auxiliary::fcmp(lower_ci, neg_recomb_pair_cu, EPSILON) >= 0) && (auxiliary::fcmp(upper_ci, pos_recomb_pair_cu, EPSILON) <= 0)) {
-					w_values_sum -= recomb_pair_weight;
-					w_values[j] += w_values_sum;
-				} else {
-					w_values[j] += w_values_sum;
+		for (unsigned int i = 1u; i < db->n_markers; ++i) {
+			/* pairs beyond the maximum span belong to no block */
+			first = has_max_span() ? get_span_start(i) : 0;
+			n_calculations += i - first;
+
+			/* classify the row, then add the weights of the pairs to the right of every j in one pass */
+			classifier->classify_range(i, first, i - first, pair_classes);
+			WeightScan::add_suffix_sums(pair_classes, i - first, strong_weight, recomb_weight, (Weight)0, w_values + first);
+			for (long int j = i - 1u; j >= first; --j) {
+				if ((pair_classes[j - first] == CI::PAIR_STRONG_LD) && (is_nonnegative(w_values[j]))) {
+					preliminary_blocks.add(j, i);
 				}
-			} else {
-				w_values[j] += w_values_sum;
 			}
 		}
-	}
-
-	delete ci;
-	ci = NULL;
-
-	free(w_values);
-	w_values = NULL;
-}
-
-void AlgorithmMIG::compute_preliminary_blocks_rsq() throw (Exception) {
-	CI* ci = NULL;
-
-	long double* w_values = NULL;
-	long double w_values_sum = 0.0;
-
-	double rsq = 0.0;
-
-	preliminary_block* new_strong_pairs = NULL;
-
-	n_preliminary_blocks = 0u;
-	rsq_preliminary_blocks = true;
+	} catch (Exception &e) {
+		free(w_values);
+		w_values = NULL;
 
-	ci = CIFactory::create(CI::NONE, likelihood_density);
-	ci->set_dbview(db);
+		free(pair_classes);
+		pair_classes = NULL;
 
-	w_values = (long double*)malloc(db->n_markers * sizeof(long double));
-	if (w_values == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+		throw;
 	}
 
-	for (unsigned int i = 0u; i < db->n_markers; ++i) {
-		w_values[i] = 0.0;
-	}
+	free(w_values);
+	w_values = NULL;
 
-	for (unsigned int i = 1u; i < db->n_markers; ++i) {
-		w_values_sum = 0.0;
-		for (long int j = i - 1u; j >= 0; --j) {
-			rsq = ci->get_rsq(i, j);
-			if (!isnan(rsq)) {
-				if (auxiliary::fcmp(rsq, strong_pair_rsq, EPSILON) >= 0) {
-					w_values_sum += strong_pair_weight;
-					w_values[j] += w_values_sum;
-					if (auxiliary::fcmp(w_values[j], 0.0, EPSILON) >= 0) {
-						if (n_preliminary_blocks >= preliminary_blocks_size) {
-							preliminary_blocks_size += PRELIMINARY_BLOCKS_SIZE_INCREMENT;
-							new_strong_pairs = (preliminary_block*)realloc(preliminary_blocks, preliminary_blocks_size * sizeof(preliminary_block));
-							if (new_strong_pairs == NULL) {
-								delete ci;
-								ci = NULL;
-
-								free(w_values);
-								w_values = NULL;
-
-								throw Exception(__FILE__, __LINE__, "Error in memory reallocation.");
-							}
-							preliminary_blocks = new_strong_pairs;
-							new_strong_pairs = NULL;
-						}
-
-						preliminary_blocks[n_preliminary_blocks].start = j;
-						preliminary_blocks[n_preliminary_blocks].end = i;
-						preliminary_blocks[n_preliminary_blocks].length_bp = db->positions[i] - db->positions[j];
-
-						++n_preliminary_blocks;
-					}
-				} else if (auxiliary::fcmp(rsq, weak_pair_rsq, EPSILON) < 0) {
-					w_values_sum -= recomb_pair_weight;
-					w_values[j] += w_values_sum;
-				} else {
-					w_values[j] += w_values_sum;
-				}
-			} else {
-				w_values[j] += w_values_sum;
-			}
-		}
-	}
+	free(pair_classes);
+	pair_classes = NULL;
+}
 
-	delete ci;
-	ci = NULL;
+void AlgorithmMIG::compute_preliminary_blocks() throw (Exception) {
+	run_ci(this);
+}
 
-	free(w_values);
-	w_values = NULL;
+void AlgorithmMIG::compute_preliminary_blocks_rsq() throw (Exception) {
+	run_rsq(this);
 }
 
 Partition* AlgorithmMIG::get_block_partition() throw (Exception) {
@@ -190,5 +99,15 @@ Partition* AlgorithmMIG::get_block_partition() throw (Exception) {
 
 
 double AlgorithmMIG::get_memory_usage() {
-	return ((db->n_markers * sizeof(long double)) / 1048576.0);
+	double memory_usage = (db->n_markers * (get_weight_size() + sizeof(unsigned int))) / 1048576.0;
+
+	if (column_groups != NULL) {
+		memory_usage += column_groups->get_memory_usage();
+	}
+
+	if (haplotype_sample != NULL) {
+		memory_usage += haplotype_sample->get_memory_usage();
+	}
+
+	return memory_usage;
 }
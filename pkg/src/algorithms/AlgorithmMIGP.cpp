@@ -27,180 +27,108 @@ AlgorithmMIGP::~AlgorithmMIGP() {
 
 }
 
-void AlgorithmMIGP::compute_preliminary_blocks() throw (Exception) {
-	CI* ci = NULL;
-
-	long double* w_values = NULL;
-	long double w_values_sum = 0.0;
+template <class Classifier, class Weight> void AlgorithmMIGP::compute_preliminary_blocks(Classifier* classifier, Weight strong_weight, Weight recomb_weight) throw (Exception) {
+	Weight* w_values = NULL;
 
-	long double w_value_max = 0.0;
+	Weight w_value_max = 0;
 
-	double lower_ci = 0.0;
-	double upper_ci = 0.0;
+	unsigned int* pair_classes = NULL;
 
 	long int breakpoint = 0;
 	long int updated_breakpoint = 0;
 
-	preliminary_block* new_strong_pairs = NULL;
+	long int last = 0;
+	unsigned long int n_pairs = 0u;
 
-	n_preliminary_blocks = 0u;
-	rsq_preliminary_blocks = false;
+	preliminary_blocks.reset(db->n_markers);
 
-	ci = CIFactory::create(ci_method, likelihood_density);
-	ci->set_dbview(db);
-
-	w_values = (long double*)malloc(db->n_markers * sizeof(long double));
-	if (w_values == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+	n_calculations = 0u;
 
-	for (unsigned int i = 0u; i < db->n_markers; ++i) {
-		w_values[i] = 0.0;
+	set_up_strong_pair_bound();
+	if (strong_pair_bound != NULL) {
+		strong_pair_bound->reset_rows();
 	}
 
-	for (unsigned int i = 1u; i < db->n_markers; ++i) {
-		w_values_sum = 0.0;
-		breakpoint = updated_breakpoint;
-		updated_breakpoint = i;
-		for (long int j = i - 1u; j >= breakpoint; --j) {
-			ci->get_CI(i, j, &lower_ci, &upper_ci);
-			if (!isnan(lower_ci) && !isnan(upper_ci)) {
-				if (((auxiliary::fcmp(lower_ci, pos_strong_pair_cl, EPSILON) >= 0) && (auxiliary::fcmp(upper_ci, pos_strong_pair_cu, EPSILON) >= 0)) ||
-						((auxiliary::fcmp(lower_ci, neg_strong_pair_cu, EPSILON) <= 0) && (auxiliary::fcmp(upper_ci, neg_strong_pair_cl, EPSILON) <= 0))) {
-					w_values_sum += strong_pair_weight;
-					w_values[j] += w_values_sum;
-					if (auxiliary::fcmp(w_values[j], 0.0, EPSILON) >= 0) {
-						if (n_preliminary_blocks >= preliminary_blocks_size) {
-							preliminary_blocks_size += PRELIMINARY_BLOCKS_SIZE_INCREMENT;
-							new_strong_pairs = (preliminary_block*)realloc(preliminary_blocks, preliminary_blocks_size * sizeof(preliminary_block));
-							if (new_strong_pairs == NULL) {
-								delete ci;
-								ci = NULL;
-
-								free(w_values);
-								w_values = NULL;
-
-								throw Exception(__FILE__, __LINE__, "Error in memory reallocation.");
-							}
-							preliminary_blocks = new_strong_pairs;
-							new_strong_pairs = NULL;
-						}
-
-						preliminary_blocks[n_preliminary_blocks].start = j;
-						preliminary_blocks[n_preliminary_blocks].end = i;
-						preliminary_blocks[n_preliminary_blocks].length_bp = db->positions[i] - db->positions[j];
-
-						++n_preliminary_blocks;
-					}
-				} else if ((auxiliary::fcmp(lower_ci, neg_recomb_pair_cu, EPSILON) >= 0) && (auxiliary::fcmp(upper_ci, pos_recomb_pair_cu, EPSILON) <= 0)) {
-					w_values_sum -= recomb_pair_weight;
-					w_values[j] += w_values_sum;
-				} else {
-					w_values[j] += w_values_sum;
-				}
-			} else {
-				w_values[j] += w_values_sum;
-			}
-
-			w_value_max = w_values[j] + 0.5 * strong_pair_weight * ((db->n_markers - i - 1u) * (db->n_markers + i - j - j));
-			if (auxiliary::fcmp(w_value_max, 0.0, EPSILON) >= 0) {
-				updated_breakpoint = j;
-			}
+	try {
+		w_values = (Weight*)malloc(db->n_markers * sizeof(Weight));
+		pair_classes = (unsigned int*)malloc(db->n_markers * sizeof(unsigned int));
+		if ((w_values == NULL) || (pair_classes == NULL)) {
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
 		}
-	}
-
-	delete ci;
-	ci = NULL;
-
-	free(w_values);
-	w_values = NULL;
-}
-
-void AlgorithmMIGP::compute_preliminary_blocks_rsq() throw (Exception) {
-	CI* ci = NULL;
 
-	long double* w_values = NULL;
-	long double w_values_sum = 0.0;
-
-	long double w_value_max = 0.0;
-
-	double rsq = 0.0;
+		for (unsigned int i = 0u; i < db->n_markers; ++i) {
+			w_values[i] = 0;
+		}
 
-	long int breakpoint = 0;
-	long int updated_breakpoint = 0;
+		for (unsigned int i = 1u; i < db->n_markers; ++i) {
+			breakpoint = updated_breakpoint;
+			updated_breakpoint = i;
+			if (has_max_span() && (breakpoint < get_span_start(i))) {
+				breakpoint = get_span_start(i);
+			}
+			n_calculations += i - breakpoint;
+			if (strong_pair_bound != NULL) {
+				strong_pair_bound->remove_row(i);
+			}
 
-	preliminary_block* new_strong_pairs = NULL;
+			/* classify the row segment, then add the weights of the pairs to the right of every j in one pass */
+			classifier->classify_range(i, breakpoint, i - breakpoint, pair_classes);
+			WeightScan::add_suffix_sums(pair_classes, i - breakpoint, strong_weight, recomb_weight, (Weight)0, w_values + breakpoint);
 
-	n_preliminary_blocks = 0u;
-	rsq_preliminary_blocks = true;
+			for (long int j = i - 1u; j >= breakpoint; --j) {
+				if ((pair_classes[j - breakpoint] == CI::PAIR_STRONG_LD) && (is_nonnegative(w_values[j]))) {
+					preliminary_blocks.add(j, i);
+				}
+			}
 
-	ci = CIFactory::create(CI::NONE, likelihood_density);
-	ci->set_dbview(db);
+			/* the next row starts from the leftmost j that may still begin a block */
+			for (long int j = breakpoint; j < (long int)i; ++j) {
+				/* a block starting at j ends at the last marker within the maximum span */
+				last = db->n_markers - 1u;
+				if (has_max_span()) {
+					last = get_span_end(j);
+					if (last <= (long int)i) {
+						continue;
+					}
+				}
 
-	w_values = (long double*)malloc(db->n_markers * sizeof(long double));
-	if (w_values == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+				/* (last - i) and (last + i + 1 - 2j) differ in parity, so the halved product is exact */
+				n_pairs = ((unsigned long int)(last - i) * (unsigned long int)(last + i + 1 - j - j)) / 2u;
+				if ((strong_pair_bound != NULL) && (strong_pair_bound->get_max_strong_pairs(j) < n_pairs)) {
+					n_pairs = strong_pair_bound->get_max_strong_pairs(j);
+				}
 
-	for (unsigned int i = 0u; i < db->n_markers; ++i) {
-		w_values[i] = 0.0;
-	}
+				w_value_max = w_values[j] + strong_weight * (Weight)n_pairs;
 
-	for (unsigned int i = 1u; i < db->n_markers; ++i) {
-		w_values_sum = 0.0;
-		breakpoint = updated_breakpoint;
-		updated_breakpoint = i;
-		for (long int j = i - 1u; j >= breakpoint; --j) {
-			rsq = ci->get_rsq(i, j);
-			if (!isnan(rsq)) {
-				if (auxiliary::fcmp(rsq, strong_pair_rsq, EPSILON) >= 0) {
-					w_values_sum += strong_pair_weight;
-					w_values[j] += w_values_sum;
-					if (auxiliary::fcmp(w_values[j], 0.0, EPSILON) >= 0) {
-						if (n_preliminary_blocks >= preliminary_blocks_size) {
-							preliminary_blocks_size += PRELIMINARY_BLOCKS_SIZE_INCREMENT;
-							new_strong_pairs = (preliminary_block*)realloc(preliminary_blocks, preliminary_blocks_size * sizeof(preliminary_block));
-							if (new_strong_pairs == NULL) {
-								delete ci;
-								ci = NULL;
-
-								free(w_values);
-								w_values = NULL;
-
-								throw Exception(__FILE__, __LINE__, "Error in memory reallocation.");
-							}
-							preliminary_blocks = new_strong_pairs;
-							new_strong_pairs = NULL;
-						}
-
-						preliminary_blocks[n_preliminary_blocks].start = j;
-						preliminary_blocks[n_preliminary_blocks].end = i;
-						preliminary_blocks[n_preliminary_blocks].length_bp = db->positions[i] - db->positions[j];
-
-						++n_preliminary_blocks;
-					}
-				} else if (auxiliary::fcmp(rsq, weak_pair_rsq, EPSILON) < 0) {
-					w_values_sum -= recomb_pair_weight;
-					w_values[j] += w_values_sum;
-				} else {
-					w_values[j] += w_values_sum;
+				if (is_nonnegative(w_value_max)) {
+					updated_breakpoint = j;
+					break;
 				}
-			} else {
-				w_values[j] += w_values_sum;
-			}
-
-			w_value_max = w_values[j] + 0.5 * strong_pair_weight * ((db->n_markers - i - 1u) * (db->n_markers + i - j - j));
-			if (auxiliary::fcmp(w_value_max, 0.0, EPSILON) >= 0) {
-				updated_breakpoint = j;
 			}
 		}
-	}
+	} catch (Exception &e) {
+		free(w_values);
+		w_values = NULL;
+
+		free(pair_classes);
+		pair_classes = NULL;
 
-	delete ci;
-	ci = NULL;
+		throw;
+	}
 
 	free(w_values);
 	w_values = NULL;
+
+	free(pair_classes);
+	pair_classes = NULL;
+}
+
+void AlgorithmMIGP::compute_preliminary_blocks() throw (Exception) {
+	run_ci(this);
+}
+
+void AlgorithmMIGP::compute_preliminary_blocks_rsq() throw (Exception) {
+	run_rsq(this);
 }
 
 Partition* AlgorithmMIGP::get_block_partition() throw (Exception) {
@@ -213,5 +141,19 @@ Partition* AlgorithmMIGP::get_block_partition() throw (Exception) {
 }
 
 double AlgorithmMIGP::get_memory_usage() {
-	return ((db->n_markers * sizeof(long double)) / 1048576.0);
+	double memory_usage = (db->n_markers * (get_weight_size() + sizeof(unsigned int))) / 1048576.0;
+
+	if (strong_pair_bound != NULL) {
+		memory_usage += strong_pair_bound->get_memory_usage();
+	}
+
+	if (column_groups != NULL) {
+		memory_usage += column_groups->get_memory_usage();
+	}
+
+	if (haplotype_sample != NULL) {
+		memory_usage += haplotype_sample->get_memory_usage();
+	}
+
+	return memory_usage;
 }
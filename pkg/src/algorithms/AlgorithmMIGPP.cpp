@@ -19,7 +19,12 @@
 
 #include "include/AlgorithmMIGPP.h"
 
-AlgorithmMIGPP::AlgorithmMIGPP(unsigned int window) : Algorithm(), window(window) {
+const char* AlgorithmMIGPP::WINDOW_AUTO = "AUTO";
+const unsigned int AlgorithmMIGPP::AUTO_WINDOW_SAMPLE_SIZE = 2000u;
+const unsigned int AlgorithmMIGPP::AUTO_WINDOW_CACHE_BAND = 256u;
+
+AlgorithmMIGPP::AlgorithmMIGPP(unsigned int window) : Algorithm(), window(window), n_passes(0u), auto_window(false),
+		deadline(0.0), provisional(false), reached_window(0u) {
 
 }
 
@@ -27,23 +32,20 @@ AlgorithmMIGPP::~AlgorithmMIGPP() {
 
 }
 
-void AlgorithmMIGPP::compute_preliminary_blocks() throw (Exception) {
-	CI* ci = NULL;
-
-	long double* w_values = NULL;
-	long double* w_values_sums = NULL;
+template <class Classifier, class Weight> void AlgorithmMIGPP::compute_preliminary_blocks(Classifier* classifier, Weight strong_weight, Weight recomb_weight) throw (Exception) {
+	Weight* w_values = NULL;
+	Weight* w_values_sums = NULL;
 
-	long double w_values_sum_left = 0.0;
-	long double* w_values_sums_left = NULL;
+	Weight w_values_sum_left = 0;
+	Weight* w_values_sums_left = NULL;
 
-	long double w_value_max = 0.0;
-	long double* w_values_max = NULL;
+	Weight w_value_max = 0;
+	Weight* w_values_max = NULL;
 
 	long int* breakpoints = NULL;
 	long int* terminations = NULL;
 
-	double lower_ci = 0.0;
-	double upper_ci = 0.0;
+	unsigned int* pair_classes = NULL;
 
 	unsigned int current_window = 0u;
 
@@ -52,169 +54,147 @@ void AlgorithmMIGPP::compute_preliminary_blocks() throw (Exception) {
 
 	unsigned long int calculations = numeric_limits<unsigned long int>::max();;
 
-	preliminary_block* new_strong_pairs = NULL;
-
-	n_preliminary_blocks = 0u;
-	rsq_preliminary_blocks = false;
+	preliminary_blocks.reset(db->n_markers);
 
-	ci = CIFactory::create(ci_method, likelihood_density);
-	ci->set_dbview(db);
+	n_calculations = 0u;
+	n_passes = 0u;
 
-	w_values = (long double*)malloc(db->n_markers * sizeof(long double));
-	if (w_values == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+	provisional = false;
+	reached_window = 0u;
 
-	w_values_sums = (long double*)malloc(db->n_markers * sizeof(long double));
-	if (w_values_sums == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+	set_up_strong_pair_bound();
 
-	w_values_sums_left = (long double*)malloc(db->n_markers * sizeof(long double));
-	if (w_values_sums_left == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+	try {
+		w_values = (Weight*)malloc(db->n_markers * sizeof(Weight));
+		w_values_sums = (Weight*)malloc(db->n_markers * sizeof(Weight));
+		w_values_sums_left = (Weight*)malloc(db->n_markers * sizeof(Weight));
+		w_values_max = (Weight*)malloc(db->n_markers * sizeof(Weight));
+		terminations = (long int*)malloc(db->n_markers * sizeof(long int));
+		breakpoints = (long int*)malloc(db->n_markers * sizeof(long int));
+		pair_classes = (unsigned int*)malloc(db->n_markers * sizeof(unsigned int));
+		if ((w_values == NULL) || (w_values_sums == NULL) || (w_values_sums_left == NULL) || (w_values_max == NULL) ||
+				(terminations == NULL) || (breakpoints == NULL) || (pair_classes == NULL)) {
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+		}
 
-	w_values_max = (long double*)malloc(db->n_markers * sizeof(long double));
-	if (w_values_max == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+		for (unsigned int i = 0u; i < db->n_markers; ++i) {
+			w_values[i] = 0;
+			w_values_sums[i] = 0;
+			terminations[i] = i;
+			breakpoints[i] = i;
+		}
 
-	terminations = (long int*)malloc(db->n_markers * sizeof(long int));
-	if (terminations == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+		for (unsigned int i = 0u; i < db->n_markers; ++i) {
+			w_values_sum_left += strong_weight * get_n_strong_pairs(i, terminations[i]);
+			w_values_sums_left[i] = w_values_sum_left;
+		}
 
-	breakpoints = (long int*)malloc(db->n_markers * sizeof(long int));
-	if (breakpoints == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+		w_values_max[db->n_markers - 1u] = w_values_sums_left[db->n_markers - 1u];
+		for (long int i = db->n_markers - 1u; i >= 2u; --i) {
+			w_values_max[i - 1u] = w_values_max[i] > w_values_sums_left[i] ? w_values_max[i] : w_values_sums_left[i];
+		}
 
-	for (unsigned int i = 0u; i < db->n_markers; ++i) {
-		w_values[i] = 0.0;
-		w_values_sums[i] = 0.0;
-		terminations[i] = i;
-		breakpoints[i] = i;
-	}
+		while (calculations > 0u) {
+			current_window += window;
 
-	for (unsigned int i = 0u; i < db->n_markers; ++i) {
-		w_values_sum_left += strong_pair_weight * terminations[i];
-		w_values_sums_left[i] = w_values_sum_left;
-	}
+			calculations = 0u;
+			++n_passes;
 
-	w_values_max[db->n_markers - 1u] = w_values_sums_left[db->n_markers - 1u];
-	for (long int i = db->n_markers - 1u; i >= 2u; --i) {
-		w_values_max[i - 1u] = w_values_max[i] > w_values_sums_left[i] ? w_values_max[i] : w_values_sums_left[i];
-	}
+			breakpoint = 0;
+			updated_breakpoint = 0;
 
-	while (calculations > 0u) {
-		current_window += window;
+			w_values_sum_left = 0;
 
-		calculations = 0u;
+			for (long int i = 1; i < db->n_markers; ++i) {
+				if (updated_breakpoint == breakpoints[i]) {
+					breakpoints[i] = breakpoint;
+					breakpoint = updated_breakpoint = terminations[i];
 
-		breakpoint = 0;
-		updated_breakpoint = 0;
+					w_values_sum_left += strong_weight * get_n_strong_pairs(i, terminations[i]) + w_values_sums[i];
+					w_values_sums_left[i] = w_values_sum_left;
 
-		w_values_sum_left = 0.0;
+					continue;
+				}
 
-		for (long int i = 1; i < db->n_markers; ++i) {
-			if (updated_breakpoint == breakpoints[i]) {
-				breakpoints[i] = breakpoint;
-				breakpoint = updated_breakpoint = terminations[i];
+				if ((i - updated_breakpoint) > current_window) {
+					breakpoints[i] = breakpoint = i - current_window;
+				} else {
+					breakpoints[i] = breakpoint;
+					breakpoint = updated_breakpoint;
+				}
 
-				w_values_sum_left += strong_pair_weight * terminations[i] + w_values_sums[i];
-				w_values_sums_left[i] = w_values_sum_left;
+				/* pairs beyond the maximum span belong to no block */
+				if (has_max_span() && (breakpoint < get_span_start(i))) {
+					breakpoint = get_span_start(i);
+				}
 
-				continue;
-			}
+				updated_breakpoint = terminations[i];
 
-			if ((i - updated_breakpoint) > current_window) {
-				breakpoints[i] = breakpoint = i - current_window;
-			} else {
-				breakpoints[i] = breakpoint;
-				breakpoint = updated_breakpoint;
-			}
+				/* classify the row segment, then add the weights of the pairs to the right of every j in one pass */
+				if (terminations[i] > breakpoint) {
+					classifier->classify_range(i, breakpoint, terminations[i] - breakpoint, pair_classes);
+					w_values_sums[i] = WeightScan::add_suffix_sums(pair_classes, terminations[i] - breakpoint, strong_weight, recomb_weight, w_values_sums[i], w_values + breakpoint);
+					calculations += terminations[i] - breakpoint;
+				}
 
-			updated_breakpoint = terminations[i];
-
-			for (long int j = terminations[i] - 1u; j >= breakpoint; --j) {
-				++calculations;
-
-				ci->get_CI(i, j, &lower_ci, &upper_ci);
-				if (!isnan(lower_ci) && !isnan(upper_ci)) {
-					if (((auxiliary::fcmp(lower_ci, pos_strong_pair_cl, EPSILON) >= 0) && (auxiliary::fcmp(upper_ci, pos_strong_pair_cu, EPSILON) >= 0)) ||
-							((auxiliary::fcmp(lower_ci, neg_strong_pair_cu, EPSILON) <= 0) && (auxiliary::fcmp(upper_ci, neg_strong_pair_cl, EPSILON) <= 0))) {
-						w_values_sums[i] += strong_pair_weight;
-						w_values[j] += w_values_sums[i];
-						if (auxiliary::fcmp(w_values[j], 0.0, EPSILON) >= 0) {
-							if (n_preliminary_blocks >= preliminary_blocks_size) {
-								preliminary_blocks_size += PRELIMINARY_BLOCKS_SIZE_INCREMENT;
-								new_strong_pairs = (preliminary_block*)realloc(preliminary_blocks, preliminary_blocks_size * sizeof(preliminary_block));
-								if (new_strong_pairs == NULL) {
-									delete ci;
-									ci = NULL;
-
-									free(w_values);
-									w_values = NULL;
-
-									free(w_values_sums);
-									w_values_sums = NULL;
-
-									free(w_values_sums_left);
-									w_values_sums_left = NULL;
-
-									free(w_values_max);
-									w_values_max = NULL;
-
-									free(terminations);
-									terminations = NULL;
-
-									free(breakpoints);
-									breakpoints = NULL;
-
-									throw Exception(__FILE__, __LINE__, "Error in memory reallocation.");
-								}
-								preliminary_blocks = new_strong_pairs;
-								new_strong_pairs = NULL;
-							}
-
-							preliminary_blocks[n_preliminary_blocks].start = j;
-							preliminary_blocks[n_preliminary_blocks].end = i;
-							preliminary_blocks[n_preliminary_blocks].length_bp = db->positions[i] - db->positions[j];
-
-							++n_preliminary_blocks;
-						}
-					} else if ((auxiliary::fcmp(lower_ci, neg_recomb_pair_cu, EPSILON) >= 0) && (auxiliary::fcmp(upper_ci, pos_recomb_pair_cu, EPSILON) <= 0)) {
-						w_values_sums[i] -= recomb_pair_weight;
-						w_values[j] += w_values_sums[i];
-					} else {
-						w_values[j] += w_values_sums[i];
+				for (long int j = terminations[i] - 1u; j >= breakpoint; --j) {
+					if ((pair_classes[j - breakpoint] == CI::PAIR_STRONG_LD) && (is_nonnegative(w_values[j]))) {
+						preliminary_blocks.add(j, i);
 					}
-				} else {
-					w_values[j] += w_values_sums[i];
 				}
 
 				/* With prior using pre-calculated sums, medium conservative. */
-				w_value_max = w_values[j] + w_values_max[i] - w_values_sums_left[i];
-				if (auxiliary::fcmp(w_value_max, 0.0, EPSILON) >= 0) {
-					updated_breakpoint = j;
+				for (long int j = breakpoint; j < terminations[i]; ++j) {
+					w_value_max = w_values[j] + w_values_max[i] - w_values_sums_left[i];
+					if (is_nonnegative(w_value_max)) {
+						updated_breakpoint = j;
+						break;
+					}
 				}
+
+				terminations[i] = breakpoint;
+
+				w_values_sum_left += strong_weight * get_n_strong_pairs(i, terminations[i]) + w_values_sums[i];
+				w_values_sums_left[i] = w_values_sum_left;
 			}
 
-			terminations[i] = breakpoint;
+			w_values_max[db->n_markers - 1u] = w_values_sums_left[db->n_markers - 1u];
+			for (long int k = db->n_markers - 1u; k >= 2u; --k) {
+				w_values_max[k - 1u] = w_values_max[k] > w_values_sums_left[k] ? w_values_max[k] : w_values_sums_left[k];
+			}
 
-			w_values_sum_left += strong_pair_weight * terminations[i] + w_values_sums[i];
-			w_values_sums_left[i] = w_values_sum_left;
-		}
+			n_calculations += calculations;
+			reached_window = current_window;
 
-		w_values_max[db->n_markers - 1u] = w_values_sums_left[db->n_markers - 1u];
-		for (long int k = db->n_markers - 1u; k >= 2u; --k) {
-			w_values_max[k - 1u] = w_values_max[k] > w_values_sums_left[k] ? w_values_max[k] : w_values_sums_left[k];
+			if ((calculations > 0u) && (deadline > 0.0) && (get_wall_time() >= deadline)) {
+				provisional = true;
+				break;
+			}
 		}
-	}
+	} catch (Exception &e) {
+		free(w_values);
+		w_values = NULL;
+
+		free(w_values_sums);
+		w_values_sums = NULL;
+
+		free(w_values_sums_left);
+		w_values_sums_left = NULL;
 
-	delete ci;
-	ci = NULL;
+		free(w_values_max);
+		w_values_max = NULL;
+
+		free(terminations);
+		terminations = NULL;
+
+		free(breakpoints);
+		breakpoints = NULL;
+
+		free(pair_classes);
+		pair_classes = NULL;
+
+		throw;
+	}
 
 	free(w_values);
 	w_values = NULL;
@@ -233,212 +213,123 @@ void AlgorithmMIGPP::compute_preliminary_blocks() throw (Exception) {
 
 	free(breakpoints);
 	breakpoints = NULL;
-}
-
-void AlgorithmMIGPP::compute_preliminary_blocks_rsq() throw (Exception) {
-	CI* ci = NULL;
-
-	long double* w_values = NULL;
-	long double* w_values_sums = NULL;
-
-	long double w_values_sum_left = 0.0;
-	long double* w_values_sums_left = NULL;
-
-	long double w_value_max = 0.0;
-	long double* w_values_max = NULL;
-
-	long int* breakpoints = NULL;
-	long int* terminations = NULL;
-
-	double rsq = 0.0;
-
-	unsigned int current_window = 0u;
-
-	long int breakpoint = 0;
-	long int updated_breakpoint = 0;
-
-	unsigned long int calculations = numeric_limits<unsigned long int>::max();;
-
-	preliminary_block* new_strong_pairs = NULL;
 
-	n_preliminary_blocks = 0u;
-	rsq_preliminary_blocks = true;
-
-	ci = CIFactory::create(CI::NONE, likelihood_density);
-	ci->set_dbview(db);
-
-	w_values = (long double*)malloc(db->n_markers * sizeof(long double));
-	if (w_values == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
-
-	w_values_sums = (long double*)malloc(db->n_markers * sizeof(long double));
-	if (w_values_sums == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
-
-	w_values_sums_left = (long double*)malloc(db->n_markers * sizeof(long double));
-	if (w_values_sums_left == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+	free(pair_classes);
+	pair_classes = NULL;
+}
 
-	w_values_max = (long double*)malloc(db->n_markers * sizeof(long double));
-	if (w_values_max == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+void AlgorithmMIGPP::compute_preliminary_blocks() throw (Exception) {
+	run_ci(this);
+}
 
-	terminations = (long int*)malloc(db->n_markers * sizeof(long int));
-	if (terminations == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+void AlgorithmMIGPP::compute_preliminary_blocks_rsq() throw (Exception) {
+	run_rsq(this);
+}
 
-	breakpoints = (long int*)malloc(db->n_markers * sizeof(long int));
-	if (breakpoints == NULL) {
-		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
-	}
+void AlgorithmMIGPP::tune_window(const DbView* sample) throw (Exception) {
+	const DbView* region_db = db;
+	PairClassCache* region_class_cache = class_cache;
+	double region_deadline = deadline;
+	PairClassCache* sample_class_cache = NULL;
 
-	for (unsigned int i = 0u; i < db->n_markers; ++i) {
-		w_values[i] = 0.0;
-		w_values_sums[i] = 0.0;
-		terminations[i] = i;
-		breakpoints[i] = i;
-	}
+	unsigned int span = 0u;
+	unsigned int band = 0u;
+	unsigned long int cost = 0u;
+	unsigned long int best_cost = numeric_limits<unsigned long int>::max();
+	unsigned int best_window = window;
 
-	for (unsigned int i = 0u; i < db->n_markers; ++i) {
-		w_values_sum_left += strong_pair_weight * terminations[i];
-		w_values_sums_left[i] = w_values_sum_left;
+	if ((sample == NULL) || (sample->n_markers < 2u)) {
+		return;
 	}
 
-	w_values_max[db->n_markers - 1u] = w_values_sums_left[db->n_markers - 1u];
-	for (long int i = db->n_markers - 1u; i >= 2u; --i) {
-		w_values_max[i - 1u] = w_values_max[i] > w_values_sums_left[i] ? w_values_max[i] : w_values_sums_left[i];
-	}
-
-	while (calculations > 0u) {
-		current_window += window;
-
-		calculations = 0u;
-
-		breakpoint = 0;
-		updated_breakpoint = 0;
-
-		w_values_sum_left = 0.0;
+	try {
+		/*
+		 * Every probe classifies mostly the same pairs, so they are classified once for all probes. The rows are Db indices, so under a MAF
+		 * filter the span is many times the number of sampled markers: the band covers AUTO_WINDOW_CACHE_BAND sampled markers at their average
+		 * density, and the rarer pairs further apart are classified again by every probe that reaches them.
+		 */
+		if (class_cache == NULL) {
+			span = sample->indices[sample->n_markers - 1u] - sample->indices[0u];
+			band = span;
+			if (sample->n_markers - 1u > AUTO_WINDOW_CACHE_BAND) {
+				band = (unsigned int)(((unsigned long int)span * AUTO_WINDOW_CACHE_BAND + sample->n_markers - 2u) / (sample->n_markers - 1u));
+			}
+			sample_class_cache = new PairClassCache(sample->indices[0u], span + 1u, band);
+			class_cache = sample_class_cache;
+		}
 
-		for (long int i = 1; i < db->n_markers; ++i) {
-			if (updated_breakpoint == breakpoints[i]) {
-				breakpoints[i] = breakpoint;
-				breakpoint = updated_breakpoint = terminations[i];
+		db = sample;
+		deadline = 0.0;
 
-				w_values_sum_left += strong_pair_weight * terminations[i] + w_values_sums[i];
-				w_values_sums_left[i] = w_values_sum_left;
+		for (unsigned int probe_window = 1u; ; probe_window *= 2u) {
+			window = probe_window;
+			compute_preliminary_blocks();
 
-				continue;
+			cost = n_calculations + (unsigned long int)n_passes * sample->n_markers;
+			if (cost < best_cost) {
+				best_cost = cost;
+				best_window = probe_window;
 			}
 
-			if ((i - updated_breakpoint) > current_window) {
-				breakpoints[i] = breakpoint = i - current_window;
-			} else {
-				breakpoints[i] = breakpoint;
-				breakpoint = updated_breakpoint;
+			if (probe_window >= sample->n_markers) {
+				break;
 			}
+		}
+	} catch (Exception &e) {
+		db = region_db;
+		class_cache = region_class_cache;
+		deadline = region_deadline;
+		window = best_window;
 
-			updated_breakpoint = terminations[i];
-
-			for (long int j = terminations[i] - 1u; j >= breakpoint; --j) {
-				++calculations;
-
-				rsq = ci->get_rsq(i, j);
-				if (!isnan(rsq)) {
-					if (auxiliary::fcmp(rsq, strong_pair_rsq, EPSILON) >= 0) {
-						w_values_sums[i] += strong_pair_weight;
-						w_values[j] += w_values_sums[i];
-						if (auxiliary::fcmp(w_values[j], 0.0, EPSILON) >= 0) {
-							if (n_preliminary_blocks >= preliminary_blocks_size) {
-								preliminary_blocks_size += PRELIMINARY_BLOCKS_SIZE_INCREMENT;
-								new_strong_pairs = (preliminary_block*)realloc(preliminary_blocks, preliminary_blocks_size * sizeof(preliminary_block));
-								if (new_strong_pairs == NULL) {
-									delete ci;
-									ci = NULL;
-
-									free(w_values);
-									w_values = NULL;
-
-									free(w_values_sums);
-									w_values_sums = NULL;
-
-									free(w_values_sums_left);
-									w_values_sums_left = NULL;
-
-									free(w_values_max);
-									w_values_max = NULL;
-
-									free(terminations);
-									terminations = NULL;
-
-									free(breakpoints);
-									breakpoints = NULL;
-
-									throw Exception(__FILE__, __LINE__, "Error in memory reallocation.");
-								}
-								preliminary_blocks = new_strong_pairs;
-								new_strong_pairs = NULL;
-							}
-
-							preliminary_blocks[n_preliminary_blocks].start = j;
-							preliminary_blocks[n_preliminary_blocks].end = i;
-							preliminary_blocks[n_preliminary_blocks].length_bp = db->positions[i] - db->positions[j];
-
-							++n_preliminary_blocks;
-						}
-					} else if (auxiliary::fcmp(rsq, weak_pair_rsq, EPSILON) < 0) {
-						w_values_sums[i] -= recomb_pair_weight;
-						w_values[j] += w_values_sums[i];
-					} else {
-						w_values[j] += w_values_sums[i];
-					}
-				} else {
-					w_values[j] += w_values_sums[i];
-				}
+		delete sample_class_cache;
+		sample_class_cache = NULL;
 
-				/* With prior using pre-calculated sums, medium conservative. */
-				w_value_max = w_values[j] + w_values_max[i] - w_values_sums_left[i];
-				if (auxiliary::fcmp(w_value_max, 0.0, EPSILON) >= 0) {
-					updated_breakpoint = j;
-				}
-			}
+		throw;
+	}
 
-			terminations[i] = breakpoint;
+	db = region_db;
+	class_cache = region_class_cache;
+	deadline = region_deadline;
+	window = best_window;
+	auto_window = true;
 
-			w_values_sum_left += strong_pair_weight * terminations[i] + w_values_sums[i];
-			w_values_sums_left[i] = w_values_sum_left;
-		}
+	delete sample_class_cache;
+	sample_class_cache = NULL;
 
-		w_values_max[db->n_markers - 1u] = w_values_sums_left[db->n_markers - 1u];
-		for (long int k = db->n_markers - 1u; k >= 2u; --k) {
-			w_values_max[k - 1u] = w_values_max[k] > w_values_sums_left[k] ? w_values_max[k] : w_values_sums_left[k];
-		}
-	}
+	preliminary_blocks.reset(db->n_markers);
+}
 
-	delete ci;
-	ci = NULL;
+unsigned int AlgorithmMIGPP::get_window() {
+	return window;
+}
 
-	free(w_values);
-	w_values = NULL;
+unsigned int AlgorithmMIGPP::get_n_passes() {
+	return n_passes;
+}
 
-	free(w_values_sums);
-	w_values_sums = NULL;
+double AlgorithmMIGPP::get_wall_time() {
+#ifdef _OPENMP
+	return omp_get_wtime();
+#else
+	/* clock() is the CPU time of the process, not the elapsed time */
+	struct timeval now;
 
-	free(w_values_sums_left);
-	w_values_sums_left = NULL;
+	gettimeofday(&now, NULL);
 
-	free(w_values_max);
-	w_values_max = NULL;
+	return now.tv_sec + now.tv_usec / 1000000.0;
+#endif
+}
 
-	free(terminations);
-	terminations = NULL;
+void AlgorithmMIGPP::set_time_budget(double time_budget) {
+	deadline = time_budget > 0.0 ? get_wall_time() + time_budget : 0.0;
+}
 
-	free(breakpoints);
-	breakpoints = NULL;
+bool AlgorithmMIGPP::is_provisional() {
+	return provisional;
+}
+
+unsigned int AlgorithmMIGPP::get_reached_window() {
+	return reached_window;
 }
 
 Partition* AlgorithmMIGPP::get_block_partition() throw (Exception) {
@@ -446,6 +337,9 @@ Partition* AlgorithmMIGPP::get_block_partition() throw (Exception) {
 
 	partition->pruning_method = Algorithm::ALGORITHM_MIGPP;
 	partition->window = window;
+	partition->auto_window = auto_window;
+	partition->provisional = provisional;
+	partition->reached_window = reached_window;
 
 	return partition;
 }
@@ -453,8 +347,21 @@ Partition* AlgorithmMIGPP::get_block_partition() throw (Exception) {
 double AlgorithmMIGPP::get_memory_usage() {
 	double memory_usage = 0.0;
 
-	memory_usage += (4u * db->n_markers * sizeof(long double)) / 1048576.0;
+	memory_usage += (4u * db->n_markers * get_weight_size()) / 1048576.0;
 	memory_usage += (2u * db->n_markers * sizeof(long int)) / 1048576.0;
+	memory_usage += (db->n_markers * sizeof(unsigned int)) / 1048576.0;
+
+	if (strong_pair_bound != NULL) {
+		memory_usage += strong_pair_bound->get_memory_usage();
+	}
+
+	if (column_groups != NULL) {
+		memory_usage += column_groups->get_memory_usage();
+	}
+
+	if (haplotype_sample != NULL) {
+		memory_usage += haplotype_sample->get_memory_usage();
+	}
 
 	return memory_usage;
 }
@@ -0,0 +1,187 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/BlockStability.h"
+
+BlockStability::BlockStability(const DbView* db) throw (Exception) : db(db),
+		n_replicates(0u), n_blocks(0u), n_in_block(NULL), n_first(NULL), n_last(NULL), n_joined(NULL),
+		rsq_blocks(false),
+		ci_method(NULL), likelihood_density(0u),
+		strong_pair_cl(numeric_limits<double>::quiet_NaN()), strong_pair_cu(numeric_limits<double>::quiet_NaN()),
+		recomb_pair_cu(numeric_limits<double>::quiet_NaN()),
+		weak_pair_rsq(numeric_limits<double>::quiet_NaN()), strong_pair_rsq(numeric_limits<double>::quiet_NaN()),
+		strong_pairs_fraction(numeric_limits<double>::quiet_NaN()),
+		pruning_method(NULL), window(0u), auto_window(false),
+		seed(0u) {
+
+	n_in_block = (unsigned int*)calloc(db->n_markers, sizeof(unsigned int));
+	n_first = (unsigned int*)calloc(db->n_markers, sizeof(unsigned int));
+	n_last = (unsigned int*)calloc(db->n_markers, sizeof(unsigned int));
+	n_joined = (unsigned int*)calloc(db->n_markers, sizeof(unsigned int));
+
+	if ((n_in_block == NULL) || (n_first == NULL) || (n_last == NULL) || (n_joined == NULL)) {
+		free(n_in_block);
+		n_in_block = NULL;
+
+		free(n_first);
+		n_first = NULL;
+
+		free(n_last);
+		n_last = NULL;
+
+		free(n_joined);
+		n_joined = NULL;
+
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+}
+
+BlockStability::~BlockStability() {
+	db = NULL;
+
+	free(n_in_block);
+	n_in_block = NULL;
+
+	free(n_first);
+	n_first = NULL;
+
+	free(n_last);
+	n_last = NULL;
+
+	free(n_joined);
+	n_joined = NULL;
+}
+
+void BlockStability::add(Partition* partition) {
+	unsigned int start = 0u;
+	unsigned int end = 0u;
+
+	if (n_replicates == 0u) {
+		rsq_blocks = partition->rsq_blocks;
+		ci_method = partition->ci_method;
+		likelihood_density = partition->likelihood_density;
+		strong_pair_cl = partition->strong_pair_cl;
+		strong_pair_cu = partition->strong_pair_cu;
+		recomb_pair_cu = partition->recomb_pair_cu;
+		weak_pair_rsq = partition->weak_pair_rsq;
+		strong_pair_rsq = partition->strong_pair_rsq;
+		strong_pairs_fraction = partition->strong_pairs_fraction;
+		pruning_method = partition->pruning_method;
+		window = partition->window;
+		auto_window = partition->auto_window;
+	}
+
+	for (unsigned int b = 0u; b < partition->get_n_blocks(); ++b) {
+		partition->get_block(b, &start, &end);
+
+		++n_first[start];
+		++n_last[end];
+		for (unsigned int i = start; i < end; ++i) {
+			++n_in_block[i];
+			++n_joined[i];
+		}
+		++n_in_block[end];
+	}
+
+	n_blocks += partition->get_n_blocks();
+	++n_replicates;
+}
+
+unsigned int BlockStability::get_n_replicates() {
+	return n_replicates;
+}
+
+double BlockStability::get_mean_n_blocks() {
+	return n_replicates > 0u ? n_blocks / (double)n_replicates : 0.0;
+}
+
+void BlockStability::write(const char* output_file_name) throw (Exception) {
+	Writer* writer = NULL;
+
+	double n = n_replicates > 0u ? (double)n_replicates : 1.0;
+
+	try {
+		writer = WriterFactory::create(Writer::TEXT);
+		writer->set_file_name(output_file_name);
+		writer->open(false);
+
+		writer->write("# VERSION: %s\n", LDEXPLORER_VERSION);
+		writer->write("# PHASE FILE: %s\n", db->hap_file_name);
+		writer->write("# MAP FILE: %s\n", db->map_file_name == NULL ? "NA" : db->map_file_name);
+		if ((db->start_position > 0u) || (db->end_position != numeric_limits<unsigned long int>::max())) {
+			writer->write("# REGION: [%u, %u]\n", db->start_position, db->end_position);
+		} else {
+			writer->write("# REGION: NA\n");
+		}
+		writer->write("# MAF FILTER: > %g\n", db->maf_threshold);
+		writer->write("# ALL SNPs: %u\n", db->n_unfiltered_markers);
+		writer->write("# FILTERED SNPs: %u\n",db->n_markers);
+		writer->write("# HAPLOTYPES: %u\n", db->n_haplotypes);
+
+		if (!rsq_blocks) {
+			writer->write("# D' CI COMPUTATION METHOD: %s\n", ci_method);
+			if (likelihood_density > 0u) {
+				writer->write("# D' LIKELIHOOD DENSITY: %u\n", likelihood_density);
+			} else {
+				writer->write("# D' LIKELIHOOD DENSITY: NA\n");
+			}
+			writer->write("# D' CI LOWER BOUND FOR STRONG LD: >= %g\n", strong_pair_cl);
+			writer->write("# D' CI UPPER BOUND FOR STRONG LD: >= %g\n", strong_pair_cu);
+			writer->write("# D' CI UPPER BOUND FOR RECOMBINATION: <= %g\n", recomb_pair_cu);
+		} else {
+			writer->write("# WEAK LD r^2: < %g\n", weak_pair_rsq);
+			writer->write("# STRONG LD r^2: >= %g\n", strong_pair_rsq);
+		}
+		writer->write("# FRACTION OF STRONG LD SNP PAIRS: >= %g\n", strong_pairs_fraction);
+		writer->write("# PRUNING METHOD: %s\n", pruning_method);
+		if ((window > 0u) && auto_window) {
+			writer->write("# WINDOW: %ld (AUTO)\n", window);
+		} else if (window > 0u) {
+			writer->write("# WINDOW: %ld\n", window);
+		} else {
+			writer->write("# WINDOW: NA\n");
+		}
+		writer->write("# BOOTSTRAP REPLICATES: %u\n", n_replicates);
+		writer->write("# BOOTSTRAP SEED: %lu\n", (unsigned long int)seed);
+
+		writer->write("%s\t%s\t%s\t%s\t%s\t%s\t%s\n",
+				"SNP", "SNP_ID", "POSITION", "IN_BLOCK", "FIRST_IN_BLOCK", "LAST_IN_BLOCK", "SAME_BLOCK_AS_NEXT");
+
+		for (unsigned int i = 0u; i < db->n_markers; ++i) {
+			writer->write("%s\t%u\t%lu\t%g\t%g\t%g\t", db->markers[i], i, db->positions[i], n_in_block[i] / n, n_first[i] / n, n_last[i] / n);
+			if (i + 1u < db->n_markers) {
+				writer->write("%g\n", n_joined[i] / n);
+			} else {
+				writer->write("NA\n");
+			}
+		}
+
+		writer->close();
+		delete writer;
+	} catch (Exception &e) {
+		if (writer != NULL) {
+			delete writer;
+		}
+		throw;
+	}
+}
+
+double BlockStability::get_memory_usage() {
+	return (4u * db->n_markers * sizeof(unsigned int)) / 1048576.0;
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/BootstrapReplicate.h"
+
+BootstrapReplicate::BootstrapReplicate(const DbView* db, uint64_t seed, unsigned int replicate) throw (Exception) : db(db), view(NULL), weights(NULL) {
+	unsigned int* multiplicities = NULL;
+	unsigned int* markers = NULL;
+
+	/* every replicate starts its own splitmix64 sequence, so the replicates do not depend on the order in which they are drawn */
+	uint64_t state = seed ^ (0xD1B54A32D192ED03ULL * ((uint64_t)replicate + 1u));
+	unsigned int n_words = db->n_haplotype_words;
+	unsigned int n_planes = 0u;
+	unsigned int max_multiplicity = 0u;
+	unsigned int haplotype = 0u;
+	unsigned int n_minor = 0u;
+	unsigned int n_missing = 0u;
+	unsigned int n_valid = 0u;
+	const uint64_t* plane = NULL;
+
+	if (db->haplotype_weights != NULL) {
+		throw Exception(__FILE__, __LINE__, "The view of a bootstrap replicate can not be resampled.");
+	}
+
+	multiplicities = (unsigned int*)calloc(db->n_haplotypes, sizeof(unsigned int));
+	markers = (unsigned int*)malloc(db->n_markers * sizeof(unsigned int));
+	if ((multiplicities == NULL) || (markers == NULL)) {
+		free(multiplicities);
+		multiplicities = NULL;
+
+		free(markers);
+		markers = NULL;
+
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	for (unsigned int h = 0u; h < db->n_haplotypes; ++h) {
+		haplotype = (unsigned int)(((auxiliary::next_random(&state) >> 32) * (uint64_t)db->n_haplotypes) >> 32);
+		++multiplicities[haplotype];
+	}
+
+	for (unsigned int h = 0u; h < db->n_haplotypes; ++h) {
+		max_multiplicity = multiplicities[h] > max_multiplicity ? multiplicities[h] : max_multiplicity;
+	}
+
+	while ((max_multiplicity >> n_planes) != 0u) {
+		++n_planes;
+	}
+
+	weights = (uint64_t*)auxiliary::aligned_malloc((size_t)n_planes * n_words * sizeof(uint64_t), Db::HAPLOTYPE_WORDS_ALIGNMENT * sizeof(uint64_t));
+	if (weights == NULL) {
+		free(multiplicities);
+		multiplicities = NULL;
+
+		free(markers);
+		markers = NULL;
+
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	memset(weights, 0, (size_t)n_planes * n_words * sizeof(uint64_t));
+
+	/* the planes are over the haplotypes of the Db, so the haplotypes of a population view are mapped */
+	for (unsigned int h = 0u; h < db->n_haplotypes; ++h) {
+		haplotype = db->haplotypes != NULL ? db->haplotypes[h] : h;
+		for (unsigned int k = 0u; k < n_planes; ++k) {
+			if (((multiplicities[h] >> k) & 1u) != 0u) {
+				weights[(size_t)k * n_words + (haplotype >> 6)] |= ((uint64_t)1u) << (haplotype & 63u);
+			}
+		}
+	}
+
+	for (unsigned int i = 0u; i < db->n_markers; ++i) {
+		markers[i] = i;
+	}
+
+	try {
+		view = db->create_subview(markers, db->n_markers);
+	} catch (Exception &e) {
+		free(multiplicities);
+		multiplicities = NULL;
+
+		free(markers);
+		markers = NULL;
+
+		auxiliary::aligned_free(weights);
+		weights = NULL;
+
+		throw;
+	}
+
+	view->haplotypes = NULL;
+	view->haplotype_mask = NULL;
+	view->haplotype_weights = weights;
+	view->n_haplotype_weight_planes = n_planes;
+
+	for (unsigned int i = 0u; i < db->n_markers; ++i) {
+		n_minor = 0u;
+		n_missing = 0u;
+
+		for (unsigned int k = 0u; k < n_planes; ++k) {
+			plane = weights + (size_t)k * n_words;
+			for (unsigned int w = 0u; w < n_words; ++w) {
+				n_minor += auxiliary::popcount(db->minor_haplotypes[i][w] & plane[w]) << k;
+			}
+			if (db->missing_haplotypes[i] != NULL) {
+				for (unsigned int w = 0u; w < n_words; ++w) {
+					n_missing += auxiliary::popcount(db->missing_haplotypes[i][w] & plane[w]) << k;
+				}
+			}
+		}
+
+		n_valid = db->n_haplotypes - n_missing;
+
+		view->n_minor_alleles[i] = n_minor;
+		view->major_allele_freqs[i] = n_valid > 0u ? ((double)(n_valid - n_minor)) / ((double)n_valid) : 1.0;
+		if (n_missing == 0u) {
+			view->missing_haplotypes[i] = NULL;
+		}
+	}
+
+	free(multiplicities);
+	multiplicities = NULL;
+
+	free(markers);
+	markers = NULL;
+}
+
+BootstrapReplicate::~BootstrapReplicate() {
+	delete view;
+	view = NULL;
+
+	auxiliary::aligned_free(weights);
+	weights = NULL;
+
+	db = NULL;
+}
+
+const DbView* BootstrapReplicate::get_view() {
+	return view;
+}
+
+double BootstrapReplicate::get_memory_usage() {
+	double memory_usage = 0.0;
+
+	if (view != NULL) {
+		memory_usage += ((double)view->n_haplotype_weight_planes * view->n_haplotype_words * sizeof(uint64_t)) / 1048576.0;
+		memory_usage += view->get_memory_usage();
+	}
+
+	return memory_usage;
+}
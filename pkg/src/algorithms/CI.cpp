@@ -25,181 +25,249 @@ const char* CI::CI_AV = "AV";
 
 const double CI::EPSILON = 0.000000001;
 
+const unsigned int CI::PAIR_UNKNOWN = 0u;
+const unsigned int CI::PAIR_STRONG_LD = 1u;
+const unsigned int CI::PAIR_RECOMB = 2u;
+const unsigned int CI::PAIR_OTHER = 3u;
+
 CI::CI() :
 		db(NULL),
-		observed_haplotype_a(NULL), observed_haplotype_b(NULL),
 		n_observed_haplotype_ref_a_ref_b(0u), n_observed_haplotype_ref_a_alt_b(0u), n_observed_haplotype_alt_a_ref_b(0u), n_observed_haplotype_alt_a_alt_b(0u),
-		observed_allele_a('\0'), observed_allele_b('\0'),
-		observed_ref_allele_a('\0'), observed_alt_allele_a('\0'), observed_ref_allele_b('\0'), observed_alt_allele_b('\0'),
 		observed_major_af_a(0.0), observed_major_af_b(0.0),
-		observed_d(0.0) {
+		observed_d(0.0),
+		cache(NULL), class_cache(NULL),
+		pos_strong_pair_cl(0.7), neg_strong_pair_cl(-0.7),
+		pos_strong_pair_cu(0.98), neg_strong_pair_cu(-0.98),
+		pos_recomb_pair_cu(0.9), neg_recomb_pair_cu(-0.9),
+		range_counts(NULL), masked_minor_a(NULL) {
 
 }
 
 CI::~CI() {
 	db = NULL;
+	cache = NULL;
+	class_cache = NULL;
+
+	free(range_counts);
+	range_counts = NULL;
+
+	auxiliary::aligned_free(masked_minor_a);
+	masked_minor_a = NULL;
 }
 
 void CI::set_dbview(const DbView* db) {
 	this->db = db;
+
+	free(range_counts);
+	range_counts = NULL;
+
+	auxiliary::aligned_free(masked_minor_a);
+	masked_minor_a = NULL;
 }
 
-double CI::get_D(unsigned int marker_a, unsigned int marker_b) {
-	observed_haplotype_a = db->haplotypes[marker_a];
-	observed_haplotype_b = db->haplotypes[marker_b];
+void CI::set_cache(CICache* cache) {
+	this->cache = cache;
+}
 
-	n_observed_haplotype_ref_a_ref_b = n_observed_haplotype_ref_a_alt_b = n_observed_haplotype_alt_a_ref_b = n_observed_haplotype_alt_a_alt_b = 0u;
+void CI::set_class_cache(PairClassCache* class_cache) {
+	this->class_cache = class_cache;
+}
 
-	observed_ref_allele_a = db->major_alleles[marker_a];
-	observed_alt_allele_a = db->minor_alleles[marker_a];
+void CI::set_pair_thresholds(double strong_pair_cl, double strong_pair_cu, double recomb_pair_cu) {
+	pos_strong_pair_cl = strong_pair_cl;
+	neg_strong_pair_cl = -pos_strong_pair_cl;
 
-	observed_ref_allele_b = db->major_alleles[marker_b];
-	observed_alt_allele_b = db->minor_alleles[marker_b];
+	pos_strong_pair_cu = strong_pair_cu;
+	neg_strong_pair_cu = -pos_strong_pair_cu;
+
+	pos_recomb_pair_cu = recomb_pair_cu;
+	neg_recomb_pair_cu = -pos_recomb_pair_cu;
+}
 
+void CI::count_haplotypes(unsigned int marker_a, unsigned int marker_b) {
 	observed_major_af_a = db->major_allele_freqs[marker_a];
 	observed_major_af_b = db->major_allele_freqs[marker_b];
 
-	for (unsigned int i = 0u; i < db->n_haplotypes; ++i) {
-		observed_allele_a = observed_haplotype_a[i];
-		observed_allele_b = observed_haplotype_b[i];
-		if (observed_allele_a == observed_ref_allele_a) {
-			if (observed_allele_b == observed_ref_allele_b) {
-				++n_observed_haplotype_ref_a_ref_b;
-			} else if (observed_allele_b == observed_alt_allele_b) {
-				++n_observed_haplotype_ref_a_alt_b;
-			}
-		} else if (observed_allele_a == observed_alt_allele_a) {
-			if (observed_allele_b == observed_ref_allele_b) {
-				++n_observed_haplotype_alt_a_ref_b;
-			} else if (observed_allele_b == observed_alt_allele_b) {
-				++n_observed_haplotype_alt_a_alt_b;
-			}
+	PairCounter::count(db, marker_a, marker_b,
+			&n_observed_haplotype_ref_a_ref_b, &n_observed_haplotype_ref_a_alt_b, &n_observed_haplotype_alt_a_ref_b, &n_observed_haplotype_alt_a_alt_b);
+}
+
+void CI::count_haplotypes_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b) throw (Exception) {
+	if (range_counts == NULL) {
+		range_counts = (unsigned int*)malloc(4u * db->n_markers * sizeof(unsigned int));
+		if (range_counts == NULL) {
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+		}
+	}
+
+	if (((db->haplotype_mask != NULL) || (db->haplotype_weights != NULL)) && (masked_minor_a == NULL)) {
+		masked_minor_a = (uint64_t*)auxiliary::aligned_malloc(db->n_haplotype_words * sizeof(uint64_t), Db::HAPLOTYPE_WORDS_ALIGNMENT * sizeof(uint64_t));
+		if (masked_minor_a == NULL) {
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
 		}
 	}
 
-	return (n_observed_haplotype_ref_a_ref_b / (double)(n_observed_haplotype_ref_a_ref_b + n_observed_haplotype_ref_a_alt_b + n_observed_haplotype_alt_a_ref_b + n_observed_haplotype_alt_a_alt_b)) - (observed_major_af_a * observed_major_af_b);
+	observed_major_af_a = db->major_allele_freqs[marker_a];
+
+	if ((db->haplotype_mask != NULL) || (db->haplotype_weights != NULL)) {
+		PairCounter::count_range_masked(db, marker_a, first_marker_b, n_markers_b, masked_minor_a, range_counts);
+	} else {
+		PairCounter::count_range(db, marker_a, first_marker_b, n_markers_b, range_counts);
+	}
 }
 
-double CI::get_Dprime(unsigned int marker_a, unsigned int marker_b) {
-	observed_haplotype_a = db->haplotypes[marker_a];
-	observed_haplotype_b = db->haplotypes[marker_b];
+void CI::load_range_haplotypes(unsigned int first_marker_b, unsigned int b) {
+	const unsigned int* cells = range_counts + (b << 2);
 
-	n_observed_haplotype_ref_a_ref_b = n_observed_haplotype_ref_a_alt_b = n_observed_haplotype_alt_a_ref_b = n_observed_haplotype_alt_a_alt_b = 0u;
+	/* compute_CI() may rearrange the counts and the frequency of marker b, but never the frequency of marker a */
+	observed_major_af_b = db->major_allele_freqs[first_marker_b + b];
 
-	observed_ref_allele_a = db->major_alleles[marker_a];
-	observed_alt_allele_a = db->minor_alleles[marker_a];
+	n_observed_haplotype_ref_a_ref_b = cells[0u];
+	n_observed_haplotype_ref_a_alt_b = cells[1u];
+	n_observed_haplotype_alt_a_ref_b = cells[2u];
+	n_observed_haplotype_alt_a_alt_b = cells[3u];
+}
 
-	observed_ref_allele_b = db->major_alleles[marker_b];
-	observed_alt_allele_b = db->minor_alleles[marker_b];
+void CI::compute_observed_d() {
+	observed_d = (n_observed_haplotype_ref_a_ref_b / (double)(n_observed_haplotype_ref_a_ref_b + n_observed_haplotype_ref_a_alt_b + n_observed_haplotype_alt_a_ref_b + n_observed_haplotype_alt_a_alt_b)) - (observed_major_af_a * observed_major_af_b);
+}
 
-	observed_major_af_a = db->major_allele_freqs[marker_a];
-	observed_major_af_b = db->major_allele_freqs[marker_b];
+void CI::get_stats(unsigned int marker_a, unsigned int marker_b, pair_stats* stats, bool with_ci) {
+	count_haplotypes(marker_a, marker_b);
 
-	for (unsigned int i = 0u; i < db->n_haplotypes; i++) {
-		observed_allele_a = observed_haplotype_a[i];
-		observed_allele_b = observed_haplotype_b[i];
-		if (observed_allele_a == observed_ref_allele_a) {
-			if (observed_allele_b == observed_ref_allele_b) {
-				n_observed_haplotype_ref_a_ref_b++;
-			} else if (observed_allele_b == observed_alt_allele_b) {
-				n_observed_haplotype_ref_a_alt_b++;
-			}
-		} else if (observed_allele_a == observed_alt_allele_a) {
-			if (observed_allele_b == observed_ref_allele_b) {
-				n_observed_haplotype_alt_a_ref_b++;
-			} else if (observed_allele_b == observed_alt_allele_b) {
-				n_observed_haplotype_alt_a_alt_b++;
-			}
-		}
-	}
+	stats->n_ref_a_ref_b = n_observed_haplotype_ref_a_ref_b;
+	stats->n_ref_a_alt_b = n_observed_haplotype_ref_a_alt_b;
+	stats->n_alt_a_ref_b = n_observed_haplotype_alt_a_ref_b;
+	stats->n_alt_a_alt_b = n_observed_haplotype_alt_a_alt_b;
 
-	observed_d = (n_observed_haplotype_ref_a_ref_b / (double)(n_observed_haplotype_ref_a_ref_b + n_observed_haplotype_ref_a_alt_b + n_observed_haplotype_alt_a_ref_b + n_observed_haplotype_alt_a_alt_b)) - (observed_major_af_a * observed_major_af_b);
+	compute_observed_d();
+
+	stats->d = observed_d;
 
 	if (observed_d < 0.0) {
-		return observed_d / min(observed_major_af_a * observed_major_af_b, (1 - observed_major_af_a) * (1 - observed_major_af_b));
+		stats->dprime = observed_d / min(observed_major_af_a * observed_major_af_b, (1 - observed_major_af_a) * (1 - observed_major_af_b));
 	} else if (observed_d > 0.0) {
-		return observed_d / min(observed_major_af_a * (1 - observed_major_af_b), (1 - observed_major_af_a) * observed_major_af_b);
+		stats->dprime = observed_d / min(observed_major_af_a * (1 - observed_major_af_b), (1 - observed_major_af_a) * observed_major_af_b);
 	} else {
-		return numeric_limits<double>::quiet_NaN();
+		stats->dprime = numeric_limits<double>::quiet_NaN();
+	}
+
+	stats->r = observed_d / sqrt(observed_major_af_a * (1.0 - observed_major_af_a) * observed_major_af_b * (1.0 - observed_major_af_b));
+	stats->rsq = (observed_d * observed_d) / (observed_major_af_a * (1.0 - observed_major_af_a) * observed_major_af_b * (1.0 - observed_major_af_b));
+
+	stats->dprime_lower_ci = stats->dprime_upper_ci = numeric_limits<double>::quiet_NaN();
+	if (with_ci) {
+		/* must be the last step: compute_CI() may rearrange the counts */
+		compute_cached_CI(&stats->dprime_lower_ci, &stats->dprime_upper_ci);
 	}
 }
 
+double CI::get_D(unsigned int marker_a, unsigned int marker_b) {
+	pair_stats stats;
+
+	get_stats(marker_a, marker_b, &stats, false);
+
+	return stats.d;
+}
+
+double CI::get_Dprime(unsigned int marker_a, unsigned int marker_b) {
+	pair_stats stats;
+
+	get_stats(marker_a, marker_b, &stats, false);
+
+	return stats.dprime;
+}
+
 double CI::get_r(unsigned int marker_a, unsigned int marker_b) {
-	observed_haplotype_a = db->haplotypes[marker_a];
-	observed_haplotype_b = db->haplotypes[marker_b];
+	pair_stats stats;
 
-	n_observed_haplotype_ref_a_ref_b = n_observed_haplotype_ref_a_alt_b = n_observed_haplotype_alt_a_ref_b = n_observed_haplotype_alt_a_alt_b = 0u;
+	get_stats(marker_a, marker_b, &stats, false);
 
-	observed_ref_allele_a = db->major_alleles[marker_a];
-	observed_alt_allele_a = db->minor_alleles[marker_a];
+	return stats.r;
+}
 
-	observed_ref_allele_b = db->major_alleles[marker_b];
-	observed_alt_allele_b = db->minor_alleles[marker_b];
+double CI::get_rsq(unsigned int marker_a, unsigned int marker_b) {
+	pair_stats stats;
 
-	observed_major_af_a = db->major_allele_freqs[marker_a];
-	observed_major_af_b = db->major_allele_freqs[marker_b];
+	get_stats(marker_a, marker_b, &stats, false);
 
-	for (unsigned int i = 0u; i < db->n_haplotypes; i++) {
-		observed_allele_a = observed_haplotype_a[i];
-		observed_allele_b = observed_haplotype_b[i];
-		if (observed_allele_a == observed_ref_allele_a) {
-			if (observed_allele_b == observed_ref_allele_b) {
-				n_observed_haplotype_ref_a_ref_b++;
-			} else if (observed_allele_b == observed_alt_allele_b) {
-				n_observed_haplotype_ref_a_alt_b++;
-			}
-		} else if (observed_allele_a == observed_alt_allele_a) {
-			if (observed_allele_b == observed_ref_allele_b) {
-				n_observed_haplotype_alt_a_ref_b++;
-			} else if (observed_allele_b == observed_alt_allele_b) {
-				n_observed_haplotype_alt_a_alt_b++;
-			}
-		}
+	return stats.rsq;
+}
+
+void CI::get_CI(unsigned int marker_a, unsigned int marker_b, double* dprime_lower_ci, double* dprime_upper_ci) {
+	count_haplotypes(marker_a, marker_b);
+
+	compute_observed_d();
+
+	compute_cached_CI(dprime_lower_ci, dprime_upper_ci);
+}
+
+void CI::get_CI_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, double* dprime_lower_cis, double* dprime_upper_cis) throw (Exception) {
+	count_haplotypes_range(marker_a, first_marker_b, n_markers_b);
+
+	for (unsigned int b = 0u; b < n_markers_b; ++b) {
+		load_range_haplotypes(first_marker_b, b);
+		compute_observed_d();
+		compute_cached_CI(&dprime_lower_cis[b], &dprime_upper_cis[b]);
 	}
+}
 
-	observed_d = (n_observed_haplotype_ref_a_ref_b / (double)(n_observed_haplotype_ref_a_ref_b + n_observed_haplotype_ref_a_alt_b + n_observed_haplotype_alt_a_ref_b + n_observed_haplotype_alt_a_alt_b)) - (observed_major_af_a * observed_major_af_b);
+void CI::compute_CI(double* dprime_lower_ci, double* dprime_upper_ci) {
 
-	return observed_d / sqrt(observed_major_af_a * (1.0 - observed_major_af_a) * observed_major_af_b * (1.0 - observed_major_af_b));
 }
 
-double CI::get_rsq(unsigned int marker_a, unsigned int marker_b) {
-	observed_haplotype_a = db->haplotypes[marker_a];
-	observed_haplotype_b = db->haplotypes[marker_b];
+unsigned int CI::classify_bounded() {
+	return PAIR_UNKNOWN;
+}
 
-	n_observed_haplotype_ref_a_ref_b = n_observed_haplotype_ref_a_alt_b = n_observed_haplotype_alt_a_ref_b = n_observed_haplotype_alt_a_alt_b = 0u;
+unsigned int CI::classify_CI(double dprime_lower_ci, double dprime_upper_ci) {
+	if (isnan(dprime_lower_ci) || isnan(dprime_upper_ci)) {
+		return PAIR_OTHER;
+	}
 
-	observed_ref_allele_a = db->major_alleles[marker_a];
-	observed_alt_allele_a = db->minor_alleles[marker_a];
+	if (((auxiliary::fcmp(dprime_lower_ci, pos_strong_pair_cl, EPSILON) >= 0) && (auxiliary::fcmp(dprime_upper_ci, pos_strong_pair_cu, EPSILON) >= 0)) ||
+			((auxiliary::fcmp(dprime_lower_ci, neg_strong_pair_cu, EPSILON) <= 0) && (auxiliary::fcmp(dprime_upper_ci, neg_strong_pair_cl, EPSILON) <= 0))) {
+		return PAIR_STRONG_LD;
+	}
 
-	observed_ref_allele_b = db->major_alleles[marker_b];
-	observed_alt_allele_b = db->minor_alleles[marker_b];
+	if ((auxiliary::fcmp(dprime_lower_ci, neg_recomb_pair_cu, EPSILON) >= 0) && (auxiliary::fcmp(dprime_upper_ci, pos_recomb_pair_cu, EPSILON) <= 0)) {
+		return PAIR_RECOMB;
+	}
 
-	observed_major_af_a = db->major_allele_freqs[marker_a];
-	observed_major_af_b = db->major_allele_freqs[marker_b];
+	return PAIR_OTHER;
+}
+
+unsigned int CI::classify(unsigned int marker_a, unsigned int marker_b) {
+	unsigned int pair_class = PAIR_UNKNOWN;
 
-	for (unsigned int i = 0u; i < db->n_haplotypes; i++) {
-		observed_allele_a = observed_haplotype_a[i];
-		observed_allele_b = observed_haplotype_b[i];
-		if (observed_allele_a == observed_ref_allele_a) {
-			if (observed_allele_b == observed_ref_allele_b) {
-				n_observed_haplotype_ref_a_ref_b++;
-			} else if (observed_allele_b == observed_alt_allele_b) {
-				n_observed_haplotype_ref_a_alt_b++;
-			}
-		} else if (observed_allele_a == observed_alt_allele_a) {
-			if (observed_allele_b == observed_ref_allele_b) {
-				n_observed_haplotype_alt_a_ref_b++;
-			} else if (observed_allele_b == observed_alt_allele_b) {
-				n_observed_haplotype_alt_a_alt_b++;
-			}
+	if (class_cache != NULL) {
+		pair_class = class_cache->lookup(db->indices[marker_a], db->indices[marker_b]);
+		if (pair_class != PAIR_UNKNOWN) {
+			return pair_class;
 		}
 	}
 
-	observed_d = (n_observed_haplotype_ref_a_ref_b / (double)(n_observed_haplotype_ref_a_ref_b + n_observed_haplotype_ref_a_alt_b + n_observed_haplotype_alt_a_ref_b + n_observed_haplotype_alt_a_alt_b)) - (observed_major_af_a * observed_major_af_b);
+	count_haplotypes(marker_a, marker_b);
+
+	compute_observed_d();
+
+	pair_class = classify_counted();
+
+	if (class_cache != NULL) {
+		class_cache->store(db->indices[marker_a], db->indices[marker_b], pair_class);
+	}
 
-	return (observed_d * observed_d) / (observed_major_af_a * (1.0 - observed_major_af_a) * observed_major_af_b * (1.0 - observed_major_af_b));
+	return pair_class;
 }
 
-void CI::get_CI(unsigned int marker_a, unsigned int marker_b, double* dprime_lower_ci, double* dprime_upper_ci) {
+void CI::classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception) {
+	classify_range_as<CI>(marker_a, first_marker_b, n_markers_b, pair_classes);
+}
+
+unsigned int CI::classify_counted() {
+	return classify_counted_as<CI>();
+}
 
+void CI::compute_cached_CI(double* dprime_lower_ci, double* dprime_upper_ci) {
+	compute_cached_CI_as<CI>(dprime_lower_ci, dprime_upper_ci);
 }
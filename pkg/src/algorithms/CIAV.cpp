@@ -30,40 +30,11 @@ CIAV::~CIAV() {
 
 }
 
-void CIAV::get_CI(unsigned int marker_a, unsigned int marker_b, double* dprime_lower_ci, double* dprime_upper_ci) {
-	observed_ref_allele_a = db->major_alleles[marker_a];
-	observed_alt_allele_a = db->minor_alleles[marker_a];
-
-	observed_ref_allele_b = db->major_alleles[marker_b];
-	observed_alt_allele_b = db->minor_alleles[marker_b];
-
-	observed_major_af_a = db->major_allele_freqs[marker_a];
-	observed_major_af_b = db->major_allele_freqs[marker_b];
-
-	observed_haplotype_a = db->haplotypes[marker_a];
-	observed_haplotype_b = db->haplotypes[marker_b];
-
-	n_observed_haplotype_ref_a_ref_b = n_observed_haplotype_ref_a_alt_b = n_observed_haplotype_alt_a_ref_b = n_observed_haplotype_alt_a_alt_b = 0u;
-
-	for (unsigned int i = 0u; i < db->n_haplotypes; ++i) {
-		observed_allele_a = observed_haplotype_a[i];
-		observed_allele_b = observed_haplotype_b[i];
-		if (observed_allele_a == observed_ref_allele_a) {
-			if (observed_allele_b == observed_ref_allele_b) {
-				++n_observed_haplotype_ref_a_ref_b;
-			} else if (observed_allele_b == observed_alt_allele_b) {
-				++n_observed_haplotype_ref_a_alt_b;
-			}
-		} else if (observed_allele_a == observed_alt_allele_a) {
-			if (observed_allele_b == observed_ref_allele_b) {
-				++n_observed_haplotype_alt_a_ref_b;
-			} else if (observed_allele_b == observed_alt_allele_b) {
-				++n_observed_haplotype_alt_a_alt_b;
-			}
-		}
-	}
+void CIAV::classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception) {
+	classify_range_as<CIAV>(marker_a, first_marker_b, n_markers_b, pair_classes);
+}
 
-	observed_d = (n_observed_haplotype_ref_a_ref_b / (double)(n_observed_haplotype_ref_a_ref_b + n_observed_haplotype_ref_a_alt_b + n_observed_haplotype_alt_a_ref_b + n_observed_haplotype_alt_a_alt_b)) - (observed_major_af_a * observed_major_af_b);
+void CIAV::compute_CI(double* dprime_lower_ci, double* dprime_upper_ci) {
 	var_d = (observed_major_af_a * (1.0 - observed_major_af_a) * observed_major_af_b * (1.0 - observed_major_af_b) + observed_d * ((1.0 - observed_major_af_a) - observed_major_af_a) * ((1.0 - observed_major_af_b) - observed_major_af_b) - observed_d * observed_d) / db->n_haplotypes;
 
 	switch (auxiliary::fcmp(observed_d, 0.0, EPSILON)) {
@@ -0,0 +1,175 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/CICache.h"
+
+const unsigned int CICache::DEFAULT_SIZE = 65536u;
+const unsigned int CICache::DEFAULT_N_SHARDS = 64u;
+
+CICache::CICache(unsigned int size, unsigned int n_shards) throw (Exception) :
+		shards(NULL), n_shards(n_shards), shard_size(0u) {
+
+	if (n_shards == 0u) {
+		throw Exception(__FILE__, __LINE__, "The number of cache shards must be positive.");
+	}
+
+	shard_size = size / n_shards;
+	if (shard_size == 0u) {
+		shard_size = 1u;
+	}
+
+	shards = (shard*)malloc(n_shards * sizeof(shard));
+	if (shards == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	for (unsigned int i = 0u; i < n_shards; ++i) {
+		shards[i].entries = NULL;
+	}
+
+	for (unsigned int i = 0u; i < n_shards; ++i) {
+		shards[i].entries = (entry*)malloc(shard_size * sizeof(entry));
+		if (shards[i].entries == NULL) {
+			/* the destructor does not run: release the shards allocated so far, which are the ones with a lock */
+			for (unsigned int k = 0u; k < i; ++k) {
+				free(shards[k].entries);
+				shards[k].entries = NULL;
+#ifdef _OPENMP
+				omp_destroy_lock(&shards[k].lock);
+#endif
+			}
+
+			free(shards);
+			shards = NULL;
+
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+		}
+
+		/* four maximal counts can never be observed together, so they mark an empty entry */
+		for (unsigned int j = 0u; j < shard_size; ++j) {
+			shards[i].entries[j].counts[0u] = shards[i].entries[j].counts[1u] = shards[i].entries[j].counts[2u] = shards[i].entries[j].counts[3u] = 0xffffffffu;
+		}
+
+		shards[i].n_lookups = 0u;
+		shards[i].n_hits = 0u;
+#ifdef _OPENMP
+		omp_init_lock(&shards[i].lock);
+#endif
+	}
+}
+
+CICache::~CICache() {
+	if (shards != NULL) {
+		for (unsigned int i = 0u; i < n_shards; ++i) {
+			if (shards[i].entries != NULL) {
+				free(shards[i].entries);
+				shards[i].entries = NULL;
+#ifdef _OPENMP
+				omp_destroy_lock(&shards[i].lock);
+#endif
+			}
+		}
+
+		free(shards);
+		shards = NULL;
+	}
+}
+
+uint64_t CICache::hash(const unsigned int* counts) {
+	uint64_t h = ((((uint64_t)counts[0u]) << 32) | counts[1u]) * 0x9e3779b97f4a7c15ull;
+
+	h ^= ((((uint64_t)counts[2u]) << 32) | counts[3u]) * 0xc2b2ae3d27d4eb4full;
+	h ^= h >> 29;
+	h *= 0xbf58476d1ce4e5b9ull;
+	h ^= h >> 32;
+
+	return h;
+}
+
+bool CICache::lookup(const unsigned int* counts, double* dprime_lower_ci, double* dprime_upper_ci) {
+	uint64_t h = hash(counts);
+	shard* s = &shards[h % n_shards];
+	entry* e = &(s->entries[(h / n_shards) % shard_size]);
+	bool hit = false;
+
+#ifdef _OPENMP
+	omp_set_lock(&s->lock);
+#endif
+	++s->n_lookups;
+	if ((e->counts[0u] == counts[0u]) && (e->counts[1u] == counts[1u]) && (e->counts[2u] == counts[2u]) && (e->counts[3u] == counts[3u])) {
+		*dprime_lower_ci = e->dprime_lower_ci;
+		*dprime_upper_ci = e->dprime_upper_ci;
+		++s->n_hits;
+		hit = true;
+	}
+#ifdef _OPENMP
+	omp_unset_lock(&s->lock);
+#endif
+
+	return hit;
+}
+
+void CICache::store(const unsigned int* counts, double dprime_lower_ci, double dprime_upper_ci) {
+	uint64_t h = hash(counts);
+	shard* s = &shards[h % n_shards];
+	entry* e = &(s->entries[(h / n_shards) % shard_size]);
+
+#ifdef _OPENMP
+	omp_set_lock(&s->lock);
+#endif
+	e->counts[0u] = counts[0u];
+	e->counts[1u] = counts[1u];
+	e->counts[2u] = counts[2u];
+	e->counts[3u] = counts[3u];
+	e->dprime_lower_ci = dprime_lower_ci;
+	e->dprime_upper_ci = dprime_upper_ci;
+#ifdef _OPENMP
+	omp_unset_lock(&s->lock);
+#endif
+}
+
+double CICache::get_n_lookups() {
+	uint64_t n_lookups = 0u;
+
+	for (unsigned int i = 0u; i < n_shards; ++i) {
+		n_lookups += shards[i].n_lookups;
+	}
+
+	return (double)n_lookups;
+}
+
+double CICache::get_n_hits() {
+	uint64_t n_hits = 0u;
+
+	for (unsigned int i = 0u; i < n_shards; ++i) {
+		n_hits += shards[i].n_hits;
+	}
+
+	return (double)n_hits;
+}
+
+double CICache::get_hit_rate() {
+	double n_lookups = get_n_lookups();
+
+	return n_lookups > 0.0 ? get_n_hits() / n_lookups : 0.0;
+}
+
+double CICache::get_memory_usage() {
+	return (n_shards * (sizeof(shard) + shard_size * sizeof(entry))) / 1048576.0;
+}
@@ -27,14 +27,20 @@ CIFactory::~CIFactory() {
 
 }
 
-CI* CIFactory::create(const char* method, unsigned int likelihood_density) throw (Exception) {
+CI* CIFactory::create(const char* method, unsigned int likelihood_density, CICache* cache, bool adaptive_likelihood) throw (Exception) {
+	CI* ci = NULL;
+
 	if (auxiliary::strcmp_ignore_case(method, CI::NONE) == 0) {
 		return new CI();
 	} else if (auxiliary::strcmp_ignore_case(method, CI::CI_WP) == 0) {
-		return new CIWP(likelihood_density);
+		ci = new CIWP(likelihood_density, adaptive_likelihood);
 	} else if (auxiliary::strcmp_ignore_case(method, CI::CI_AV) == 0) {
-		return new CIAV();
+		ci = new CIAV();
 	} else {
 		throw Exception(__FILE__, __LINE__, "Unknown D' CI computation method '%s' was specified.", method);
 	}
+
+	ci->set_cache(cache);
+
+	return ci;
 }
@@ -0,0 +1,56 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "include/CIRsq.h"
+
+CIRsq::CIRsq() : CI(),
+	weak_pair_rsq(0.5), strong_pair_rsq(0.8) {
+}
+
+CIRsq::~CIRsq() {
+
+}
+
+void CIRsq::set_pair_rsq(double weak_pair_rsq, double strong_pair_rsq) {
+	this->weak_pair_rsq = weak_pair_rsq;
+	this->strong_pair_rsq = strong_pair_rsq;
+}
+
+void CIRsq::classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception) {
+	classify_range_as<CIRsq>(marker_a, first_marker_b, n_markers_b, pair_classes);
+}
+
+unsigned int CIRsq::classify_bounded() {
+	double rsq = (observed_d * observed_d) / (observed_major_af_a * (1.0 - observed_major_af_a) * observed_major_af_b * (1.0 - observed_major_af_b));
+
+	if (isnan(rsq)) {
+		return PAIR_OTHER;
+	}
+
+	if (auxiliary::fcmp(rsq, strong_pair_rsq, EPSILON) >= 0) {
+		return PAIR_STRONG_LD;
+	}
+
+	if (auxiliary::fcmp(rsq, weak_pair_rsq, EPSILON) < 0) {
+		return PAIR_RECOMB;
+	}
+
+	return PAIR_OTHER;
+}
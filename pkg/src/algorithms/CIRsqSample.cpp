@@ -0,0 +1,116 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/CIRsqSample.h"
+
+CIRsqSample::CIRsqSample() : CIRsq(),
+	sample(NULL), sample_margin(0.0), sample_counts(NULL), n_sampled_pairs(0u), n_exact_pairs(0u) {
+}
+
+CIRsqSample::~CIRsqSample() {
+	sample = NULL;
+
+	free(sample_counts);
+	sample_counts = NULL;
+}
+
+void CIRsqSample::set_sample(const DbView* sample, double confidence) {
+	double fpc = 1.0 - (sample->n_haplotypes - 1.0) / db->n_haplotypes;
+
+	this->sample = sample;
+
+	/* P(|p - q| >= t) <= 2 exp(-2 n t^2 / (1 - (n - 1) / N)) for a sample of n out of N (Serfling, 1974) */
+	sample_margin = sqrt(fpc * log(2.0 / (1.0 - confidence)) / (2.0 * sample->n_haplotypes));
+
+	free(sample_counts);
+	sample_counts = NULL;
+}
+
+unsigned int CIRsqSample::classify_sampled(unsigned int marker_a, unsigned int marker_b, const unsigned int* cells) {
+	double minor_af_a = 1.0 - db->major_allele_freqs[marker_a];
+	double minor_af_b = 1.0 - db->major_allele_freqs[marker_b];
+	double expected = minor_af_a * minor_af_b;
+	double denominator = minor_af_a * (1.0 - minor_af_a) * minor_af_b * (1.0 - minor_af_b);
+
+	double frequency = cells[3u] / (double)sample->n_haplotypes;
+	double lower_d = 0.0;
+	double upper_d = 0.0;
+	double lower_rsq = 0.0;
+	double upper_rsq = 0.0;
+
+	if ((db->missing_haplotypes[marker_a] != NULL) || (db->missing_haplotypes[marker_b] != NULL) || (!(denominator > 0.0))) {
+		return PAIR_UNKNOWN;
+	}
+
+	/* D of the minor alleles; the frequency of the minor/minor haplotype is also bounded by the allele frequencies */
+	lower_d = max(frequency - sample_margin, max(0.0, minor_af_a + minor_af_b - 1.0)) - expected;
+	upper_d = min(frequency + sample_margin, min(minor_af_a, minor_af_b)) - expected;
+
+	if (lower_d > 0.0) {
+		lower_rsq = (lower_d * lower_d) / denominator;
+	} else if (upper_d < 0.0) {
+		lower_rsq = (upper_d * upper_d) / denominator;
+	}
+	upper_rsq = max(lower_d * lower_d, upper_d * upper_d) / denominator;
+
+	if (auxiliary::fcmp(lower_rsq, strong_pair_rsq, EPSILON) >= 0) {
+		return PAIR_STRONG_LD;
+	}
+
+	if (auxiliary::fcmp(upper_rsq, weak_pair_rsq, EPSILON) < 0) {
+		return PAIR_RECOMB;
+	}
+
+	if ((auxiliary::fcmp(lower_rsq, weak_pair_rsq, EPSILON) >= 0) && (auxiliary::fcmp(upper_rsq, strong_pair_rsq, EPSILON) < 0)) {
+		return PAIR_OTHER;
+	}
+
+	return PAIR_UNKNOWN;
+}
+
+void CIRsqSample::classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception) {
+	if (sample_counts == NULL) {
+		sample_counts = (unsigned int*)malloc(4u * db->n_markers * sizeof(unsigned int));
+		if (sample_counts == NULL) {
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+		}
+	}
+
+	PairCounter::count_range(sample, marker_a, first_marker_b, n_markers_b, sample_counts);
+
+	for (unsigned int b = 0u; b < n_markers_b; ++b) {
+		pair_classes[b] = classify_sampled(marker_a, first_marker_b + b, sample_counts + (b << 2));
+		if (pair_classes[b] == PAIR_UNKNOWN) {
+			count_haplotypes(marker_a, first_marker_b + b);
+			compute_observed_d();
+			pair_classes[b] = classify_counted_as<CIRsq>();
+			++n_exact_pairs;
+		}
+	}
+
+	n_sampled_pairs += n_markers_b;
+}
+
+unsigned long int CIRsqSample::get_n_sampled_pairs() {
+	return n_sampled_pairs;
+}
+
+unsigned long int CIRsqSample::get_n_exact_pairs() {
+	return n_exact_pairs;
+}
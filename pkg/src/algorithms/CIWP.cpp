@@ -19,16 +19,45 @@
 
 #include "include/CIWP.h"
 
-CIWP::CIWP(unsigned int likelihood_density) throw (Exception) : CI(),
-		generation_number(likelihood_density),
+const double CIWP::MIN_FREQ = 0.0000000001;
+const unsigned int CIWP::GRID_ALIGNMENT = 8u;
+const double CIWP::ADAPTIVE_LOG_MARGIN = 60.0;
+const double CIWP::BOUNDED_MARGIN = 0.5;
+
+/* Non-positive frequencies are clamped to min_freq: fcmp(x, 0.0, EPSILON) <= 0 holds exactly when x <= 0.0. */
+static inline double haplotype_log_likelihood(double dprime, double dmax, double major_af_a, double major_af_b, double major_af_ab,
+		double n_ref_a_ref_b, double n_ref_a_alt_b, double n_alt_a_ref_b, double n_alt_a_alt_b, double min_freq) {
+	double freq_ref_a_ref_b = dprime * dmax + major_af_ab;
+	double freq_ref_a_alt_b = major_af_a - freq_ref_a_ref_b;
+	double freq_alt_a_ref_b = major_af_b - freq_ref_a_ref_b;
+	double freq_alt_a_alt_b = (1 - major_af_a) - freq_alt_a_ref_b;
+
+	return n_ref_a_ref_b * auxiliary::log_simd(auxiliary::select_positive(freq_ref_a_ref_b, min_freq)) +
+			n_ref_a_alt_b * auxiliary::log_simd(auxiliary::select_positive(freq_ref_a_alt_b, min_freq)) +
+			n_alt_a_ref_b * auxiliary::log_simd(auxiliary::select_positive(freq_alt_a_ref_b, min_freq)) +
+			n_alt_a_alt_b * auxiliary::log_simd(auxiliary::select_positive(freq_alt_a_alt_b, min_freq));
+}
+
+static inline double point_log_likelihood(double dprime, double dmax, double major_af_a, double major_af_b, const double* counts, double min_freq) {
+	return haplotype_log_likelihood(dprime, dmax, major_af_a, major_af_b, major_af_a * major_af_b, counts[0u], counts[1u], counts[2u], counts[3u], min_freq);
+}
+
+CIWP::CIWP(unsigned int likelihood_density, bool adaptive) throw (Exception) : CI(),
+		generation_number(likelihood_density), grid_size(0u),
 		generated_dprime(NULL),
-		generated_freq_haplotype_ref_a_ref_b(0.0), generated_freq_haplotype_ref_a_alt_b(0.0), generated_freq_haplotype_alt_a_ref_b(0.0), generated_freq_haplotype_alt_a_alt_b(0.0),
+		adaptive(false), coarse_step(1u), coarse_size(0u), n_coarse(0u),
+		coarse_index(NULL), coarse_dprime(NULL), coarse_log_likelihood(NULL),
 		log_likelihood(NULL), max_log_likelihood(0.0),
-		posterior_dist(NULL), total_posterior_dist_area(0.0), tail_posterior_dist_area(0.0), covered_posterior_dist_area(0.0),
+		posterior_dist(NULL), total_posterior_dist_area(0.0), tail_posterior_dist_area(0.0),
+		n_ranges(0u),
 		tmp_n_observed_haplotype_ref_a_ref_b(0u), tmp_n_observed_haplotype_alt_a_alt_b(0u),
-		dmax(0.0) {
+		dmax(0.0),
+		strong_cl_i(0u), strong_cu_i(0u), recomb_cu_i(0u) {
 
-	generated_dprime = (double*)malloc((generation_number + 1u) * sizeof(double));
+	/* The grid is padded to a multiple of GRID_ALIGNMENT points (copies of the last point), so that the vectorized loops need no scalar remainder. */
+	grid_size = ((generation_number + GRID_ALIGNMENT) / GRID_ALIGNMENT) * GRID_ALIGNMENT;
+
+	generated_dprime = (double*)auxiliary::aligned_malloc(grid_size * sizeof(double), GRID_ALIGNMENT * sizeof(double));
 	if (generated_dprime == NULL) {
 		throw Exception(__FILE__, __LINE__, "Error in memory allocation");
 	}
@@ -37,63 +66,207 @@ CIWP::CIWP(unsigned int likelihood_density) throw (Exception) : CI(),
 		generated_dprime[i] = i / (double)generation_number;
 	}
 
-	posterior_dist = (double*)malloc((generation_number + 1u) * sizeof(double));
+	for (unsigned int i = generation_number + 1u; i < grid_size; ++i) {
+		generated_dprime[i] = generated_dprime[generation_number];
+	}
+
+	posterior_dist = (double*)auxiliary::aligned_malloc(grid_size * sizeof(double), GRID_ALIGNMENT * sizeof(double));
 	if (posterior_dist == NULL) {
 		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
 	}
 
-	log_likelihood = (double*)malloc((generation_number + 1u) * sizeof(double));
+	log_likelihood = (double*)auxiliary::aligned_malloc(grid_size * sizeof(double), GRID_ALIGNMENT * sizeof(double));
 	if (log_likelihood == NULL) {
 		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
 	}
+
+	/* coarse grid: multiples of coarse_step below generation_number and the point generation_number - 1, padded like the full grid */
+	coarse_step = (unsigned int)sqrt((double)generation_number);
+	if (coarse_step == 0u) {
+		coarse_step = 1u;
+	}
+
+	coarse_size = ((generation_number + coarse_step - 1u) / coarse_step) + 1u;
+	coarse_size = ((coarse_size + GRID_ALIGNMENT - 1u) / GRID_ALIGNMENT) * GRID_ALIGNMENT;
+
+	coarse_index = (unsigned int*)malloc(coarse_size * sizeof(unsigned int));
+	if (coarse_index == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	coarse_dprime = (double*)auxiliary::aligned_malloc(coarse_size * sizeof(double), GRID_ALIGNMENT * sizeof(double));
+	if (coarse_dprime == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	coarse_log_likelihood = (double*)auxiliary::aligned_malloc(coarse_size * sizeof(double), GRID_ALIGNMENT * sizeof(double));
+	if (coarse_log_likelihood == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	n_coarse = 0u;
+	for (unsigned int i = 0u; ; i = min(i + coarse_step, generation_number - 1u)) {
+		coarse_index[n_coarse++] = i;
+		if (i + 1u >= generation_number) {
+			break;
+		}
+	}
+
+	for (unsigned int i = 0u; i < coarse_size; ++i) {
+		coarse_dprime[i] = generated_dprime[coarse_index[i < n_coarse ? i : n_coarse - 1u]];
+	}
+
+	set_adaptive(adaptive);
+	set_pair_thresholds(pos_strong_pair_cl, pos_strong_pair_cu, pos_recomb_pair_cu);
 }
 
 CIWP::~CIWP() {
-	free(generated_dprime);
+	auxiliary::aligned_free(generated_dprime);
 	generated_dprime = NULL;
 
-	free(posterior_dist);
+	auxiliary::aligned_free(posterior_dist);
 	posterior_dist = NULL;
 
-	free(log_likelihood);
+	auxiliary::aligned_free(log_likelihood);
 	log_likelihood = NULL;
+
+	free(coarse_index);
+	coarse_index = NULL;
+
+	auxiliary::aligned_free(coarse_dprime);
+	coarse_dprime = NULL;
+
+	auxiliary::aligned_free(coarse_log_likelihood);
+	coarse_log_likelihood = NULL;
 }
 
-void CIWP::get_CI(unsigned int marker_a, unsigned int marker_b, double* dprime_lower_ci, double* dprime_upper_ci) {
-	observed_ref_allele_a = db->major_alleles[marker_a];
-	observed_alt_allele_a = db->minor_alleles[marker_a];
+void CIWP::set_adaptive(bool adaptive) {
+	this->adaptive = adaptive;
 
-	observed_ref_allele_b = db->major_alleles[marker_b];
-	observed_alt_allele_b = db->minor_alleles[marker_b];
+	n_ranges = 1u;
+	range_start[0u] = 0u;
+	range_end[0u] = grid_size;
+}
 
-	observed_major_af_a = db->major_allele_freqs[marker_a];
-	observed_major_af_b = db->major_allele_freqs[marker_b];
+void CIWP::set_pair_thresholds(double strong_pair_cl, double strong_pair_cu, double recomb_pair_cu) {
+	CI::set_pair_thresholds(strong_pair_cl, strong_pair_cu, recomb_pair_cu);
 
-	observed_haplotype_a = db->haplotypes[marker_a];
-	observed_haplotype_b = db->haplotypes[marker_b];
+	/* WP bounds lie in [0, 1], so only the positive strong LD case is decided */
+	strong_cl_i = generation_number + 1u;
+	for (unsigned int i = 0u; i <= generation_number; ++i) {
+		if (auxiliary::fcmp(generated_dprime[i], pos_strong_pair_cl, EPSILON) >= 0) {
+			strong_cl_i = i;
+			break;
+		}
+	}
 
-	n_observed_haplotype_ref_a_ref_b = n_observed_haplotype_ref_a_alt_b = n_observed_haplotype_alt_a_ref_b = n_observed_haplotype_alt_a_alt_b = 0u;
+	strong_cu_i = generation_number + 1u;
+	for (unsigned int i = 0u; i <= generation_number; ++i) {
+		if (auxiliary::fcmp(generated_dprime[i], pos_strong_pair_cu, EPSILON) >= 0) {
+			strong_cu_i = i;
+			break;
+		}
+	}
 
-	for (unsigned int i = 0u; i < db->n_haplotypes; ++i) {
-		observed_allele_a = observed_haplotype_a[i];
-		observed_allele_b = observed_haplotype_b[i];
-		if (observed_allele_a == observed_ref_allele_a) {
-			if (observed_allele_b == observed_ref_allele_b) {
-				++n_observed_haplotype_ref_a_ref_b;
-			} else if (observed_allele_b == observed_alt_allele_b) {
-				++n_observed_haplotype_ref_a_alt_b;
-			}
-		} else if (observed_allele_a == observed_alt_allele_a) {
-			if (observed_allele_b == observed_ref_allele_b) {
-				++n_observed_haplotype_alt_a_ref_b;
-			} else if (observed_allele_b == observed_alt_allele_b) {
-				++n_observed_haplotype_alt_a_alt_b;
+	/* classify_CI() tests strong LD first, so recombination is decided only where the upper bound rules out both strong LD cases */
+	recomb_cu_i = generation_number + 1u;
+	if ((auxiliary::fcmp(0.0, neg_recomb_pair_cu, EPSILON) >= 0) && (auxiliary::fcmp(0.0, neg_strong_pair_cu, EPSILON) > 0)) {
+		for (unsigned int i = generation_number + 1u; i > 0u; --i) {
+			if (auxiliary::fcmp(generated_dprime[i - 1u], pos_recomb_pair_cu, EPSILON) <= 0) {
+				recomb_cu_i = i - 1u;
+				break;
 			}
 		}
+
+		if (recomb_cu_i >= strong_cu_i) {
+			recomb_cu_i = generation_number + 1u;
+		}
+	}
+}
+
+void CIWP::classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception) {
+	classify_range_as<CIWP>(marker_a, first_marker_b, n_markers_b, pair_classes);
+}
+
+void CIWP::locate_ranges() {
+	unsigned int last_block = grid_size - GRID_ALIGNMENT;
+	unsigned int start = 0u, end = 0u;
+	unsigned int i = 0u, max_i = 0u;
+	double max_ll = -numeric_limits<double>::infinity();
+
+	/* coarse maximum over [0, generation_number - 1], where the log-likelihood is concave */
+	compute_log_likelihood(coarse_dprime, coarse_log_likelihood, 0u, coarse_size);
+
+	for (i = 0u; i < n_coarse; ++i) {
+		if (coarse_log_likelihood[i] > max_ll) {
+			max_ll = coarse_log_likelihood[i];
+			max_i = i;
+		}
+	}
+
+	/* The maximum lies between the coarse neighbours of max_i, so the log-likelihood only decreases beyond the first coarse points that fall below the margin. */
+	start = 0u;
+	for (i = max_i; i > 0u; --i) {
+		if (coarse_log_likelihood[i - 1u] < max_ll - ADAPTIVE_LOG_MARGIN) {
+			start = coarse_index[i - 1u];
+			break;
+		}
+	}
+
+	end = generation_number;
+	for (i = max_i + 1u; i < n_coarse; ++i) {
+		if (coarse_log_likelihood[i] < max_ll - ADAPTIVE_LOG_MARGIN) {
+			end = coarse_index[i] + 1u;
+			break;
+		}
+	}
+
+	start = start & ~(GRID_ALIGNMENT - 1u);
+	end = ((end + GRID_ALIGNMENT - 1u) / GRID_ALIGNMENT) * GRID_ALIGNMENT;
+
+	n_ranges = 1u;
+	range_start[0u] = start;
+	if (end >= last_block) {
+		range_end[0u] = grid_size;
+	} else {
+		/* the last grid point may be clamped (not concave), so its block is always evaluated */
+		range_end[0u] = end;
+		range_start[1u] = last_block;
+		range_end[1u] = grid_size;
+		++n_ranges;
 	}
+}
 
-	observed_d = (n_observed_haplotype_ref_a_ref_b / (double)(n_observed_haplotype_ref_a_ref_b + n_observed_haplotype_ref_a_alt_b + n_observed_haplotype_alt_a_ref_b + n_observed_haplotype_alt_a_alt_b)) - (observed_major_af_a * observed_major_af_b);
+double CIWP::compute_log_likelihood(const double* dprime, double* ll, unsigned int start, unsigned int end) {
+	/* locals instead of members, so that the grid loop carries no aliasing with this */
+	double local_dmax = dmax;
+	double major_af_a = observed_major_af_a;
+	double major_af_b = observed_major_af_b;
+	double major_af_ab = observed_major_af_a * observed_major_af_b;
+	double n_ref_a_ref_b = n_observed_haplotype_ref_a_ref_b;
+	double n_ref_a_alt_b = n_observed_haplotype_ref_a_alt_b;
+	double n_alt_a_ref_b = n_observed_haplotype_alt_a_ref_b;
+	double n_alt_a_alt_b = n_observed_haplotype_alt_a_alt_b;
+	double min_freq = MIN_FREQ;
+	double max_ll = -numeric_limits<double>::infinity();
+	/* ranges are aligned to GRID_ALIGNMENT, so the loops need no scalar remainder */
+	unsigned int n_points = (end - start) & ~(GRID_ALIGNMENT - 1u);
 
+	dprime += start;
+	ll += start;
+
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+	#pragma omp simd reduction(max:max_ll)
+#endif
+	for (unsigned int i = 0u; i < n_points; ++i) {
+		ll[i] = haplotype_log_likelihood(dprime[i], local_dmax, major_af_a, major_af_b, major_af_ab, n_ref_a_ref_b, n_ref_a_alt_b, n_alt_a_ref_b, n_alt_a_alt_b, min_freq);
+		max_ll = ll[i] > max_ll ? ll[i] : max_ll;
+	}
+
+	return max_ll;
+}
+
+void CIWP::compute_CI(double* dprime_lower_ci, double* dprime_upper_ci) {
 	switch (auxiliary::fcmp(observed_d, 0.0, EPSILON)) {
 		case -1:
 			tmp_n_observed_haplotype_ref_a_ref_b = n_observed_haplotype_ref_a_ref_b;
@@ -116,56 +289,178 @@ void CIWP::get_CI(unsigned int marker_a, unsigned int marker_b, double* dprime_l
 			return;
 	}
 
-	max_log_likelihood = -numeric_limits<double>::infinity();
-	total_posterior_dist_area = 0.0;
-	for (unsigned int i = 0u; i <= generation_number; i++) {
-		generated_freq_haplotype_ref_a_ref_b = generated_dprime[i] * dmax + observed_major_af_a * observed_major_af_b;
-		generated_freq_haplotype_ref_a_alt_b = observed_major_af_a - generated_freq_haplotype_ref_a_ref_b;
-		generated_freq_haplotype_alt_a_ref_b = observed_major_af_b - generated_freq_haplotype_ref_a_ref_b;
-		generated_freq_haplotype_alt_a_alt_b = (1 - observed_major_af_a) - generated_freq_haplotype_alt_a_ref_b;
+	const double* posterior = posterior_dist;
+	double max_ll = -numeric_limits<double>::infinity();
+	double range_max_ll = 0.0;
+	unsigned int end = 0u;
 
-		log_likelihood[i] =
-				n_observed_haplotype_ref_a_ref_b * log10(auxiliary::fcmp(generated_freq_haplotype_ref_a_ref_b, 0.0, EPSILON) <= 0 ? 0.0000000001 : generated_freq_haplotype_ref_a_ref_b) +
-				n_observed_haplotype_ref_a_alt_b * log10(auxiliary::fcmp(generated_freq_haplotype_ref_a_alt_b, 0.0, EPSILON) <= 0 ? 0.0000000001 : generated_freq_haplotype_ref_a_alt_b) +
-				n_observed_haplotype_alt_a_ref_b * log10(auxiliary::fcmp(generated_freq_haplotype_alt_a_ref_b, 0.0, EPSILON) <= 0 ? 0.0000000001 : generated_freq_haplotype_alt_a_ref_b) +
-				n_observed_haplotype_alt_a_alt_b * log10(auxiliary::fcmp(generated_freq_haplotype_alt_a_alt_b, 0.0, EPSILON) <= 0 ? 0.0000000001 : generated_freq_haplotype_alt_a_alt_b);
+	unsigned int lower_i = generation_number + 1u;
+	unsigned int upper_i = generation_number + 1u;
+	double covered_lower_area = 0.0;
+	double covered_upper_area = 0.0;
 
-		if (log_likelihood[i] > max_log_likelihood) {
-			max_log_likelihood = log_likelihood[i];
+	if (adaptive) {
+		locate_ranges();
+	}
+
+	for (unsigned int r = 0u; r < n_ranges; ++r) {
+		range_max_ll = compute_log_likelihood(generated_dprime, log_likelihood, range_start[r], range_end[r]);
+		if (range_max_ll > max_ll) {
+			max_ll = range_max_ll;
 		}
 	}
 
-	for (unsigned int i = 0u; i <= generation_number; i++) {
-		log_likelihood[i] -= max_log_likelihood;
-		posterior_dist[i] = pow(10.0, log_likelihood[i]);
-		total_posterior_dist_area += posterior_dist[i];
+	for (unsigned int r = 0u; r < n_ranges; ++r) {
+		const double* range_ll = log_likelihood + range_start[r];
+		double* range_posterior = posterior_dist + range_start[r];
+		unsigned int n_points = (range_end[r] - range_start[r]) & ~(GRID_ALIGNMENT - 1u);
+
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+		#pragma omp simd
+#endif
+		for (unsigned int i = 0u; i < n_points; ++i) {
+			range_posterior[i] = auxiliary::exp_simd(range_ll[i] - max_ll);
+		}
+	}
+
+	max_log_likelihood = max_ll;
+
+	/* Summed sequentially in the same order as the tail scans below. The skipped points have zero posterior and would not change the sums. */
+	total_posterior_dist_area = 0.0;
+	for (unsigned int r = 0u; r < n_ranges; ++r) {
+		end = min(range_end[r], generation_number + 1u);
+		for (unsigned int i = range_start[r]; i < end; ++i) {
+			total_posterior_dist_area += posterior[i];
+		}
 	}
 
 	tail_posterior_dist_area = 0.05 * total_posterior_dist_area;
 
-	covered_posterior_dist_area = 0.0;
-	for (unsigned int i = 0u; i <= generation_number; i++) {
-		covered_posterior_dist_area += posterior_dist[i];
-		if (covered_posterior_dist_area > tail_posterior_dist_area) {
-			if (i != 0u) {
-				*dprime_lower_ci = generated_dprime[i - 1u];
-			} else {
-				*dprime_lower_ci = generated_dprime[0u];
+	for (unsigned int r = 0u; (r < n_ranges) && (lower_i > generation_number); ++r) {
+		end = min(range_end[r], generation_number + 1u);
+		for (unsigned int i = range_start[r]; i < end; ++i) {
+			covered_lower_area += posterior[i];
+			if (covered_lower_area > tail_posterior_dist_area) {
+				lower_i = i;
+				break;
 			}
-			break;
 		}
 	}
 
-	covered_posterior_dist_area = 0.0;
-	for (unsigned int i = generation_number; i >= 0u; i--) {
-		covered_posterior_dist_area += posterior_dist[i];
-		if (covered_posterior_dist_area > tail_posterior_dist_area) {
-			if (i != generation_number) {
-				*dprime_upper_ci =  generated_dprime[i + 1u];
-			} else {
-				*dprime_upper_ci =  generated_dprime[generation_number];
+	for (unsigned int r = n_ranges; (r > 0u) && (upper_i > generation_number); --r) {
+		end = min(range_end[r - 1u], generation_number + 1u);
+		for (unsigned int j = end; j > range_start[r - 1u]; --j) {
+			covered_upper_area += posterior[j - 1u];
+			if (covered_upper_area > tail_posterior_dist_area) {
+				upper_i = j - 1u;
+				break;
 			}
+		}
+	}
+
+	*dprime_lower_ci = generated_dprime[lower_i != 0u ? lower_i - 1u : 0u];
+	*dprime_upper_ci = generated_dprime[upper_i != generation_number ? upper_i + 1u : generation_number];
+}
+
+unsigned int CIWP::classify_bounded() {
+	/* counts oriented as in compute_CI(), so that D > 0 */
+	double counts[4];
+	double major_af_b = observed_major_af_b;
+	double d = 0.0;
+	double local_dmax = 0.0;
+	double dprime = 0.0;
+
+	/* a tail is at most 5% of the total area if it is at most 5/95 of the posterior at the point estimate, and vice versa */
+	double tail_ratio = BOUNDED_MARGIN * (0.05 / 0.95);
+	double body_ratio = BOUNDED_MARGIN * (0.95 / 0.05);
+
+	unsigned int m = 0u;
+	double ll_m = 0.0;
+	double ll_i = 0.0;
+	double bound = 0.0;
+
+	bool strong_lower = false;
+	bool strong_upper = false;
+
+	switch (auxiliary::fcmp(observed_d, 0.0, EPSILON)) {
+		case -1:
+			counts[0u] = n_observed_haplotype_ref_a_alt_b;
+			counts[1u] = n_observed_haplotype_ref_a_ref_b;
+			counts[2u] = n_observed_haplotype_alt_a_alt_b;
+			counts[3u] = n_observed_haplotype_alt_a_ref_b;
+			major_af_b = 1.0 - major_af_b;
+			d = (counts[0u] / (counts[0u] + counts[1u] + counts[2u] + counts[3u])) - (observed_major_af_a * major_af_b);
 			break;
+		case 1:
+			counts[0u] = n_observed_haplotype_ref_a_ref_b;
+			counts[1u] = n_observed_haplotype_ref_a_alt_b;
+			counts[2u] = n_observed_haplotype_alt_a_ref_b;
+			counts[3u] = n_observed_haplotype_alt_a_alt_b;
+			d = observed_d;
+			break;
+		default:
+			/* compute_CI() gives NaN bounds */
+			return PAIR_OTHER;
+	}
+
+	if (generation_number < 2u) {
+		return PAIR_UNKNOWN;
+	}
+
+	local_dmax = min(observed_major_af_a * (1 - major_af_b), (1 - observed_major_af_a) * major_af_b);
+
+	/* the log-likelihood is concave on the grid points [0, generation_number - 1], so m is taken from there */
+	dprime = d / local_dmax;
+	if (dprime > 0.0) {
+		m = (unsigned int)min(dprime * generation_number + 0.5, (double)(generation_number - 1u));
+	}
+
+	ll_m = point_log_likelihood(generated_dprime[m], local_dmax, observed_major_af_a, major_af_b, counts, MIN_FREQ);
+
+	/* Strong LD. lower CI >= D'[strong_cl_i] iff the area of [0, strong_cl_i] is within the 5% tail. */
+	if (strong_cl_i == 0u) {
+		strong_lower = true;
+	} else if (strong_cl_i < m) {
+		ll_i = point_log_likelihood(generated_dprime[strong_cl_i], local_dmax, observed_major_af_a, major_af_b, counts, MIN_FREQ);
+		if (ll_i <= ll_m) {
+			bound = (strong_cl_i + 1u) * exp(ll_i - ll_m);
+			strong_lower = bound <= tail_ratio;
+		}
+	}
+
+	/* upper CI >= D'[strong_cu_i] iff the area of [strong_cu_i - 1, generation_number] exceeds the 5% tail */
+	if (strong_lower) {
+		if (strong_cu_i <= 1u) {
+			strong_upper = true;
+		} else if ((strong_cu_i <= generation_number) && (strong_cu_i - 2u < m)) {
+			ll_i = point_log_likelihood(generated_dprime[strong_cu_i - 2u], local_dmax, observed_major_af_a, major_af_b, counts, MIN_FREQ);
+			if (ll_i <= ll_m) {
+				bound = (strong_cu_i - 1u) * exp(ll_i - ll_m);
+				strong_upper = bound <= body_ratio;
+			}
+		}
+
+		if (strong_upper) {
+			return PAIR_STRONG_LD;
 		}
 	}
+
+	/* Recombination. upper CI <= D'[recomb_cu_i] iff the area of [recomb_cu_i, generation_number] is within the 5% tail. */
+	if (recomb_cu_i == generation_number) {
+		return PAIR_RECOMB;
+	}
+
+	if ((recomb_cu_i > m) && (recomb_cu_i < generation_number)) {
+		ll_i = point_log_likelihood(generated_dprime[recomb_cu_i], local_dmax, observed_major_af_a, major_af_b, counts, MIN_FREQ);
+		if (ll_i <= ll_m) {
+			/* the last grid point may be clamped (not concave), so it is bounded on its own */
+			bound = (generation_number - recomb_cu_i) * exp(ll_i - ll_m);
+			bound += exp(point_log_likelihood(generated_dprime[generation_number], local_dmax, observed_major_af_a, major_af_b, counts, MIN_FREQ) - ll_m);
+			if (bound <= tail_ratio) {
+				return PAIR_RECOMB;
+			}
+		}
+	}
+
+	return PAIR_UNKNOWN;
 }
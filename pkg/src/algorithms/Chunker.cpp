@@ -0,0 +1,228 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "include/Chunker.h"
+
+const unsigned int Chunker::DEFAULT_BAND = 100u;
+
+Chunker::Chunker(unsigned int band) : db(NULL), ci(NULL), band(band), pair_classes(NULL) {
+
+}
+
+Chunker::~Chunker() {
+	db = NULL;
+	ci = NULL;
+
+	free(pair_classes);
+	pair_classes = NULL;
+}
+
+void Chunker::set_dbview(const DbView* db) {
+	this->db = db;
+}
+
+void Chunker::set_ci(CI* ci) {
+	this->ci = ci;
+}
+
+bool Chunker::is_split(unsigned int marker, unsigned int* next_marker) throw (Exception) {
+	unsigned int first_a = marker + 1u > band ? marker + 1u - band : 0u;
+	unsigned int last_b = marker + band < db->n_markers - 1u ? marker + band : db->n_markers - 1u;
+
+	/* markers at the same position cannot be separated by the views of the chunks */
+	if (db->positions[marker] == db->positions[marker + 1u]) {
+		*next_marker = marker + 1u;
+		return false;
+	}
+
+	for (unsigned int b = marker + 1u; b <= last_b; ++b) {
+		ci->classify_range(b, first_a, marker + 1u - first_a, pair_classes);
+		for (unsigned int a = first_a; a <= marker; ++a) {
+			if (pair_classes[a - first_a] == CI::PAIR_STRONG_LD) {
+				/* (a, b) lies within the band of every split before min(b, a + band) */
+				*next_marker = b < a + band ? b : a + band;
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void Chunker::find_chunks(unsigned int min_chunk_size) throw (Exception) {
+	unsigned int marker = 0u;
+	unsigned int next_marker = 0u;
+
+	chunk_starts.clear();
+	chunk_starts.push_back(0u);
+
+	if (min_chunk_size < 2u) {
+		min_chunk_size = 2u;
+	}
+
+	if (pair_classes == NULL) {
+		pair_classes = (unsigned int*)malloc(band * sizeof(unsigned int));
+		if (pair_classes == NULL) {
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+		}
+	}
+
+	marker = min_chunk_size - 1u;
+	while (marker + min_chunk_size < db->n_markers) {
+		if (is_split(marker, &next_marker)) {
+			chunk_starts.push_back(marker + 1u);
+			marker += min_chunk_size;
+		} else {
+			marker = next_marker;
+		}
+	}
+}
+
+unsigned int Chunker::get_n_chunks() {
+	return (unsigned int)chunk_starts.size();
+}
+
+unsigned int Chunker::get_chunk_start(unsigned int chunk) {
+	return chunk_starts.at(chunk);
+}
+
+unsigned int Chunker::get_chunk_end(unsigned int chunk) {
+	return chunk + 1u < chunk_starts.size() ? chunk_starts.at(chunk + 1u) - 1u : db->n_markers - 1u;
+}
+
+const DbView* Chunker::create_chunk_view(Db* full_db, unsigned int chunk) throw (Exception) {
+	const DbView* chunk_db = NULL;
+
+	unsigned int start = get_chunk_start(chunk);
+	unsigned int end = get_chunk_end(chunk);
+
+	chunk_db = full_db->create_view(db->maf_threshold,
+			chunk == 0u ? db->start_position : db->positions[start],
+			chunk + 1u == chunk_starts.size() ? db->end_position : db->positions[end]);
+
+	if ((chunk_db == NULL) || (chunk_db->n_markers != end - start + 1u) ||
+			(chunk_db->positions[0u] != db->positions[start]) || (chunk_db->positions[chunk_db->n_markers - 1u] != db->positions[end])) {
+		throw Exception(__FILE__, __LINE__, "The markers of chunk %u do not match the markers %u-%u of the region.", chunk, start, end);
+	}
+
+	return chunk_db;
+}
+
+Partition* Chunker::stitch(vector<Partition*>& partitions) throw (Exception) {
+	Partition* partition = NULL;
+
+	chunk_block* blocks = NULL;
+	unsigned int n_blocks = 0u;
+
+	unsigned int offset = 0u;
+	unsigned int start = 0u;
+	unsigned int end = 0u;
+
+	if (partitions.size() != chunk_starts.size()) {
+		throw Exception(__FILE__, __LINE__, "The number of partitions (%u) does not match the number of chunks (%u).", (unsigned int)partitions.size(), (unsigned int)chunk_starts.size());
+	}
+
+	for (unsigned int c = 0u; c < partitions.size(); ++c) {
+		n_blocks += partitions.at(c)->get_n_blocks();
+	}
+
+	blocks = (chunk_block*)malloc((n_blocks > 0u ? n_blocks : 1u) * sizeof(chunk_block));
+	if (blocks == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	n_blocks = 0u;
+	for (unsigned int c = 0u; c < partitions.size(); ++c) {
+		offset = chunk_starts.at(c);
+		for (unsigned int b = 0u; b < partitions.at(c)->get_n_blocks(); ++b) {
+			partitions.at(c)->get_block(b, &start, &end);
+
+			blocks[n_blocks].start = start + offset;
+			blocks[n_blocks].end = end + offset;
+			blocks[n_blocks].length_bp = db->positions[end + offset] - db->positions[start + offset];
+
+			++n_blocks;
+		}
+	}
+
+	/* selected blocks of Algorithm::get_block_partition() come by descending length in base-pairs, ties by ascending start */
+	qsort(blocks, n_blocks, sizeof(chunk_block), chunk_blocks_cmp);
+
+	try {
+		partition = new Partition(db);
+
+		partition->rsq_blocks = partitions.at(0u)->rsq_blocks;
+		partition->ci_method = partitions.at(0u)->ci_method;
+		partition->likelihood_density = partitions.at(0u)->likelihood_density;
+		partition->strong_pair_cl = partitions.at(0u)->strong_pair_cl;
+		partition->strong_pair_cu = partitions.at(0u)->strong_pair_cu;
+		partition->recomb_pair_cu = partitions.at(0u)->recomb_pair_cu;
+		partition->weak_pair_rsq = partitions.at(0u)->weak_pair_rsq;
+		partition->strong_pair_rsq = partitions.at(0u)->strong_pair_rsq;
+		partition->strong_pairs_fraction = partitions.at(0u)->strong_pairs_fraction;
+		partition->pruning_method = partitions.at(0u)->pruning_method;
+		partition->window = partitions.at(0u)->window;
+		partition->auto_window = partitions.at(0u)->auto_window;
+		partition->max_span_bp = partitions.at(0u)->max_span_bp;
+		partition->max_span_markers = partitions.at(0u)->max_span_markers;
+		partition->chunk_band = band;
+		partition->n_chunks = chunk_starts.size();
+
+		/* the stitched partition reached only the smallest window of its provisional chunks */
+		for (unsigned int c = 0u; c < partitions.size(); ++c) {
+			if (partitions.at(c)->provisional) {
+				if ((!partition->provisional) || (partitions.at(c)->reached_window < partition->reached_window)) {
+					partition->reached_window = partitions.at(c)->reached_window;
+				}
+				partition->provisional = true;
+			}
+		}
+
+		for (unsigned int b = 0u; b < n_blocks; ++b) {
+			partition->add_block(blocks[b].start, blocks[b].end);
+		}
+	} catch (Exception &e) {
+		free(blocks);
+		blocks = NULL;
+
+		delete partition;
+		partition = NULL;
+
+		throw;
+	}
+
+	free(blocks);
+	blocks = NULL;
+
+	return partition;
+}
+
+int Chunker::chunk_blocks_cmp(const void* first, const void* second) {
+	chunk_block* first_block = (chunk_block*)first;
+	chunk_block* second_block = (chunk_block*)second;
+
+	if (first_block->length_bp > second_block->length_bp) {
+		return -1;
+	} else if (first_block->length_bp < second_block->length_bp) {
+		return 1;
+	} else {
+		return first_block->start - second_block->start;
+	}
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/ColumnGroups.h"
+
+ColumnGroups::ColumnGroups(const DbView* db) throw (Exception) : db(db), view(NULL), n_groups(0u), groups(NULL), representatives(NULL) {
+	column* columns = NULL;
+
+	unsigned int first = 0u;
+	unsigned int last = 0u;
+
+	groups = (unsigned int*)malloc(db->n_markers * sizeof(unsigned int));
+	representatives = (unsigned int*)malloc(db->n_markers * sizeof(unsigned int));
+	columns = (column*)malloc(db->n_markers * sizeof(column));
+	if ((groups == NULL) || (representatives == NULL) || (columns == NULL)) {
+		free(groups);
+		groups = NULL;
+
+		free(representatives);
+		representatives = NULL;
+
+		free(columns);
+		columns = NULL;
+
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	for (unsigned int i = 0u; i < db->n_markers; ++i) {
+		columns[i].hash = hash_column(i);
+		columns[i].marker = i;
+	}
+
+	qsort(columns, db->n_markers, sizeof(column), compare_columns);
+
+	/* within a run of equal hashes the markers are increasing, so every marker is compared with the groups started before it */
+	for (first = 0u; first < db->n_markers; first = last) {
+		for (last = first + 1u; (last < db->n_markers) && (columns[last].hash == columns[first].hash); ++last);
+
+		for (unsigned int i = first; i < last; ++i) {
+			groups[columns[i].marker] = columns[i].marker;
+			for (unsigned int k = first; k < i; ++k) {
+				if ((groups[columns[k].marker] == columns[k].marker) && (is_same_column(columns[k].marker, columns[i].marker))) {
+					groups[columns[i].marker] = columns[k].marker;
+					break;
+				}
+			}
+		}
+	}
+
+	free(columns);
+	columns = NULL;
+
+	/* groups[i] is the first marker of the group; it becomes the index of that marker in the view */
+	for (unsigned int i = 0u; i < db->n_markers; ++i) {
+		if (groups[i] == i) {
+			representatives[n_groups] = i;
+			groups[i] = n_groups++;
+		} else {
+			groups[i] = groups[groups[i]];
+		}
+	}
+
+	try {
+		view = db->create_subview(representatives, n_groups);
+	} catch (Exception &e) {
+		free(groups);
+		groups = NULL;
+
+		free(representatives);
+		representatives = NULL;
+
+		throw;
+	}
+}
+
+ColumnGroups::~ColumnGroups() {
+	delete view;
+	view = NULL;
+
+	free(groups);
+	groups = NULL;
+
+	free(representatives);
+	representatives = NULL;
+
+	db = NULL;
+}
+
+uint64_t ColumnGroups::hash_column(unsigned int marker) {
+	const uint64_t* minor = db->minor_haplotypes[marker];
+	const uint64_t* missing = db->missing_haplotypes[marker];
+	uint64_t hash = 14695981039346656037ULL;
+
+	/* FNV-1a over the words */
+	for (unsigned int w = 0u; w < db->n_haplotype_words; ++w) {
+		hash = (hash ^ minor[w]) * 1099511628211ULL;
+	}
+
+	if (missing != NULL) {
+		for (unsigned int w = 0u; w < db->n_haplotype_words; ++w) {
+			hash = (hash ^ missing[w]) * 1099511628211ULL;
+		}
+	}
+
+	return hash;
+}
+
+bool ColumnGroups::is_same_column(unsigned int marker_a, unsigned int marker_b) {
+	const uint64_t* missing_a = db->missing_haplotypes[marker_a];
+	const uint64_t* missing_b = db->missing_haplotypes[marker_b];
+
+	if (memcmp(db->minor_haplotypes[marker_a], db->minor_haplotypes[marker_b], db->n_haplotype_words * sizeof(uint64_t)) != 0) {
+		return false;
+	}
+
+	if ((missing_a == NULL) || (missing_b == NULL)) {
+		return missing_a == missing_b;
+	}
+
+	return memcmp(missing_a, missing_b, db->n_haplotype_words * sizeof(uint64_t)) == 0;
+}
+
+int ColumnGroups::compare_columns(const void* first, const void* second) {
+	const column* first_column = (const column*)first;
+	const column* second_column = (const column*)second;
+
+	if (first_column->hash != second_column->hash) {
+		return first_column->hash < second_column->hash ? -1 : 1;
+	}
+
+	if (first_column->marker != second_column->marker) {
+		return first_column->marker < second_column->marker ? -1 : 1;
+	}
+
+	return 0;
+}
+
+const DbView* ColumnGroups::get_view() {
+	return view;
+}
+
+unsigned int ColumnGroups::get_n_groups() {
+	return n_groups;
+}
+
+unsigned int ColumnGroups::get_first_group(unsigned int marker) {
+	unsigned int first = 0u, last = n_groups;
+	unsigned int middle = 0u;
+
+	while (first < last) {
+		middle = first + (last - first) / 2u;
+		if (representatives[middle] < marker) {
+			first = middle + 1u;
+		} else {
+			last = middle;
+		}
+	}
+
+	return first;
+}
+
+double ColumnGroups::get_memory_usage() {
+	double memory_usage = 0.0;
+
+	memory_usage += (2u * db->n_markers * sizeof(unsigned int)) / 1048576.0;
+	if (view != NULL) {
+		memory_usage += view->get_memory_usage();
+	}
+
+	return memory_usage;
+}
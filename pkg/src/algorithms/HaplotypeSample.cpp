@@ -0,0 +1,135 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/HaplotypeSample.h"
+
+HaplotypeSample::HaplotypeSample(const DbView* db, unsigned int n_haplotypes, uint64_t seed) throw (Exception) : db(db), view(NULL), bitplanes(NULL) {
+	unsigned int* haplotypes = NULL;
+	unsigned int* markers = NULL;
+
+	/* same aligned stride as the bitplanes of Db, which the pair counting kernels rely on */
+	unsigned int n_words = ((((n_haplotypes + 63u) >> 6) + Db::HAPLOTYPE_WORDS_ALIGNMENT - 1u) / Db::HAPLOTYPE_WORDS_ALIGNMENT) * Db::HAPLOTYPE_WORDS_ALIGNMENT;
+	unsigned int n_selected = 0u;
+	uint64_t state = seed;
+	const uint64_t* minor = NULL;
+	uint64_t* sample_minor = NULL;
+
+	haplotypes = (unsigned int*)malloc(n_haplotypes * sizeof(unsigned int));
+	markers = (unsigned int*)malloc(db->n_markers * sizeof(unsigned int));
+	bitplanes = (uint64_t*)auxiliary::aligned_malloc((size_t)db->n_markers * n_words * sizeof(uint64_t), Db::HAPLOTYPE_WORDS_ALIGNMENT * sizeof(uint64_t));
+	if ((haplotypes == NULL) || (markers == NULL) || (bitplanes == NULL)) {
+		free(haplotypes);
+		haplotypes = NULL;
+
+		free(markers);
+		markers = NULL;
+
+		auxiliary::aligned_free(bitplanes);
+		bitplanes = NULL;
+
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	/* selection sampling (Knuth's Algorithm S): every subset of n_haplotypes is equally likely, and the haplotypes come out in order */
+	for (unsigned int h = 0u; (h < db->n_haplotypes) && (n_selected < n_haplotypes); ++h) {
+		if ((db->n_haplotypes - h) * ((auxiliary::next_random(&state) >> 11) * (1.0 / 9007199254740992.0)) < n_haplotypes - n_selected) {
+			haplotypes[n_selected++] = h;
+		}
+	}
+
+	memset(bitplanes, 0, (size_t)db->n_markers * n_words * sizeof(uint64_t));
+
+	for (unsigned int i = 0u; i < db->n_markers; ++i) {
+		markers[i] = i;
+	}
+
+	try {
+		view = db->create_subview(markers, db->n_markers);
+	} catch (Exception &e) {
+		free(haplotypes);
+		haplotypes = NULL;
+
+		free(markers);
+		markers = NULL;
+
+		auxiliary::aligned_free(bitplanes);
+		bitplanes = NULL;
+
+		throw;
+	}
+
+	view->n_haplotypes = n_haplotypes;
+	view->n_haplotype_words = n_words;
+	view->haplotypes = NULL;
+	view->haplotype_mask = NULL;
+
+	/* in a view of a subset of the haplotypes, the sampled haplotypes are mapped to the Db bitplanes */
+	if (db->haplotypes != NULL) {
+		for (unsigned int k = 0u; k < n_haplotypes; ++k) {
+			haplotypes[k] = db->haplotypes[haplotypes[k]];
+		}
+	}
+
+	for (unsigned int i = 0u; i < db->n_markers; ++i) {
+		minor = db->minor_haplotypes[i];
+		sample_minor = bitplanes + (size_t)i * n_words;
+
+		for (unsigned int k = 0u; k < n_haplotypes; ++k) {
+			sample_minor[k >> 6] |= ((minor[haplotypes[k] >> 6] >> (haplotypes[k] & 63u)) & 1u) << (k & 63u);
+		}
+
+		view->minor_haplotypes[i] = sample_minor;
+		view->missing_haplotypes[i] = NULL;
+		view->n_minor_alleles[i] = 0u;
+		for (unsigned int w = 0u; w < n_words; ++w) {
+			view->n_minor_alleles[i] += auxiliary::popcount(sample_minor[w]);
+		}
+	}
+
+	free(haplotypes);
+	haplotypes = NULL;
+
+	free(markers);
+	markers = NULL;
+}
+
+HaplotypeSample::~HaplotypeSample() {
+	delete view;
+	view = NULL;
+
+	auxiliary::aligned_free(bitplanes);
+	bitplanes = NULL;
+
+	db = NULL;
+}
+
+const DbView* HaplotypeSample::get_view() {
+	return view;
+}
+
+double HaplotypeSample::get_memory_usage() {
+	double memory_usage = 0.0;
+
+	if (view != NULL) {
+		memory_usage += ((double)view->n_markers * view->n_haplotype_words * sizeof(uint64_t)) / 1048576.0;
+		memory_usage += view->get_memory_usage();
+	}
+
+	return memory_usage;
+}
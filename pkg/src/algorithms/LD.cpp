@@ -151,6 +151,7 @@ void LD::index_db_markers() throw (Exception) {
 void LD::compute_ld(const char* output_file_name, const char* coefficient, unsigned int window, bool gzip) throw (Exception) {
 	Writer* writer = NULL;
 	CI* ci = NULL;
+	CI::pair_stats stats;
 
 	marker_index_entry query_marker;
 	unsigned long int window_start = 0ul;
@@ -186,7 +187,8 @@ void LD::compute_ld(const char* output_file_name, const char* coefficient, unsig
 					while ((--i >= 0) && (db->positions[i] >= window_start));
 
 					while ((++i < db->n_markers) && (db->positions[i] <= window_end)) {
-						writer->write("%s\t%lu\t%s\t%lu\t%.5f\n", db->markers[location], db->positions[location], db->markers[i], db->positions[i], ci->get_D(location, i));
+						ci->get_stats(location, i, &stats, false);
+						writer->write("%s\t%lu\t%s\t%lu\t%.5f\n", db->markers[location], db->positions[location], db->markers[i], db->positions[i], stats.d);
 					}
 				} else if (variants_it->name != NULL) {
 					query_marker.marker = variants_it->name;
@@ -202,7 +204,8 @@ void LD::compute_ld(const char* output_file_name, const char* coefficient, unsig
 						while ((--i >= 0) && (db->positions[i] >= window_start));
 
 						while ((++i < db->n_markers) && (db->positions[i] <= window_end)) {
-							writer->write("%s\t%lu\t%s\t%lu\t%.5f\n", db->markers[start_location], db->positions[start_location], db->markers[i], db->positions[i], ci->get_D(start_location, i));
+							ci->get_stats(start_location, i, &stats, false);
+							writer->write("%s\t%lu\t%s\t%lu\t%.5f\n", db->markers[start_location], db->positions[start_location], db->markers[i], db->positions[i], stats.d);
 						}
 
 						++start_location;
@@ -225,7 +228,8 @@ void LD::compute_ld(const char* output_file_name, const char* coefficient, unsig
 					while ((--i >= 0) && (db->positions[i] >= window_start));
 
 					while ((++i < db->n_markers) && (db->positions[i] <= window_end)) {
-						writer->write("%s\t%lu\t%s\t%lu\t%.5f\n", db->markers[location], db->positions[location], db->markers[i], db->positions[i], ci->get_Dprime(location, i));
+						ci->get_stats(location, i, &stats, false);
+						writer->write("%s\t%lu\t%s\t%lu\t%.5f\n", db->markers[location], db->positions[location], db->markers[i], db->positions[i], stats.dprime);
 					}
 				} else if (variants_it->name != NULL) {
 					query_marker.marker = variants_it->name;
@@ -241,7 +245,8 @@ void LD::compute_ld(const char* output_file_name, const char* coefficient, unsig
 						while ((--i >= 0) && (db->positions[i] >= window_start));
 
 						while ((++i < db->n_markers) && (db->positions[i] <= window_end)) {
-							writer->write("%s\t%lu\t%s\t%lu\t%.5f\n", db->markers[start_location], db->positions[start_location], db->markers[i], db->positions[i], ci->get_Dprime(start_location, i));
+							ci->get_stats(start_location, i, &stats, false);
+							writer->write("%s\t%lu\t%s\t%lu\t%.5f\n", db->markers[start_location], db->positions[start_location], db->markers[i], db->positions[i], stats.dprime);
 						}
 
 						++start_location;
@@ -264,7 +269,8 @@ void LD::compute_ld(const char* output_file_name, const char* coefficient, unsig
 					while ((--i >= 0) && (db->positions[i] >= window_start));
 
 					while ((++i < db->n_markers) && (db->positions[i] <= window_end)) {
-						writer->write("%s\t%lu\t%s\t%lu\t%.5f\n", db->markers[location], db->positions[location], db->markers[i], db->positions[i], pow(ci->get_r(location, i), 2.0));
+						ci->get_stats(location, i, &stats, false);
+						writer->write("%s\t%lu\t%s\t%lu\t%.5f\n", db->markers[location], db->positions[location], db->markers[i], db->positions[i], stats.rsq);
 					}
 				} else if (variants_it->name != NULL) {
 					query_marker.marker = variants_it->name;
@@ -280,7 +286,8 @@ void LD::compute_ld(const char* output_file_name, const char* coefficient, unsig
 						while ((--i >= 0) && (db->positions[i] >= window_start));
 
 						while ((++i < db->n_markers) && (db->positions[i] <= window_end)) {
-							writer->write("%s\t%lu\t%s\t%lu\t%.5f\n", db->markers[start_location], db->positions[start_location], db->markers[i], db->positions[i], pow(ci->get_r(start_location, i), 2.0));
+							ci->get_stats(start_location, i, &stats, false);
+							writer->write("%s\t%lu\t%s\t%lu\t%.5f\n", db->markers[start_location], db->positions[start_location], db->markers[i], db->positions[i], stats.rsq);
 						}
 
 						++start_location;
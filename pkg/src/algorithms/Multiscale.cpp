@@ -0,0 +1,389 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/Multiscale.h"
+
+const unsigned int Multiscale::DEFAULT_MARGIN = 1u;
+const unsigned int Multiscale::CLASS_CACHE_BAND = 4096u;
+const double Multiscale::EPSILON = 0.000000001;
+
+Multiscale::Multiscale(unsigned int thin_step, double thin_maf, unsigned int margin) : db(NULL),
+		thin_step(thin_step > 0u ? thin_step : 1u), thin_maf(thin_maf), margin(margin),
+		thinned_markers(NULL), n_thinned_markers(0u), thinned_db(NULL), n_rejected_blocks(0u), n_calculations(0u) {
+
+}
+
+Multiscale::~Multiscale() {
+	free(thinned_markers);
+	thinned_markers = NULL;
+
+	delete thinned_db;
+	thinned_db = NULL;
+
+	for (unsigned int r = 0u; r < region_dbs.size(); ++r) {
+		delete region_dbs.at(r);
+	}
+	region_dbs.clear();
+
+	for (unsigned int r = 0u; r < region_class_caches.size(); ++r) {
+		delete region_class_caches.at(r);
+	}
+	region_class_caches.clear();
+
+	db = NULL;
+}
+
+void Multiscale::set_dbview(const DbView* db) {
+	this->db = db;
+}
+
+const DbView* Multiscale::create_thinned_view() throw (Exception) {
+	unsigned int n_kept = 0u;
+
+	free(thinned_markers);
+	thinned_markers = NULL;
+	n_thinned_markers = 0u;
+
+	delete thinned_db;
+	thinned_db = NULL;
+
+	thinned_markers = (unsigned int*)malloc(db->n_markers * sizeof(unsigned int));
+	if (thinned_markers == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	for (unsigned int i = 0u; i < db->n_markers; ++i) {
+		if ((!isnan(thin_maf)) && (auxiliary::fcmp(1.0 - db->major_allele_freqs[i], thin_maf, EPSILON) <= 0)) {
+			continue;
+		}
+
+		if (n_kept % thin_step == 0u) {
+			thinned_markers[n_thinned_markers++] = i;
+		}
+		++n_kept;
+	}
+
+	if (n_thinned_markers < 2u) {
+		return NULL;
+	}
+
+	thinned_db = db->create_subview(thinned_markers, n_thinned_markers);
+
+	return thinned_db;
+}
+
+void Multiscale::find_regions(Partition* coarse_partition) throw (Exception) {
+	region r;
+	unsigned int start = 0u;
+	unsigned int end = 0u;
+	unsigned int n_regions = 0u;
+
+	regions.clear();
+
+	for (unsigned int r = 0u; r < region_class_caches.size(); ++r) {
+		delete region_class_caches.at(r);
+	}
+	region_class_caches.clear();
+
+	for (unsigned int b = 0u; b < coarse_partition->get_n_blocks(); ++b) {
+		coarse_partition->get_block(b, &start, &end);
+
+		/* between the last thinned marker inside and the first one outside, the exact boundary is unknown */
+		r.start = start >= margin ? thinned_markers[start - margin] : 0u;
+		r.end = end + margin < n_thinned_markers - 1u ? thinned_markers[end + margin] : db->n_markers - 1u;
+
+		regions.push_back(r);
+	}
+
+	if (regions.size() == 0u) {
+		return;
+	}
+
+	qsort(&regions[0u], regions.size(), sizeof(region), regions_cmp);
+
+	/* a block may cross the point where two regions meet, so such regions are joined too */
+	for (unsigned int k = 1u; k < regions.size(); ++k) {
+		if (regions.at(k).start <= regions.at(n_regions).end + 1u) {
+			if (regions.at(k).end > regions.at(n_regions).end) {
+				regions.at(n_regions).end = regions.at(k).end;
+			}
+		} else {
+			regions.at(++n_regions) = regions.at(k);
+		}
+	}
+
+	regions.resize(n_regions + 1u);
+	region_class_caches.resize(regions.size(), NULL);
+}
+
+unsigned int Multiscale::get_n_regions() {
+	return (unsigned int)regions.size();
+}
+
+unsigned int Multiscale::get_region_start(unsigned int region) {
+	return regions.at(region).start;
+}
+
+unsigned int Multiscale::get_region_end(unsigned int region) {
+	return regions.at(region).end;
+}
+
+const DbView* Multiscale::create_region_view(unsigned int region) throw (Exception) {
+	DbView* region_db = NULL;
+	unsigned int* markers = NULL;
+
+	unsigned int start = get_region_start(region);
+	unsigned int n_markers = get_region_end(region) - start + 1u;
+	unsigned int span = db->indices[start + n_markers - 1u] - db->indices[start];
+
+	markers = (unsigned int*)malloc(n_markers * sizeof(unsigned int));
+	if (markers == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	for (unsigned int i = 0u; i < n_markers; ++i) {
+		markers[i] = start + i;
+	}
+
+	try {
+		if (region_class_caches.at(region) == NULL) {
+			region_class_caches.at(region) = new PairClassCache(db->indices[start], span + 1u, span > CLASS_CACHE_BAND ? CLASS_CACHE_BAND : (span > 0u ? span : 1u));
+		}
+
+		region_db = db->create_subview(markers, n_markers);
+		region_dbs.push_back(region_db);
+	} catch (Exception &e) {
+		delete region_db;
+		region_db = NULL;
+
+		free(markers);
+		markers = NULL;
+
+		throw;
+	}
+
+	free(markers);
+	markers = NULL;
+
+	return region_db;
+}
+
+PairClassCache* Multiscale::get_region_class_cache(unsigned int region) {
+	return region_class_caches.at(region);
+}
+
+bool Multiscale::is_block(CI* ci, PairClassCache* class_cache, Algorithm* algorithm, unsigned int start, unsigned int end, unsigned int* pair_classes) throw (Exception) {
+	unsigned long int n_strong_pairs = 0u;
+	unsigned long int n_recomb_pairs = 0u;
+
+	for (unsigned int i = start + 1u; i <= end; ++i) {
+		/* the pairs classified by the algorithm of the region are found in its cache */
+		if (class_cache != NULL) {
+			for (unsigned int j = start; j < i; ++j) {
+				if (class_cache->lookup(db->indices[i], db->indices[j]) == CI::PAIR_UNKNOWN) {
+					++n_calculations;
+				}
+			}
+		} else {
+			n_calculations += i - start;
+		}
+
+		ci->classify_range(i, start, i - start, pair_classes);
+
+		if ((i == end) && (pair_classes[0u] != CI::PAIR_STRONG_LD)) {
+			return false;
+		}
+
+		for (unsigned int j = 0u; j < i - start; ++j) {
+			if (pair_classes[j] == CI::PAIR_STRONG_LD) {
+				++n_strong_pairs;
+			} else if (pair_classes[j] == CI::PAIR_RECOMB) {
+				++n_recomb_pairs;
+			}
+		}
+	}
+
+	return algorithm->is_strong_fraction(n_strong_pairs, n_recomb_pairs);
+}
+
+Partition* Multiscale::merge(vector<Partition*>& partitions, CI* ci, Algorithm* algorithm) throw (Exception) {
+	Partition* partition = NULL;
+
+	region_block* blocks = NULL;
+	unsigned int n_blocks = 0u;
+
+	unsigned int* pair_classes = NULL;
+
+	unsigned int offset = 0u;
+	unsigned int start = 0u;
+	unsigned int end = 0u;
+
+	if (partitions.size() != regions.size()) {
+		throw Exception(__FILE__, __LINE__, "The number of partitions (%u) does not match the number of regions (%u).", (unsigned int)partitions.size(), (unsigned int)regions.size());
+	}
+
+	n_rejected_blocks = 0u;
+	n_calculations = 0u;
+
+	for (unsigned int r = 0u; r < partitions.size(); ++r) {
+		n_blocks += partitions.at(r)->get_n_blocks();
+	}
+
+	blocks = (region_block*)malloc((n_blocks > 0u ? n_blocks : 1u) * sizeof(region_block));
+	if (blocks == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	pair_classes = (unsigned int*)malloc(db->n_markers * sizeof(unsigned int));
+	if (pair_classes == NULL) {
+		free(blocks);
+		blocks = NULL;
+
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	n_blocks = 0u;
+	for (unsigned int r = 0u; r < partitions.size(); ++r) {
+		offset = regions.at(r).start;
+		for (unsigned int b = 0u; b < partitions.at(r)->get_n_blocks(); ++b) {
+			partitions.at(r)->get_block(b, &start, &end);
+
+			blocks[n_blocks].start = start + offset;
+			blocks[n_blocks].end = end + offset;
+			blocks[n_blocks].length_bp = db->positions[end + offset] - db->positions[start + offset];
+			blocks[n_blocks].region = r;
+
+			++n_blocks;
+		}
+	}
+
+	/* the regions do not overlap, so the blocks selected in every region are also selected among the blocks of all regions */
+	qsort(blocks, n_blocks, sizeof(region_block), region_blocks_cmp);
+
+	try {
+		partition = new Partition(db);
+
+		if (partitions.size() > 0u) {
+			partition->rsq_blocks = partitions.at(0u)->rsq_blocks;
+			partition->ci_method = partitions.at(0u)->ci_method;
+			partition->likelihood_density = partitions.at(0u)->likelihood_density;
+			partition->strong_pair_cl = partitions.at(0u)->strong_pair_cl;
+			partition->strong_pair_cu = partitions.at(0u)->strong_pair_cu;
+			partition->recomb_pair_cu = partitions.at(0u)->recomb_pair_cu;
+			partition->weak_pair_rsq = partitions.at(0u)->weak_pair_rsq;
+			partition->strong_pair_rsq = partitions.at(0u)->strong_pair_rsq;
+			partition->strong_pairs_fraction = partitions.at(0u)->strong_pairs_fraction;
+			partition->pruning_method = partitions.at(0u)->pruning_method;
+			partition->window = partitions.at(0u)->window;
+			partition->auto_window = partitions.at(0u)->auto_window;
+			partition->max_span_bp = partitions.at(0u)->max_span_bp;
+			partition->max_span_markers = partitions.at(0u)->max_span_markers;
+		}
+
+		for (unsigned int r = 0u; r < partitions.size(); ++r) {
+			if (partitions.at(r)->provisional) {
+				if ((!partition->provisional) || (partitions.at(r)->reached_window < partition->reached_window)) {
+					partition->reached_window = partitions.at(r)->reached_window;
+				}
+				partition->provisional = true;
+			}
+		}
+
+		partition->thin_step = thin_step;
+		partition->thin_maf = thin_maf;
+		partition->thin_margin = margin;
+
+		for (unsigned int b = 0u; b < n_blocks; ++b) {
+			ci->set_class_cache(region_class_caches.at(blocks[b].region));
+			if (is_block(ci, region_class_caches.at(blocks[b].region), algorithm, blocks[b].start, blocks[b].end, pair_classes)) {
+				partition->add_block(blocks[b].start, blocks[b].end);
+			} else {
+				++n_rejected_blocks;
+			}
+		}
+		ci->set_class_cache(NULL);
+	} catch (Exception &e) {
+		ci->set_class_cache(NULL);
+
+		free(blocks);
+		blocks = NULL;
+
+		free(pair_classes);
+		pair_classes = NULL;
+
+		delete partition;
+		partition = NULL;
+
+		throw;
+	}
+
+	free(blocks);
+	blocks = NULL;
+
+	free(pair_classes);
+	pair_classes = NULL;
+
+	return partition;
+}
+
+unsigned int Multiscale::get_n_rejected_blocks() {
+	return n_rejected_blocks;
+}
+
+unsigned long int Multiscale::get_n_calculations() {
+	return n_calculations;
+}
+
+double Multiscale::get_memory_usage() {
+	double memory_usage = 0.0;
+
+	for (unsigned int r = 0u; r < region_class_caches.size(); ++r) {
+		if (region_class_caches.at(r) != NULL) {
+			memory_usage += region_class_caches.at(r)->get_memory_usage();
+		}
+	}
+
+	return memory_usage;
+}
+
+int Multiscale::regions_cmp(const void* first, const void* second) {
+	region* first_region = (region*)first;
+	region* second_region = (region*)second;
+
+	if (first_region->start < second_region->start) {
+		return -1;
+	} else if (first_region->start > second_region->start) {
+		return 1;
+	}
+
+	return 0;
+}
+
+int Multiscale::region_blocks_cmp(const void* first, const void* second) {
+	region_block* first_block = (region_block*)first;
+	region_block* second_block = (region_block*)second;
+
+	if (first_block->length_bp > second_block->length_bp) {
+		return -1;
+	} else if (first_block->length_bp < second_block->length_bp) {
+		return 1;
+	} else {
+		return first_block->start - second_block->start;
+	}
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "include/PairClassCache.h"
+
+const unsigned int PairClassCache::PAIRS_PER_WORD = 32u;
+
+PairClassCache::PairClassCache(unsigned int first_marker, unsigned int n_markers, unsigned int band) throw (Exception) :
+		first_marker(first_marker), n_markers(n_markers), band(band), n_row_words(0u), words(NULL) {
+
+	if (band == 0u) {
+		throw Exception(__FILE__, __LINE__, "The band of the pair class cache must be positive.");
+	}
+
+	n_row_words = (band + PAIRS_PER_WORD - 1u) / PAIRS_PER_WORD;
+
+	words = (uint64_t*)calloc((size_t)n_markers * n_row_words, sizeof(uint64_t));
+	if ((words == NULL) && (n_markers > 0u)) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+}
+
+PairClassCache::~PairClassCache() {
+	free(words);
+	words = NULL;
+}
+
+unsigned int PairClassCache::get_band() {
+	return band;
+}
+
+double PairClassCache::get_memory_usage() {
+	return ((double)n_markers * n_row_words * sizeof(uint64_t)) / 1048576.0;
+}
@@ -30,7 +30,11 @@ Partition::Partition(const DbView* db) throw (Exception) : db(db),
 		recomb_pair_cu(numeric_limits<double>::quiet_NaN()),
 		strong_pair_rsq(numeric_limits<double>::quiet_NaN()),
 		strong_pairs_fraction(numeric_limits<double>::quiet_NaN()),
-		pruning_method(NULL), window(0u) {
+		pruning_method(NULL), window(0u), auto_window(false),
+		max_span_bp(0u), max_span_markers(0u),
+		thin_step(0u), thin_maf(numeric_limits<double>::quiet_NaN()), thin_margin(0u),
+		chunk_band(0u), n_chunks(0u),
+		provisional(false), reached_window(0u) {
 
 	blocks = (block*)malloc(blocks_size * sizeof(block));
 	if (blocks == NULL) {
@@ -66,6 +70,11 @@ unsigned int Partition::get_n_blocks() {
 	return n_blocks;
 }
 
+void Partition::get_block(unsigned int block_id, unsigned int* start, unsigned int* end) {
+	*start = blocks[block_id].start;
+	*end = blocks[block_id].end;
+}
+
 void Partition::write(const char* output_file_name) throw (Exception) {
 	Writer* writer = NULL;
 
@@ -115,11 +124,36 @@ void Partition::write(const char* output_file_name) throw (Exception) {
 		}
 		writer->write("# FRACTION OF STRONG LD SNP PAIRS: >= %g\n", strong_pairs_fraction);
 		writer->write("# PRUNING METHOD: %s\n", pruning_method);
-		if (window > 0u) {
+		if ((window > 0u) && auto_window) {
+			writer->write("# WINDOW: %ld (AUTO)\n", window);
+		} else if (window > 0u) {
 			writer->write("# WINDOW: %ld\n", window);
 		} else {
 			writer->write("# WINDOW: NA\n", window);
 		}
+		if (max_span_bp > 0u) {
+			writer->write("# MAXIMUM BLOCK SPAN (bp): %lu\n", max_span_bp);
+		}
+		if (max_span_markers > 0u) {
+			writer->write("# MAXIMUM BLOCK SPAN (SNPs): %u\n", max_span_markers);
+		}
+		if (thin_step > 0u) {
+			writer->write("# COARSE-TO-FINE THINNING STEP: %u\n", thin_step);
+			if (!isnan(thin_maf)) {
+				writer->write("# COARSE-TO-FINE THINNING MAF: > %g\n", thin_maf);
+			} else {
+				writer->write("# COARSE-TO-FINE THINNING MAF: NA\n");
+			}
+			writer->write("# COARSE-TO-FINE MARGIN (THINNED SNPs): %u\n", thin_margin);
+		}
+		if (chunk_band > 0u) {
+			writer->write("# CHUNK BAND (SNPs): %u\n", chunk_band);
+			writer->write("# CHUNKS: %u\n", n_chunks);
+			writer->write("# CHUNKING: EXACT ONLY FOR BLOCKS WITH BOTH ENDS WITHIN THE CHUNK BAND OF EVERY SPLIT\n");
+		}
+		if (provisional) {
+			writer->write("# PROVISIONAL: TIME BUDGET EXCEEDED AT WINDOW %u\n", reached_window);
+		}
 
 		writer->write("%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\n",
 				"BLOCK_NAME", "FIRST_SNP", "LAST_SNP", "FIRST_SNP_ID", "LAST_SNP_ID", "START_BP", "END_BP", "N_SNPS", "N_HAPS", "N_UNIQUE_HAPS", "N_COMMON_HAPS", "HAPS_DIVERSITY");
@@ -225,7 +259,7 @@ void Partition::get_block_diversity(unsigned int block_id, unsigned int* n_haps,
 		/* Read all (ambiguous & unambiguous) haplotypes */
 		for (unsigned int j = 0u; j < db->n_haplotypes; ++j) {
 			for (unsigned int i = block.start, k = 0u; i <= block.end; ++i, ++k) {
-				hap[k] = db->haplotypes[i][j];
+				hap[k] = db->get_allele(i, j);
 			}
 
 			haps_it = haps.find(hap);
@@ -0,0 +1,192 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "include/PreliminaryBlocks.h"
+
+const unsigned int PreliminaryBlocks::NONE = 0xffffffffu;
+
+PreliminaryBlocks::PreliminaryBlocks() :
+		n_markers(0u), heads(NULL), runs(NULL), n_runs(0u), runs_size(0u), n_blocks(0u) {
+
+}
+
+PreliminaryBlocks::~PreliminaryBlocks() {
+	free(heads);
+	heads = NULL;
+
+	free(runs);
+	runs = NULL;
+}
+
+void PreliminaryBlocks::reset(unsigned int n_markers) throw (Exception) {
+	if ((heads == NULL) || (this->n_markers != n_markers)) {
+		free(heads);
+		heads = (unsigned int*)malloc((n_markers > 0u ? n_markers : 1u) * sizeof(unsigned int));
+		if (heads == NULL) {
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+		}
+		this->n_markers = n_markers;
+	}
+
+	for (unsigned int i = 0u; i < n_markers; ++i) {
+		heads[i] = NONE;
+	}
+
+	n_runs = 0u;
+	n_blocks = 0u;
+}
+
+void PreliminaryBlocks::grow() throw (Exception) {
+	unsigned int new_runs_size = runs_size > 0u ? 2u * runs_size : (n_markers > 0u ? n_markers : 1u);
+	run* new_runs = NULL;
+
+	new_runs = (run*)realloc(runs, new_runs_size * sizeof(run));
+	if (new_runs == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory reallocation.");
+	}
+
+	runs = new_runs;
+	runs_size = new_runs_size;
+}
+
+void PreliminaryBlocks::push(heap_entry* heap, unsigned int* heap_size, const heap_entry* entry) {
+	unsigned int i = (*heap_size)++;
+
+	while ((i > 0u) && is_before(entry, &heap[(i - 1u) / 2u])) {
+		heap[i] = heap[(i - 1u) / 2u];
+		i = (i - 1u) / 2u;
+	}
+
+	heap[i] = *entry;
+}
+
+void PreliminaryBlocks::pop(heap_entry* heap, unsigned int* heap_size) {
+	heap_entry last = heap[--(*heap_size)];
+	unsigned int i = 0u;
+	unsigned int child = 0u;
+
+	while ((child = 2u * i + 1u) < *heap_size) {
+		if ((child + 1u < *heap_size) && is_before(&heap[child + 1u], &heap[child])) {
+			++child;
+		}
+
+		if (!is_before(&heap[child], &last)) {
+			break;
+		}
+
+		heap[i] = heap[child];
+		i = child;
+	}
+
+	heap[i] = last;
+}
+
+void PreliminaryBlocks::select(const DbView* db, Partition* partition) throw (Exception) {
+	heap_entry* heap = NULL;
+	unsigned int heap_size = 0u;
+	heap_entry entry;
+
+	/* 0 for a free marker, otherwise 1 + the end of the chosen block that contains it */
+	unsigned int* chosen_ends = NULL;
+
+	heap = (heap_entry*)malloc((n_markers > 0u ? n_markers : 1u) * sizeof(heap_entry));
+	if (heap == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	chosen_ends = (unsigned int*)malloc((n_markers > 0u ? n_markers : 1u) * sizeof(unsigned int));
+	if (chosen_ends == NULL) {
+		free(heap);
+		heap = NULL;
+
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	for (unsigned int i = 0u; i < n_markers; ++i) {
+		chosen_ends[i] = 0u;
+
+		if (heads[i] != NONE) {
+			entry.start = runs[heads[i]].first_start;
+			entry.end = i;
+			entry.run = heads[i];
+			entry.length_bp = db->positions[entry.end] - db->positions[entry.start];
+			push(heap, &heap_size, &entry);
+		}
+	}
+
+	while (heap_size > 0u) {
+		entry = heap[0u];
+		pop(heap, &heap_size);
+
+		if (chosen_ends[entry.end] != 0u) {
+			continue;
+		}
+
+		if (chosen_ends[entry.start] == 0u) {
+			try {
+				partition->add_block(entry.start, entry.end);
+			} catch (Exception &e) {
+				free(heap);
+				heap = NULL;
+
+				free(chosen_ends);
+				chosen_ends = NULL;
+
+				throw;
+			}
+
+			for (unsigned int i = entry.start; i <= entry.end; ++i) {
+				chosen_ends[i] = entry.end + 1u;
+			}
+
+			continue;
+		}
+
+		/* every start inside a chosen block would be skipped as well, so the next candidate of this end starts after the block */
+		while ((entry.run != NONE) && (chosen_ends[entry.start] != 0u)) {
+			entry.start = chosen_ends[entry.start];
+			while ((entry.run != NONE) && (entry.start > runs[entry.run].last_start)) {
+				entry.run = runs[entry.run].next;
+			}
+			if ((entry.run != NONE) && (entry.start < runs[entry.run].first_start)) {
+				entry.start = runs[entry.run].first_start;
+			}
+		}
+
+		if (entry.run != NONE) {
+			entry.length_bp = db->positions[entry.end] - db->positions[entry.start];
+			push(heap, &heap_size, &entry);
+		}
+	}
+
+	free(heap);
+	heap = NULL;
+
+	free(chosen_ends);
+	chosen_ends = NULL;
+}
+
+unsigned int PreliminaryBlocks::get_n_blocks() {
+	return n_blocks;
+}
+
+double PreliminaryBlocks::get_memory_usage() {
+	return ((n_markers * sizeof(unsigned int)) + (runs_size * sizeof(run))) / 1048576.0;
+}
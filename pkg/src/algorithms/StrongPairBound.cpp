@@ -0,0 +1,279 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "include/StrongPairBound.h"
+
+const double StrongPairBound::EPSILON = 0.00001;
+
+StrongPairBound::StrongPairBound(const DbView* db, double strong_pair_rsq) throw (Exception) :
+		n_markers(db->n_markers), n_candidates(NULL),
+		tree_rows(NULL), tree_positions(NULL), tree_candidates(NULL), n_rows_candidates(0u) {
+
+	n_candidates = (unsigned int*)malloc(n_markers * sizeof(unsigned int));
+	if (n_candidates == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	try {
+		count_candidates(db, strong_pair_rsq);
+	} catch (Exception &e) {
+		free(n_candidates);
+		n_candidates = NULL;
+
+		throw;
+	}
+}
+
+StrongPairBound::~StrongPairBound() {
+	free(n_candidates);
+	n_candidates = NULL;
+
+	free(tree_rows);
+	tree_rows = NULL;
+
+	free(tree_positions);
+	tree_positions = NULL;
+
+	free(tree_candidates);
+	tree_candidates = NULL;
+}
+
+int StrongPairBound::marker_key_cmp(const void* first, const void* second) {
+	const marker_key* first_key = (const marker_key*)first;
+	const marker_key* second_key = (const marker_key*)second;
+
+	if (first_key->key < second_key->key) {
+		return -1;
+	} else if (first_key->key > second_key->key) {
+		return 1;
+	}
+
+	return first_key->marker < second_key->marker ? -1 : (first_key->marker > second_key->marker ? 1 : 0);
+}
+
+void StrongPairBound::count_candidates(const DbView* db, double strong_pair_rsq) throw (Exception) {
+	marker_key* keys = NULL;
+	unsigned int n_keys = 0u;
+
+	unsigned int* ranks = NULL;
+	unsigned int* tree = NULL;
+
+	double frequency = 0.0;
+	double max_distance = 0.0;
+
+	unsigned int first = 0u, last = 0u;
+	unsigned int middle = 0u;
+	unsigned int n_lower = 0u, n_upper = 0u;
+
+	for (unsigned int b = 0u; b < n_markers; ++b) {
+		n_candidates[b] = b;
+	}
+
+	if (auxiliary::fcmp(strong_pair_rsq, EPSILON, EPSILON) <= 0) {
+		return;
+	}
+
+	for (unsigned int b = 0u; b < n_markers; ++b) {
+		if (db->missing_haplotypes[b] != NULL) {
+			return;
+		}
+	}
+
+	max_distance = -log(strong_pair_rsq) + EPSILON;
+
+	keys = (marker_key*)malloc(n_markers * sizeof(marker_key));
+	if (keys == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	ranks = (unsigned int*)malloc(n_markers * sizeof(unsigned int));
+	if (ranks == NULL) {
+		free(keys);
+		keys = NULL;
+
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	tree = (unsigned int*)calloc(n_markers + 1u, sizeof(unsigned int));
+	if (tree == NULL) {
+		free(keys);
+		keys = NULL;
+
+		free(ranks);
+		ranks = NULL;
+
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	/* monomorphic markers have undefined r^2, so they are nobody's candidates */
+	for (unsigned int b = 0u; b < n_markers; ++b) {
+		frequency = db->major_allele_freqs[b];
+		if ((frequency > 0.0) && (frequency < 1.0)) {
+			keys[n_keys].key = fabs(log(frequency / (1.0 - frequency)));
+			keys[n_keys].marker = b;
+			++n_keys;
+		}
+		ranks[b] = 0u;
+	}
+
+	qsort(keys, n_keys, sizeof(marker_key), marker_key_cmp);
+
+	for (unsigned int k = 0u; k < n_keys; ++k) {
+		ranks[keys[k].marker] = k + 1u;
+	}
+
+	for (unsigned int b = 0u; b < n_markers; ++b) {
+		if (ranks[b] == 0u) {
+			n_candidates[b] = 0u;
+			continue;
+		}
+
+		/* keys with rank in [first + 1, last] are within max_distance of the key of b */
+		first = 0u;
+		last = n_keys;
+		while (first < last) {
+			middle = first + (last - first) / 2u;
+			if (keys[middle].key < keys[ranks[b] - 1u].key - max_distance) {
+				first = middle + 1u;
+			} else {
+				last = middle;
+			}
+		}
+
+		n_lower = first;
+
+		first = n_lower;
+		last = n_keys;
+		while (first < last) {
+			middle = first + (last - first) / 2u;
+			if (keys[middle].key <= keys[ranks[b] - 1u].key + max_distance) {
+				first = middle + 1u;
+			} else {
+				last = middle;
+			}
+		}
+
+		n_upper = first;
+
+		/* markers a < b are the ones already in the tree */
+		n_candidates[b] = 0u;
+		for (unsigned int k = n_upper; k > 0u; k -= k & (~k + 1u)) {
+			n_candidates[b] += tree[k];
+		}
+		for (unsigned int k = n_lower; k > 0u; k -= k & (~k + 1u)) {
+			n_candidates[b] -= tree[k];
+		}
+
+		for (unsigned int k = ranks[b]; k <= n_keys; k += k & (~k + 1u)) {
+			tree[k] += 1u;
+		}
+	}
+
+	free(keys);
+	keys = NULL;
+
+	free(ranks);
+	ranks = NULL;
+
+	free(tree);
+	tree = NULL;
+}
+
+void StrongPairBound::reset_rows() throw (Exception) {
+	if (tree_rows == NULL) {
+		tree_rows = (uint64_t*)malloc((n_markers + 1u) * sizeof(uint64_t));
+		if (tree_rows == NULL) {
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+		}
+	}
+
+	if (tree_positions == NULL) {
+		tree_positions = (uint64_t*)malloc((n_markers + 1u) * sizeof(uint64_t));
+		if (tree_positions == NULL) {
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+		}
+	}
+
+	if (tree_candidates == NULL) {
+		tree_candidates = (uint64_t*)malloc((n_markers + 1u) * sizeof(uint64_t));
+		if (tree_candidates == NULL) {
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+		}
+	}
+
+	for (unsigned int k = 0u; k <= n_markers; ++k) {
+		tree_rows[k] = 0u;
+		tree_positions[k] = 0u;
+		tree_candidates[k] = 0u;
+	}
+
+	/* linear time construction: every node passes its sums on to its parent */
+	n_rows_candidates = 0u;
+	for (unsigned int b = 1u; b < n_markers; ++b) {
+		tree_rows[b - n_candidates[b] + 1u] += 1u;
+		tree_positions[b - n_candidates[b] + 1u] += b;
+		tree_candidates[b - n_candidates[b] + 1u] += n_candidates[b];
+		n_rows_candidates += n_candidates[b];
+	}
+
+	for (unsigned int k = 1u; k <= n_markers; ++k) {
+		unsigned int parent = k + (k & (~k + 1u));
+		if (parent <= n_markers) {
+			tree_rows[parent] += tree_rows[k];
+			tree_positions[parent] += tree_positions[k];
+			tree_candidates[parent] += tree_candidates[k];
+		}
+	}
+}
+
+void StrongPairBound::remove_row(unsigned int marker_b) {
+	for (unsigned int k = marker_b - n_candidates[marker_b] + 1u; k <= n_markers; k += k & (~k + 1u)) {
+		tree_rows[k] -= 1u;
+		tree_positions[k] -= marker_b;
+		tree_candidates[k] -= n_candidates[marker_b];
+	}
+
+	n_rows_candidates -= n_candidates[marker_b];
+}
+
+uint64_t StrongPairBound::get_max_strong_pairs(unsigned int marker_j) {
+	uint64_t n_rows = 0u;
+	uint64_t positions = 0u;
+	uint64_t candidates = 0u;
+
+	/* a row b has min(b - marker_j, n_candidates[b]) pairs with a >= marker_j that may be strong; the first is smaller iff b - n_candidates[b] <= marker_j */
+	for (unsigned int k = (marker_j < n_markers ? marker_j : n_markers - 1u) + 1u; k > 0u; k -= k & (~k + 1u)) {
+		n_rows += tree_rows[k];
+		positions += tree_positions[k];
+		candidates += tree_candidates[k];
+	}
+
+	return (positions - marker_j * n_rows) + (n_rows_candidates - candidates);
+}
+
+double StrongPairBound::get_memory_usage() {
+	double memory_usage = (n_markers * sizeof(unsigned int)) / 1048576.0;
+
+	if (tree_candidates != NULL) {
+		memory_usage += (3u * (n_markers + 1u) * sizeof(uint64_t)) / 1048576.0;
+	}
+
+	return memory_usage;
+}
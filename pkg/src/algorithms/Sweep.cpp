@@ -0,0 +1,229 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "include/Sweep.h"
+
+Sweep::Sweep() : db(NULL), ci_method(NULL), likelihood_density(0u), adaptive_likelihood(false), ci_cache(NULL),
+		dprime_lower_cis(NULL), dprime_upper_cis(NULL), pair_classes(NULL) {
+
+}
+
+Sweep::~Sweep() {
+	free_w_values();
+
+	for (unsigned int s = 0u; s < settings.size(); ++s) {
+		delete settings.at(s).algorithm;
+		settings.at(s).algorithm = NULL;
+
+		delete settings.at(s).thresholds;
+		settings.at(s).thresholds = NULL;
+	}
+
+	db = NULL;
+	ci_cache = NULL;
+}
+
+void Sweep::set_dbview(const DbView* db) {
+	this->db = db;
+}
+
+void Sweep::set_ci_method(const char* ci_method) {
+	this->ci_method = ci_method;
+}
+
+void Sweep::set_likelihood_density(unsigned int likelihood_density) {
+	this->likelihood_density = likelihood_density;
+}
+
+void Sweep::set_adaptive_likelihood(bool adaptive_likelihood) {
+	this->adaptive_likelihood = adaptive_likelihood;
+}
+
+void Sweep::set_ci_cache(CICache* ci_cache) {
+	this->ci_cache = ci_cache;
+}
+
+void Sweep::add_setting(double strong_pair_cl, double strong_pair_cu, double recomb_pair_cu, double strong_pairs_fraction) throw (Exception) {
+	setting s;
+
+	s.algorithm = AlgorithmFactory::create(Algorithm::ALGORITHM_MIGP, 0u);
+	s.algorithm->set_strong_pair_cl(strong_pair_cl);
+	s.algorithm->set_strong_pair_cu(strong_pair_cu);
+	s.algorithm->set_recomb_pair_cu(recomb_pair_cu);
+	s.algorithm->set_strong_pairs_fraction(strong_pairs_fraction);
+
+	s.thresholds = new CI();
+	s.thresholds->set_pair_thresholds(strong_pair_cl, strong_pair_cu, recomb_pair_cu);
+
+	s.w_values = NULL;
+	s.breakpoint = 0;
+	s.updated_breakpoint = 0;
+
+	settings.push_back(s);
+}
+
+unsigned int Sweep::get_n_settings() {
+	return (unsigned int)settings.size();
+}
+
+void Sweep::free_w_values() {
+	for (unsigned int s = 0u; s < settings.size(); ++s) {
+		free(settings.at(s).w_values);
+		settings.at(s).w_values = NULL;
+	}
+
+	free(dprime_lower_cis);
+	dprime_lower_cis = NULL;
+
+	free(dprime_upper_cis);
+	dprime_upper_cis = NULL;
+
+	free(pair_classes);
+	pair_classes = NULL;
+}
+
+template <class Weight> void Sweep::scan_row(setting* s, Weight strong_weight, Weight recomb_weight, unsigned int i, long int first) throw (Exception) {
+	Algorithm* algorithm = s->algorithm;
+	Weight* w_values = (Weight*)s->w_values;
+	Weight w_value_max = 0;
+	uint64_t n_pairs = 0u;
+
+	/* the loop of AlgorithmMIGP::compute_preliminary_blocks() for one row, on the CIs of [first, i) */
+	s->breakpoint = s->updated_breakpoint;
+	s->updated_breakpoint = i;
+
+	for (long int j = s->breakpoint; j < (long int)i; ++j) {
+		pair_classes[j - s->breakpoint] = s->thresholds->classify_CI(dprime_lower_cis[j - first], dprime_upper_cis[j - first]);
+	}
+	WeightScan::add_suffix_sums(pair_classes, i - s->breakpoint, strong_weight, recomb_weight, (Weight)0, w_values + s->breakpoint);
+
+	for (long int j = i - 1u; j >= s->breakpoint; --j) {
+		if ((pair_classes[j - s->breakpoint] == CI::PAIR_STRONG_LD) && (Algorithm::is_nonnegative(w_values[j]))) {
+			algorithm->preliminary_blocks.add(j, i);
+		}
+	}
+
+	for (long int j = s->breakpoint; j < (long int)i; ++j) {
+		/* in 64 bits: the product of two marker counts overflows 32-bit longs */
+		n_pairs = ((uint64_t)(db->n_markers - i - 1u) * ((uint64_t)db->n_markers + (uint64_t)i - (uint64_t)j - (uint64_t)j)) / 2u;
+		w_value_max = w_values[j] + strong_weight * (Weight)n_pairs;
+		if (Algorithm::is_nonnegative(w_value_max)) {
+			s->updated_breakpoint = j;
+			break;
+		}
+	}
+}
+
+void Sweep::compute_preliminary_blocks() throw (Exception) {
+	CI* ci = NULL;
+	setting* s = NULL;
+
+	long int first = 0;
+
+	free_w_values();
+
+	for (unsigned int k = 0u; k < settings.size(); ++k) {
+		s = &settings.at(k);
+
+		s->algorithm->set_dbview(db);
+		s->algorithm->set_ci_method(ci_method);
+		s->algorithm->set_likelihood_density(likelihood_density);
+		s->algorithm->set_adaptive_likelihood(adaptive_likelihood);
+		s->algorithm->set_ci_cache(ci_cache);
+		s->algorithm->rsq_preliminary_blocks = false;
+		s->algorithm->preliminary_blocks.reset(db->n_markers);
+
+		s->w_values = calloc(db->n_markers, s->algorithm->get_weight_size());
+		if (s->w_values == NULL) {
+			free_w_values();
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+		}
+
+		s->breakpoint = 0;
+		s->updated_breakpoint = 0;
+	}
+
+	dprime_lower_cis = (double*)malloc(db->n_markers * sizeof(double));
+	dprime_upper_cis = (double*)malloc(db->n_markers * sizeof(double));
+	pair_classes = (unsigned int*)malloc(db->n_markers * sizeof(unsigned int));
+	if ((dprime_lower_cis == NULL) || (dprime_upper_cis == NULL) || (pair_classes == NULL)) {
+		free_w_values();
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	try {
+		ci = CIFactory::create(ci_method, likelihood_density, ci_cache, adaptive_likelihood);
+		ci->set_dbview(db);
+
+		for (unsigned int i = 1u; i < db->n_markers; ++i) {
+			/* the union of the frontiers: every setting resumes from its own updated breakpoint */
+			first = i;
+			for (unsigned int k = 0u; k < settings.size(); ++k) {
+				if (settings.at(k).updated_breakpoint < first) {
+					first = settings.at(k).updated_breakpoint;
+				}
+			}
+
+			ci->get_CI_range(i, first, i - first, dprime_lower_cis, dprime_upper_cis);
+
+			for (unsigned int k = 0u; k < settings.size(); ++k) {
+				s = &settings.at(k);
+				if (s->algorithm->is_int_weighted()) {
+					scan_row(s, s->algorithm->strong_pair_int_weight, s->algorithm->recomb_pair_int_weight, i, first);
+				} else {
+					scan_row(s, (long double)s->algorithm->strong_pair_weight, (long double)s->algorithm->recomb_pair_weight, i, first);
+				}
+			}
+		}
+	} catch (Exception &e) {
+		delete ci;
+		ci = NULL;
+
+		free_w_values();
+
+		throw;
+	}
+
+	delete ci;
+	ci = NULL;
+
+	free_w_values();
+}
+
+unsigned int Sweep::get_n_preliminary_blocks(unsigned int setting_id) {
+	return settings.at(setting_id).algorithm->get_n_preliminary_blocks();
+}
+
+Partition* Sweep::get_block_partition(unsigned int setting_id) throw (Exception) {
+	return settings.at(setting_id).algorithm->get_block_partition();
+}
+
+double Sweep::get_memory_usage() {
+	double memory_usage = 0.0;
+
+	memory_usage += (2u * db->n_markers * sizeof(double)) / 1048576.0;
+	memory_usage += (db->n_markers * sizeof(unsigned int)) / 1048576.0;
+	for (unsigned int s = 0u; s < settings.size(); ++s) {
+		memory_usage += (db->n_markers * settings.at(s).algorithm->get_weight_size()) / 1048576.0;
+		memory_usage += settings.at(s).algorithm->get_memory_usage_preliminary_blocks();
+	}
+
+	return memory_usage;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "include/WeightScan.h"
+#include "include/CI.h"
+
+/* as in PairCounter, the AVX2 kernel is compiled with a target attribute and is left out on Windows */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && !defined(_WIN32)
+#define WEIGHTSCAN_X86_AVX2
+#include <immintrin.h>
+#endif
+
+static bool scalar_is_supported() {
+	return true;
+}
+
+static int64_t scalar_add_suffix_sums(const unsigned int* pair_classes, unsigned int n, int64_t strong_weight, int64_t recomb_weight, int64_t initial_sum, int64_t* w_values) {
+	int64_t sum = initial_sum;
+
+	for (unsigned int k = n; k > 0u; --k) {
+		sum += (pair_classes[k - 1u] == CI::PAIR_STRONG_LD ? strong_weight : 0) - (pair_classes[k - 1u] == CI::PAIR_RECOMB ? recomb_weight : 0);
+		w_values[k - 1u] += sum;
+	}
+
+	return sum;
+}
+
+#ifdef WEIGHTSCAN_X86_AVX2
+static bool avx2_is_supported() {
+	return __builtin_cpu_supports("avx2");
+}
+
+/* Four pairs at a time from the right: weights from the class masks, suffix sums within the vector by two shifted adds, plus the carry. */
+__attribute__((target("avx2")))
+static int64_t avx2_add_suffix_sums(const unsigned int* pair_classes, unsigned int n, int64_t strong_weight, int64_t recomb_weight, int64_t initial_sum, int64_t* w_values) {
+	const __m256i strong_class = _mm256_set1_epi64x(CI::PAIR_STRONG_LD);
+	const __m256i recomb_class = _mm256_set1_epi64x(CI::PAIR_RECOMB);
+	const __m256i strong_weights = _mm256_set1_epi64x(strong_weight);
+	const __m256i recomb_weights = _mm256_set1_epi64x(-recomb_weight);
+	const __m256i zero = _mm256_setzero_si256();
+
+	__m256i classes, sums, carry = _mm256_set1_epi64x(initial_sum);
+	int64_t lanes[4u];
+	unsigned int k = n;
+
+	while (k >= 4u) {
+		k -= 4u;
+
+		classes = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(pair_classes + k)));
+		sums = _mm256_add_epi64(
+				_mm256_and_si256(_mm256_cmpeq_epi64(classes, strong_class), strong_weights),
+				_mm256_and_si256(_mm256_cmpeq_epi64(classes, recomb_class), recomb_weights));
+
+		/* [x0, x1, x2, x3] -> [x0 + x1, x1 + x2, x2 + x3, x3] -> [x0 + ... + x3, x1 + x2 + x3, x2 + x3, x3] */
+		sums = _mm256_add_epi64(sums, _mm256_blend_epi32(_mm256_permute4x64_epi64(sums, _MM_SHUFFLE(3, 3, 2, 1)), zero, 0xc0));
+		sums = _mm256_add_epi64(sums, _mm256_blend_epi32(_mm256_permute4x64_epi64(sums, _MM_SHUFFLE(3, 3, 3, 2)), zero, 0xf0));
+		sums = _mm256_add_epi64(sums, carry);
+
+		_mm256_storeu_si256((__m256i*)(w_values + k), _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(w_values + k)), sums));
+
+		carry = _mm256_permute4x64_epi64(sums, _MM_SHUFFLE(0, 0, 0, 0));
+	}
+
+	_mm256_storeu_si256((__m256i*)lanes, carry);
+
+	return scalar_add_suffix_sums(pair_classes, k, strong_weight, recomb_weight, lanes[0u], w_values);
+}
+#endif
+
+const WeightScan::Kernel WeightScan::kernels[] = {
+#ifdef WEIGHTSCAN_X86_AVX2
+		{ "AVX2", avx2_is_supported, avx2_add_suffix_sums },
+#endif
+		{ "scalar", scalar_is_supported, scalar_add_suffix_sums }
+};
+
+const unsigned int WeightScan::N_KERNELS = sizeof(WeightScan::kernels) / sizeof(WeightScan::Kernel);
+
+const WeightScan::Kernel* WeightScan::kernel = WeightScan::select_kernel();
+
+const WeightScan::Kernel* WeightScan::select_kernel() {
+#ifdef WEIGHTSCAN_X86_AVX2
+	__builtin_cpu_init();
+#endif
+
+	for (unsigned int i = 0u; i < N_KERNELS; ++i) {
+		if (kernels[i].is_supported()) {
+			return &kernels[i];
+		}
+	}
+
+	return &kernels[N_KERNELS - 1u];
+}
+
+const char* WeightScan::get_kernel_name() {
+	return kernel->name;
+}
+
+bool WeightScan::set_kernel(const char* name) {
+	for (unsigned int i = 0u; i < N_KERNELS; ++i) {
+		if ((auxiliary::strcmp_ignore_case(kernels[i].name, name) == 0) && (kernels[i].is_supported())) {
+			kernel = &kernels[i];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+long double WeightScan::add_suffix_sums(const unsigned int* pair_classes, unsigned int n, long double strong_weight, long double recomb_weight, long double initial_sum, long double* w_values) {
+	long double sum = initial_sum;
+
+	for (unsigned int k = n; k > 0u; --k) {
+		if (pair_classes[k - 1u] == CI::PAIR_STRONG_LD) {
+			sum += strong_weight;
+		} else if (pair_classes[k - 1u] == CI::PAIR_RECOMB) {
+			sum -= recomb_weight;
+		}
+		w_values[k - 1u] += sum;
+	}
+
+	return sum;
+}
@@ -26,25 +26,33 @@
 #include "../../db/include/DbView.h"
 #include "../../writer/include/WriterFactory.h"
 #include "CIFactory.h"
+#include "CIRsq.h"
+#include "CIRsqSample.h"
+#include "CIPool.h"
+#include "CIGroups.h"
+#include "ColumnGroups.h"
+#include "HaplotypeSample.h"
 #include "Partition.h"
+#include "PreliminaryBlocks.h"
+#include "StrongPairBound.h"
+#include "WeightScan.h"
 
 using namespace std;
 
 class Algorithm {
-protected:
-	static const unsigned int PRELIMINARY_BLOCKS_SIZE_INIT;
-	static const unsigned int PRELIMINARY_BLOCKS_SIZE_INCREMENT;
-
-	struct preliminary_block {
-		unsigned int start;
-		unsigned int end;
-		unsigned long int length_bp;
-	};
+	friend class Sweep;
 
+protected:
 	const DbView* db;
 
 	const char* ci_method;
 	unsigned int likelihood_density;
+	bool adaptive_likelihood;
+	CICache* ci_cache;
+	PairClassCache* class_cache;
+
+	/* threads that classify the pairs of one row in parallel */
+	unsigned int n_threads;
 
 	double pos_strong_pair_cl;
 	double neg_strong_pair_cl;
@@ -63,12 +71,74 @@ protected:
 	double strong_pair_weight;
 	double recomb_pair_weight;
 
-	preliminary_block* preliminary_blocks;
-	unsigned int n_preliminary_blocks;
-	unsigned int preliminary_blocks_size;
+	/*
+	 * if integer_weights (off by default), strong_pairs_fraction as p / q: the weights are (q - p) and p in units of 1 / q, or 0 if there is no
+	 * such q <= MAX_WEIGHT_DENOMINATOR; the exact comparisons may decide the regions at the boundary fraction differently from the tolerance EPSILON
+	 */
+	bool integer_weights;
+	int64_t weight_denominator;
+	int64_t strong_pair_int_weight;
+	int64_t recomb_pair_int_weight;
+
+	PreliminaryBlocks preliminary_blocks;
 	bool rsq_preliminary_blocks;
 
-	static int preliminary_blocks_cmp(const void* first, const void* second);
+	/* pairs scanned by the last compute_preliminary_blocks() */
+	unsigned long int n_calculations;
+
+	/* with r^2 pair classes, MIG+ and MIG++ prune with the strong pair candidates of strong_pair_bound instead of all pairs */
+	bool tight_bounds;
+	StrongPairBound* strong_pair_bound;
+
+	/* blocks span at most max_span_bp base-pairs and max_span_markers markers (0 if not limited), so no pair beyond is classified */
+	unsigned long int max_span_bp;
+	unsigned int max_span_markers;
+
+	/* the pairs are classified once per pair of column groups (identical haplotype columns) if collapse_columns */
+	bool collapse_columns;
+	ColumnGroups* column_groups;
+
+	/*
+	 * with r^2 pair classes, the pairs are first classified on sample_size sampled haplotypes (0 if not sampled), and counted on all
+	 * haplotypes only if their class is uncertain at sample_confidence
+	 */
+	unsigned int sample_size;
+	double sample_confidence;
+	uint64_t sample_seed;
+	HaplotypeSample* haplotype_sample;
+	unsigned long int n_sampled_pairs;
+	unsigned long int n_exact_pairs;
+
+	bool has_max_span();
+	long int get_span_start(unsigned int marker_i);
+	long int get_span_end(unsigned int marker_j);
+
+	void set_up_ci(CI* ci);
+	void set_up_strong_pair_bound() throw (Exception);
+	void set_up_column_groups() throw (Exception);
+	void set_up_haplotype_sample() throw (Exception);
+	void set_int_weights();
+
+	bool is_int_weighted();
+	size_t get_weight_size();
+
+	static inline bool is_nonnegative(long double w_value) {
+		return auxiliary::fcmp(w_value, 0.0, EPSILON) >= 0;
+	}
+
+	static inline bool is_nonnegative(int64_t w_value) {
+		return w_value >= 0;
+	}
+
+	/*
+	 * Call algorithm->compute_preliminary_blocks(classifier) with the pair classifier of ci_method (run_ci) or of the r^2 thresholds
+	 * (run_rsq). The classifier is chosen once per run, so that the pair loop of A is compiled for its concrete type. It is a pool with one
+	 * classifier per thread; the weights are still accumulated serially, so the preliminary blocks do not depend on n_threads.
+	 * With column groups, the pool classifies the groups' view and run_weighted() passes it wrapped in CIGroups.
+	 */
+	template <class A> void run_ci(A* algorithm) throw (Exception);
+	template <class A> void run_rsq(A* algorithm) throw (Exception);
+	template <class A, class Classifier> void run_weighted(A* algorithm, Classifier* classifier) throw (Exception);
 
 public:
 	static const char* ALGORITHM_MIG;
@@ -76,6 +146,8 @@ public:
 	static const char* ALGORITHM_MIGPP;
 
 	static const double EPSILON;
+	static const int64_t MAX_WEIGHT_DENOMINATOR;
+	static const uint64_t DEFAULT_SAMPLE_SEED;
 
 	Algorithm() throw (Exception);
 	virtual ~Algorithm();
@@ -84,17 +156,34 @@ public:
 
 	void set_ci_method(const char* ci_method);
 	void set_likelihood_density(unsigned int likelihood_density);
+	void set_adaptive_likelihood(bool adaptive_likelihood);
+	void set_ci_cache(CICache* ci_cache);
+	void set_class_cache(PairClassCache* class_cache);
+	void set_n_threads(unsigned int n_threads);
 	void set_strong_pair_cl(double ci_lower_bound);
 	void set_strong_pair_cu(double ci_upper_bound);
 	void set_recomb_pair_cu(double ci_upper_bound);
 	void set_weak_pair_rsq(double weak_rsq);
 	void set_strong_pair_rsq(double strong_rsq);
 	void set_strong_pairs_fraction(double fraction);
+	void set_integer_weights(bool integer_weights);
+	void set_tight_bounds(bool tight_bounds);
+	void set_max_span(unsigned long int max_span_bp, unsigned int max_span_markers);
+	void set_collapse_columns(bool collapse_columns);
+	void set_haplotype_sample(unsigned int sample_size, double sample_confidence, uint64_t sample_seed = DEFAULT_SAMPLE_SEED);
 
 	virtual void compute_preliminary_blocks() throw (Exception) = 0;
 	virtual void compute_preliminary_blocks_rsq() throw (Exception) = 0;
 	unsigned int get_n_preliminary_blocks();
-	void sort_preliminary_blocks();
+	unsigned long int get_n_calculations();
+	unsigned int get_n_column_groups();
+
+	/* Whether n_strong_pairs are at least the strong_pairs_fraction of the informative pairs, decided with the weights of compute_preliminary_blocks(). */
+	bool is_strong_fraction(unsigned long int n_strong_pairs, unsigned long int n_recomb_pairs);
+
+	/* pairs classified on the haplotype sample by the last compute_preliminary_blocks_rsq(), and those recounted on all haplotypes */
+	unsigned long int get_n_sampled_pairs();
+	unsigned long int get_n_exact_pairs();
 
 	virtual Partition* get_block_partition() throw (Exception);
 
@@ -102,4 +191,78 @@ public:
 	virtual double get_memory_usage();
 };
 
+template <class A> void Algorithm::run_ci(A* algorithm) throw (Exception) {
+	rsq_preliminary_blocks = false;
+
+	set_up_column_groups();
+
+	if (auxiliary::strcmp_ignore_case(ci_method, CI::CI_WP) == 0) {
+		CIPool<CIWP> pool(n_threads);
+		for (unsigned int t = 0u; t < n_threads; ++t) {
+			pool.set_classifier(t, new CIWP(likelihood_density, adaptive_likelihood));
+			set_up_ci(pool.get_classifier(t));
+		}
+		run_weighted(algorithm, &pool);
+	} else if (auxiliary::strcmp_ignore_case(ci_method, CI::CI_AV) == 0) {
+		CIPool<CIAV> pool(n_threads);
+		for (unsigned int t = 0u; t < n_threads; ++t) {
+			pool.set_classifier(t, new CIAV());
+			set_up_ci(pool.get_classifier(t));
+		}
+		run_weighted(algorithm, &pool);
+	} else {
+		throw Exception(__FILE__, __LINE__, "Unknown D' CI computation method '%s' was specified.", ci_method);
+	}
+}
+
+template <class A> void Algorithm::run_rsq(A* algorithm) throw (Exception) {
+	rsq_preliminary_blocks = true;
+
+	set_up_column_groups();
+	set_up_haplotype_sample();
+
+	if (haplotype_sample != NULL) {
+		CIPool<CIRsqSample> pool(n_threads);
+		for (unsigned int t = 0u; t < n_threads; ++t) {
+			pool.set_classifier(t, new CIRsqSample());
+			pool.get_classifier(t)->set_dbview(column_groups != NULL ? column_groups->get_view() : db);
+			pool.get_classifier(t)->set_pair_rsq(weak_pair_rsq, strong_pair_rsq);
+			pool.get_classifier(t)->set_sample(haplotype_sample->get_view(), sample_confidence);
+		}
+		run_weighted(algorithm, &pool);
+
+		for (unsigned int t = 0u; t < n_threads; ++t) {
+			n_sampled_pairs += pool.get_classifier(t)->get_n_sampled_pairs();
+			n_exact_pairs += pool.get_classifier(t)->get_n_exact_pairs();
+		}
+		return;
+	}
+
+	CIPool<CIRsq> pool(n_threads);
+	for (unsigned int t = 0u; t < n_threads; ++t) {
+		pool.set_classifier(t, new CIRsq());
+		pool.get_classifier(t)->set_dbview(column_groups != NULL ? column_groups->get_view() : db);
+		pool.get_classifier(t)->set_pair_rsq(weak_pair_rsq, strong_pair_rsq);
+	}
+	run_weighted(algorithm, &pool);
+}
+
+template <class A, class Classifier> void Algorithm::run_weighted(A* algorithm, Classifier* classifier) throw (Exception) {
+	if (column_groups != NULL) {
+		CIGroups<Classifier> grouped_classifier(classifier, column_groups);
+		if (is_int_weighted()) {
+			algorithm->compute_preliminary_blocks(&grouped_classifier, strong_pair_int_weight, recomb_pair_int_weight);
+		} else {
+			algorithm->compute_preliminary_blocks(&grouped_classifier, (long double)strong_pair_weight, (long double)recomb_pair_weight);
+		}
+		return;
+	}
+
+	if (is_int_weighted()) {
+		algorithm->compute_preliminary_blocks(classifier, strong_pair_int_weight, recomb_pair_int_weight);
+	} else {
+		algorithm->compute_preliminary_blocks(classifier, (long double)strong_pair_weight, (long double)recomb_pair_weight);
+	}
+}
+
 #endif
@@ -25,6 +25,10 @@
 using namespace std;
 
 class AlgorithmMIGP: public Algorithm {
+	friend class Algorithm;
+
+private:
+	template <class Classifier, class Weight> void compute_preliminary_blocks(Classifier* classifier, Weight strong_weight, Weight recomb_weight) throw (Exception);
 
 public:
 	AlgorithmMIGP();
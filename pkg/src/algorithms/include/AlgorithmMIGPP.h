@@ -20,21 +20,70 @@
 #ifndef ALGORITHMMIGPP_H_
 #define ALGORITHMMIGPP_H_
 
+#include <time.h>
+
+#ifndef _OPENMP
+#include <sys/time.h>
+#endif
+
 #include "Algorithm.h"
 
 using namespace std;
 
 class AlgorithmMIGPP: public Algorithm {
+	friend class Algorithm;
+
 private:
 	unsigned int window;
 
+	/* passes over the markers by the last compute_preliminary_blocks() */
+	unsigned int n_passes;
+
+	bool auto_window;
+
+	/* compute_preliminary_blocks() starts no new pass after deadline (wall time in seconds, 0 if none) */
+	double deadline;
+	bool provisional;
+	unsigned int reached_window;
+
+	static double get_wall_time();
+
+	/* the pairs (a, marker_b), a < termination, that were not computed and are assumed to be strong (none beyond the maximum span) */
+	inline long int get_n_strong_pairs(unsigned int marker_b, long int termination) {
+		long int n_pairs = has_max_span() ? termination - get_span_start(marker_b) : termination;
+		return strong_pair_bound != NULL ? strong_pair_bound->get_n_strong_pairs(marker_b, n_pairs) : n_pairs;
+	}
+
+	template <class Classifier, class Weight> void compute_preliminary_blocks(Classifier* classifier, Weight strong_weight, Weight recomb_weight) throw (Exception);
+
 public:
+	static const char* WINDOW_AUTO;
+	static const unsigned int AUTO_WINDOW_SAMPLE_SIZE;
+	static const unsigned int AUTO_WINDOW_CACHE_BAND;
+
 	AlgorithmMIGPP(unsigned int window);
 	virtual ~AlgorithmMIGPP();
 
 	void compute_preliminary_blocks() throw (Exception);
 	void compute_preliminary_blocks_rsq() throw (Exception);
 
+	unsigned int get_window();
+	unsigned int get_n_passes();
+
+	/*
+	 * Limits compute_preliminary_blocks() to time_budget seconds from this call (no limit if time_budget <= 0). The first pass always
+	 * completes; once the budget is spent, no wider window is tried and the partition is built from the candidates found so far.
+	 */
+	void set_time_budget(double time_budget);
+	bool is_provisional();
+	unsigned int get_reached_window();
+
+	/*
+	 * Probes the windows 1, 2, 4, ... up to the number of markers in sample (a view of the same Db, e.g. a stretch of the region) and
+	 * keeps the cheapest one. The cost of a probe is the number of scanned pairs plus the markers scanned by all its passes.
+	 */
+	void tune_window(const DbView* sample) throw (Exception);
+
 	Partition* get_block_partition() throw (Exception);
 
 	double get_memory_usage();
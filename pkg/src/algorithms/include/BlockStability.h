@@ -0,0 +1,78 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLOCKSTABILITY_H_
+#define BLOCKSTABILITY_H_
+
+#include <limits>
+
+#include "../../LDExplorer.h"
+#include "../../auxiliary/include/auxiliary.h"
+#include "../../exception/include/Exception.h"
+#include "../../writer/include/WriterFactory.h"
+#include "../../db/include/DbView.h"
+#include "Partition.h"
+
+using namespace std;
+
+/*
+ * Per-marker frequencies of the haplotype block boundaries over the partitions of bootstrap replicates of one view: how often a marker
+ * is within a block, the first or the last marker of a block, and in the same block as the next marker. The partitions must be found
+ * on views with the same markers as this view (e.g. the views of BootstrapReplicate). The settings are taken from the first partition.
+ */
+class BlockStability {
+private:
+	const DbView* db;
+
+	unsigned int n_replicates;
+	unsigned long int n_blocks;
+	unsigned int* n_in_block;
+	unsigned int* n_first;
+	unsigned int* n_last;
+	unsigned int* n_joined;
+
+	bool rsq_blocks;
+	const char* ci_method;
+	unsigned int likelihood_density;
+	double strong_pair_cl;
+	double strong_pair_cu;
+	double recomb_pair_cu;
+	double weak_pair_rsq;
+	double strong_pair_rsq;
+	double strong_pairs_fraction;
+	const char* pruning_method;
+	unsigned int window;
+	bool auto_window;
+
+public:
+	uint64_t seed;
+
+	BlockStability(const DbView* db) throw (Exception);
+	virtual ~BlockStability();
+
+	void add(Partition* partition);
+	unsigned int get_n_replicates();
+	double get_mean_n_blocks();
+
+	void write(const char* output_file_name) throw (Exception);
+
+	double get_memory_usage();
+};
+
+#endif
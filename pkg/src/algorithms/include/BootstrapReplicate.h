@@ -0,0 +1,55 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOOTSTRAPREPLICATE_H_
+#define BOOTSTRAPREPLICATE_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../auxiliary/include/auxiliary.h"
+#include "../../exception/include/Exception.h"
+#include "../../db/include/Db.h"
+#include "../../db/include/DbView.h"
+
+using namespace std;
+
+/*
+ * A bootstrap replicate of the haplotypes of a view: as many haplotypes as in the view are drawn with replacement. The replicate is not
+ * copied; its view shares the bitplanes and markers of the original view and holds the multiplicity of every haplotype as weight planes
+ * (see DbView::haplotype_weights), together with the allele counts and frequencies of the replicate. Replicate r of a seed is always the same.
+ */
+class BootstrapReplicate {
+private:
+	const DbView* db;
+
+	DbView* view;
+	uint64_t* weights;
+
+public:
+	BootstrapReplicate(const DbView* db, uint64_t seed, unsigned int replicate) throw (Exception);
+	virtual ~BootstrapReplicate();
+
+	const DbView* get_view();
+
+	double get_memory_usage();
+};
+
+#endif
@@ -20,56 +20,236 @@
 #ifndef ALGORITHMCI_H_
 #define ALGORITHMCI_H_
 
+#include "../../db/include/Db.h"
 #include "../../db/include/DbView.h"
+#include "../../db/include/PairCounter.h"
 #include "../../writer/include/WriterFactory.h"
+#include "CICache.h"
+#include "PairClassCache.h"
 
 using namespace std;
 
+/*
+ * Binds compute_CI() and classify_bounded() of T at compile time, so that the per-pair steps of T::classify_range() are not dispatched
+ * through the vtable. CI itself binds them through the vtable. Subclasses of CI that provide their own classify_range() must befriend it.
+ */
+template <class T> struct CIBinding;
+
 class CI {
+	template <class T> friend struct CIBinding;
+
 protected:
 	const DbView* db;
 
-	char* observed_haplotype_a;
-	char* observed_haplotype_b;
-
 	unsigned int n_observed_haplotype_ref_a_ref_b;
 	unsigned int n_observed_haplotype_ref_a_alt_b;
 	unsigned int n_observed_haplotype_alt_a_ref_b;
 	unsigned int n_observed_haplotype_alt_a_alt_b;
 
-	char observed_allele_a;
-	char observed_allele_b;
-
-	char observed_ref_allele_a;
-	char observed_alt_allele_a;
-
-	char observed_ref_allele_b;
-	char observed_alt_allele_b;
-
 	double observed_major_af_a;
 	double observed_major_af_b;
 
 	double observed_d;
 
+	CICache* cache;
+	PairClassCache* class_cache;
+
+	double pos_strong_pair_cl;
+	double neg_strong_pair_cl;
+
+	double pos_strong_pair_cu;
+	double neg_strong_pair_cu;
+
+	double pos_recomb_pair_cu;
+	double neg_recomb_pair_cu;
+
+	/* 2x2 tables of the last count_haplotypes_range(), four cells per marker; allocated for db->n_markers markers on first use */
+	unsigned int* range_counts;
+
+	/* bitplane of marker a within the haplotype mask (or a weight plane) of db; allocated on first use if db has a mask or weights */
+	uint64_t* masked_minor_a;
+
+	void count_haplotypes(unsigned int marker_a, unsigned int marker_b);
+	void count_haplotypes_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b) throw (Exception);
+
+	/* Sets the counts and allele frequencies of the pair (marker_a, first_marker_b + b) from range_counts. */
+	void load_range_haplotypes(unsigned int first_marker_b, unsigned int b);
+
+	void compute_observed_d();
+
+	/* Computes the D' CI from the current counts, allele frequencies and observed_d. */
+	virtual void compute_CI(double* dprime_lower_ci, double* dprime_upper_ci);
+
+	/* Same as compute_CI(), but served from the cache (if any) when the pair has no missing alleles. */
+	void compute_cached_CI(double* dprime_lower_ci, double* dprime_upper_ci);
+
+	/* Classifies the pair from the current counts without its exact CI; PAIR_UNKNOWN if this is not conclusive. */
+	virtual unsigned int classify_bounded();
+
+	/* classify() from the current counts */
+	unsigned int classify_counted();
+
+	/* compute_cached_CI(), classify_counted() and classify_range() with the steps of T bound through CIBinding<T> */
+	template <class T> void compute_cached_CI_as(double* dprime_lower_ci, double* dprime_upper_ci);
+	template <class T> unsigned int classify_counted_as();
+	template <class T> void classify_range_as(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception);
+
 public:
+	/* All statistics of a marker pair, obtained from a single count of its 2x2 haplotype table. */
+	struct pair_stats {
+		unsigned int n_ref_a_ref_b;
+		unsigned int n_ref_a_alt_b;
+		unsigned int n_alt_a_ref_b;
+		unsigned int n_alt_a_alt_b;
+
+		double d;
+		double dprime;
+		double r;
+		double rsq;
+
+		double dprime_lower_ci;
+		double dprime_upper_ci;
+	};
+
 	static const char* NONE;
 	static const char* CI_WP;
 	static const char* CI_AV;
 
 	static const double EPSILON;
 
+	/* Pair classes of Gabriel et al. (2002). Pairs with undefined CI are PAIR_OTHER. */
+	static const unsigned int PAIR_UNKNOWN;
+	static const unsigned int PAIR_STRONG_LD;
+	static const unsigned int PAIR_RECOMB;
+	static const unsigned int PAIR_OTHER;
+
 	CI();
 	virtual ~CI();
 
 	void set_dbview(const DbView* db);
+	void set_cache(CICache* cache);
+
+	/* The class cache must be used only with the pair thresholds (and CI method) it was filled with. */
+	void set_class_cache(PairClassCache* class_cache);
+
+	virtual void set_pair_thresholds(double strong_pair_cl, double strong_pair_cu, double recomb_pair_cu);
 
 	double get_D(unsigned int marker_a, unsigned int marker_b);
 	double get_Dprime(unsigned int marker_a, unsigned int marker_b);
 	double get_r(unsigned int marker_a, unsigned int marker_b);
 	double get_rsq(unsigned int marker_a, unsigned int marker_b);
 
-	virtual void get_CI(unsigned int marker_a, unsigned int marker_b, double* dprime_lower_ci, double* dprime_upper_ci);
+	void get_stats(unsigned int marker_a, unsigned int marker_b, pair_stats* stats, bool with_ci);
+
+	void get_CI(unsigned int marker_a, unsigned int marker_b, double* dprime_lower_ci, double* dprime_upper_ci);
+
+	unsigned int classify_CI(double dprime_lower_ci, double dprime_upper_ci);
 
+	/* Same class as classify_CI() on the pair's CI, which is computed only when the cheap bounds are not conclusive. */
+	unsigned int classify(unsigned int marker_a, unsigned int marker_b);
+
+	/* Same as get_CI() and classify() for the pairs (marker_a, first_marker_b + b), b < n_markers_b; results are stored at index b. */
+	void get_CI_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, double* dprime_lower_cis, double* dprime_upper_cis) throw (Exception);
+	void classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception);
+
+};
+
+template <class T> struct CIBinding {
+	static inline void compute_CI(T* ci, double* dprime_lower_ci, double* dprime_upper_ci) {
+		ci->T::compute_CI(dprime_lower_ci, dprime_upper_ci);
+	}
+
+	static inline unsigned int classify_bounded(T* ci) {
+		return ci->T::classify_bounded();
+	}
 };
 
+template <> struct CIBinding<CI> {
+	static inline void compute_CI(CI* ci, double* dprime_lower_ci, double* dprime_upper_ci) {
+		ci->compute_CI(dprime_lower_ci, dprime_upper_ci);
+	}
+
+	static inline unsigned int classify_bounded(CI* ci) {
+		return ci->classify_bounded();
+	}
+};
+
+template <class T> inline void CI::compute_cached_CI_as(double* dprime_lower_ci, double* dprime_upper_ci) {
+	unsigned int counts[4];
+
+	counts[0u] = n_observed_haplotype_ref_a_ref_b;
+	counts[1u] = n_observed_haplotype_ref_a_alt_b;
+	counts[2u] = n_observed_haplotype_alt_a_ref_b;
+	counts[3u] = n_observed_haplotype_alt_a_alt_b;
+
+	/* without missing alleles the allele frequencies, and hence the CI, are determined by the counts alone */
+	if ((cache == NULL) || (counts[0u] + counts[1u] + counts[2u] + counts[3u] != db->n_haplotypes)) {
+		CIBinding<T>::compute_CI(static_cast<T*>(this), dprime_lower_ci, dprime_upper_ci);
+		return;
+	}
+
+	if (!cache->lookup(counts, dprime_lower_ci, dprime_upper_ci)) {
+		CIBinding<T>::compute_CI(static_cast<T*>(this), dprime_lower_ci, dprime_upper_ci);
+		cache->store(counts, *dprime_lower_ci, *dprime_upper_ci);
+	}
+}
+
+template <class T> inline unsigned int CI::classify_counted_as() {
+	unsigned int pair_class = PAIR_UNKNOWN;
+	double dprime_lower_ci = 0.0;
+	double dprime_upper_ci = 0.0;
+
+	pair_class = CIBinding<T>::classify_bounded(static_cast<T*>(this));
+	if (pair_class != PAIR_UNKNOWN) {
+		return pair_class;
+	}
+
+	compute_cached_CI_as<T>(&dprime_lower_ci, &dprime_upper_ci);
+
+	return classify_CI(dprime_lower_ci, dprime_upper_ci);
+}
+
+template <class T> inline void CI::classify_range_as(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception) {
+	unsigned int first_unknown = n_markers_b;
+	unsigned int last_unknown = 0u;
+
+	if (class_cache == NULL) {
+		count_haplotypes_range(marker_a, first_marker_b, n_markers_b);
+
+		for (unsigned int b = 0u; b < n_markers_b; ++b) {
+			load_range_haplotypes(first_marker_b, b);
+			compute_observed_d();
+			pair_classes[b] = classify_counted_as<T>();
+		}
+
+		return;
+	}
+
+	for (unsigned int b = 0u; b < n_markers_b; ++b) {
+		pair_classes[b] = class_cache->lookup(db->indices[marker_a], db->indices[first_marker_b + b]);
+		if (pair_classes[b] == PAIR_UNKNOWN) {
+			if (first_unknown == n_markers_b) {
+				first_unknown = b;
+			}
+			last_unknown = b;
+		}
+	}
+
+	if (first_unknown == n_markers_b) {
+		return;
+	}
+
+	/* only the span of the pairs that are not cached is counted */
+	count_haplotypes_range(marker_a, first_marker_b + first_unknown, last_unknown - first_unknown + 1u);
+
+	for (unsigned int b = first_unknown; b <= last_unknown; ++b) {
+		if (pair_classes[b] == PAIR_UNKNOWN) {
+			load_range_haplotypes(first_marker_b + first_unknown, b - first_unknown);
+			compute_observed_d();
+			pair_classes[b] = classify_counted_as<T>();
+			class_cache->store(db->indices[marker_a], db->indices[first_marker_b + b], pair_classes[b]);
+		}
+	}
+}
+
 #endif
@@ -25,6 +25,8 @@
 using namespace std;
 
 class CIAV: public CI {
+	template <class T> friend struct CIBinding;
+
 private:
 	double var_d;
 
@@ -38,11 +40,16 @@ private:
 	double abs_dprime;
 	double var_dprime;
 
+protected:
+	void compute_CI(double* dprime_lower_ci, double* dprime_upper_ci);
+
 public:
 	CIAV();
 	virtual ~CIAV();
 
-	void get_CI(unsigned int marker_a, unsigned int marker_b, double* dprime_lower_ci, double* dprime_upper_ci);
+	/* CI::classify_range() with the steps of CIAV bound at compile time */
+	void classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception);
+
 };
 
 #endif
@@ -0,0 +1,79 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CICACHE_H_
+#define CICACHE_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "../../exception/include/Exception.h"
+
+using namespace std;
+
+/*
+ * Bounded, direct-mapped cache of D' CIs keyed by the 2x2 haplotype count table.
+ * When the pair has no missing alleles, the CI of a given method and likelihood density depends only on the four counts, so one
+ * cache may be shared by all CI objects of the same configuration (e.g. by all regions processed in parallel by mig_multi_regions).
+ * Entries are split into shards, each with its own OpenMP lock; a colliding store simply replaces the previous entry.
+ */
+class CICache {
+private:
+	struct entry {
+		unsigned int counts[4];
+		double dprime_lower_ci;
+		double dprime_upper_ci;
+	};
+
+	struct shard {
+		entry* entries;
+		uint64_t n_lookups;
+		uint64_t n_hits;
+#ifdef _OPENMP
+		omp_lock_t lock;
+#endif
+	};
+
+	shard* shards;
+	unsigned int n_shards;
+	unsigned int shard_size;
+
+	static uint64_t hash(const unsigned int* counts);
+
+public:
+	static const unsigned int DEFAULT_SIZE;
+	static const unsigned int DEFAULT_N_SHARDS;
+
+	CICache(unsigned int size = DEFAULT_SIZE, unsigned int n_shards = DEFAULT_N_SHARDS) throw (Exception);
+	virtual ~CICache();
+
+	bool lookup(const unsigned int* counts, double* dprime_lower_ci, double* dprime_upper_ci);
+	void store(const unsigned int* counts, double dprime_lower_ci, double dprime_upper_ci);
+
+	double get_n_lookups();
+	double get_n_hits();
+	double get_hit_rate();
+	double get_memory_usage();
+};
+
+#endif
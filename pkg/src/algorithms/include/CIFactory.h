@@ -25,13 +25,14 @@
 #include "CI.h"
 #include "CIWP.h"
 #include "CIAV.h"
+#include "CICache.h"
 
 class CIFactory {
 public:
 	CIFactory();
 	virtual ~CIFactory();
 
-	static CI* create(const char* method, unsigned int likelihood_density = 0u) throw (Exception);
+	static CI* create(const char* method, unsigned int likelihood_density = 0u, CICache* cache = NULL, bool adaptive_likelihood = false) throw (Exception);
 };
 
 #endif
@@ -0,0 +1,125 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CIGROUPS_H_
+#define CIGROUPS_H_
+
+#include <stdlib.h>
+
+#include "../../exception/include/Exception.h"
+#include "CI.h"
+#include "ColumnGroups.h"
+
+using namespace std;
+
+/*
+ * Classifies the pairs of a view through a classifier of type C that works on the view of the column groups (one marker per group):
+ * the pair (a, b) gets the class of the pair of their groups. The groups starting within a range are contiguous in the groups' view,
+ * so they are classified with one call. Does not own the classifier and the groups.
+ */
+template <class C> class CIGroups {
+private:
+	C* classifier;
+	ColumnGroups* groups;
+
+	/* classes of the pairs of the last group with the other groups, and of every group with itself (PAIR_UNKNOWN until first needed) */
+	unsigned int* group_classes;
+	unsigned int* self_classes;
+
+public:
+	CIGroups(C* classifier, ColumnGroups* groups) throw (Exception);
+	virtual ~CIGroups();
+
+	void classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception);
+};
+
+template <class C> CIGroups<C>::CIGroups(C* classifier, ColumnGroups* groups) throw (Exception) :
+		classifier(classifier), groups(groups), group_classes(NULL), self_classes(NULL) {
+
+	group_classes = (unsigned int*)malloc(groups->get_n_groups() * sizeof(unsigned int));
+	self_classes = (unsigned int*)malloc(groups->get_n_groups() * sizeof(unsigned int));
+	if ((group_classes == NULL) || (self_classes == NULL)) {
+		free(group_classes);
+		group_classes = NULL;
+
+		free(self_classes);
+		self_classes = NULL;
+
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	for (unsigned int g = 0u; g < groups->get_n_groups(); ++g) {
+		self_classes[g] = CI::PAIR_UNKNOWN;
+	}
+}
+
+template <class C> CIGroups<C>::~CIGroups() {
+	free(group_classes);
+	group_classes = NULL;
+
+	free(self_classes);
+	self_classes = NULL;
+
+	classifier = NULL;
+	groups = NULL;
+}
+
+template <class C> void CIGroups<C>::classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception) {
+	unsigned int group_a = groups->get_group(marker_a);
+	unsigned int group_b = 0u;
+
+	unsigned int first_group = groups->get_first_group(first_marker_b);
+	unsigned int last_group = groups->get_first_group(first_marker_b + n_markers_b);
+	unsigned int start_group = 0u;
+
+	unsigned int previous_group = groups->get_n_groups();
+	unsigned int previous_class = CI::PAIR_UNKNOWN;
+
+	/* the groups starting within the range; the group of marker_a is left out */
+	if (first_group < group_a) {
+		classifier->classify_range(group_a, first_group, (group_a < last_group ? group_a : last_group) - first_group, group_classes + first_group);
+	}
+
+	start_group = first_group > group_a ? first_group : group_a + 1u;
+	if (start_group < last_group) {
+		classifier->classify_range(group_a, start_group, last_group - start_group, group_classes + start_group);
+	}
+
+	for (unsigned int b = 0u; b < n_markers_b; ++b) {
+		group_b = groups->get_group(first_marker_b + b);
+
+		if (group_b == group_a) {
+			if (self_classes[group_a] == CI::PAIR_UNKNOWN) {
+				classifier->classify_range(group_a, group_a, 1u, self_classes + group_a);
+			}
+			pair_classes[b] = self_classes[group_a];
+		} else if (group_b >= first_group) {
+			pair_classes[b] = group_classes[group_b];
+		} else {
+			/* a group started before the range; its markers in the range are usually adjacent */
+			if (group_b != previous_group) {
+				classifier->classify_range(group_a, group_b, 1u, &previous_class);
+				previous_group = group_b;
+			}
+			pair_classes[b] = previous_class;
+		}
+	}
+}
+
+#endif
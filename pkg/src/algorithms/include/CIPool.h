@@ -0,0 +1,145 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef CIPOOL_H_
+#define CIPOOL_H_
+
+#include <stdlib.h>
+#include <string>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "../../exception/include/Exception.h"
+
+using namespace std;
+
+/*
+ * One classifier of type C per thread. classify_range() splits the range into chunks that the threads classify in parallel, each with
+ * its own classifier; every pair gets the same class as from a single C, so the caller sees exactly the serial result.
+ * The pool owns (and deletes) the classifiers added to it.
+ */
+template <class C> class CIPool {
+private:
+	C** classifiers;
+	unsigned int n_classifiers;
+
+public:
+	static const unsigned int MIN_CHUNK_SIZE = 64u;
+	static const unsigned int CHUNKS_PER_THREAD = 4u;
+
+	CIPool(unsigned int n_threads) throw (Exception);
+	virtual ~CIPool();
+
+	void set_classifier(unsigned int thread, C* classifier);
+	C* get_classifier(unsigned int thread);
+	unsigned int get_n_classifiers();
+
+	void classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception);
+};
+
+template <class C> CIPool<C>::CIPool(unsigned int n_threads) throw (Exception) : classifiers(NULL), n_classifiers(n_threads) {
+	classifiers = (C**)malloc(n_classifiers * sizeof(C*));
+	if (classifiers == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	for (unsigned int t = 0u; t < n_classifiers; ++t) {
+		classifiers[t] = NULL;
+	}
+}
+
+template <class C> CIPool<C>::~CIPool() {
+	for (unsigned int t = 0u; t < n_classifiers; ++t) {
+		delete classifiers[t];
+		classifiers[t] = NULL;
+	}
+
+	free(classifiers);
+	classifiers = NULL;
+}
+
+template <class C> void CIPool<C>::set_classifier(unsigned int thread, C* classifier) {
+	classifiers[thread] = classifier;
+}
+
+template <class C> C* CIPool<C>::get_classifier(unsigned int thread) {
+	return classifiers[thread];
+}
+
+template <class C> unsigned int CIPool<C>::get_n_classifiers() {
+	return n_classifiers;
+}
+
+template <class C> void CIPool<C>::classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception) {
+	unsigned int n_chunks = (n_markers_b + MIN_CHUNK_SIZE - 1u) / MIN_CHUNK_SIZE;
+	unsigned int chunk_size = 0u;
+	bool failed = false;
+	string failure_message;
+
+	if (n_chunks > n_classifiers * CHUNKS_PER_THREAD) {
+		n_chunks = n_classifiers * CHUNKS_PER_THREAD;
+	}
+
+	if ((n_classifiers <= 1u) || (n_chunks <= 1u)) {
+		classifiers[0]->classify_range(marker_a, first_marker_b, n_markers_b, pair_classes);
+		return;
+	}
+
+	chunk_size = (n_markers_b + n_chunks - 1u) / n_chunks;
+
+	/* exceptions must not leave the parallel region: the first message is kept and rethrown after it */
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(n_classifiers) schedule(dynamic, 1)
+#endif
+	for (int chunk = 0; chunk < (int)n_chunks; ++chunk) {
+		unsigned int start = chunk * chunk_size;
+		unsigned int thread = 0u;
+
+		if (start >= n_markers_b) {
+			continue;
+		}
+
+#ifdef _OPENMP
+		thread = omp_get_thread_num();
+#endif
+
+		try {
+			classifiers[thread]->classify_range(marker_a, first_marker_b + start, n_markers_b - start < chunk_size ? n_markers_b - start : chunk_size, pair_classes + start);
+		} catch (Exception &e) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+			{
+				if (!failed) {
+					failure_message = e.what();
+				}
+				failed = true;
+			}
+		}
+	}
+
+	if (failed) {
+		throw Exception(__FILE__, __LINE__, "%s", failure_message.c_str());
+	}
+}
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef CIRSQ_H_
+#define CIRSQ_H_
+
+#include "CI.h"
+
+using namespace std;
+
+/*
+ * Classifies marker pairs by r^2 instead of the D' CI: PAIR_STRONG_LD if r^2 >= strong_pair_rsq, PAIR_RECOMB (weak LD) if
+ * r^2 < weak_pair_rsq, and PAIR_OTHER otherwise or if r^2 is undefined. The class is always decided by classify_bounded().
+ */
+class CIRsq: public CI {
+	template <class T> friend struct CIBinding;
+
+protected:
+	double weak_pair_rsq;
+	double strong_pair_rsq;
+
+	unsigned int classify_bounded();
+
+public:
+	CIRsq();
+	virtual ~CIRsq();
+
+	void set_pair_rsq(double weak_pair_rsq, double strong_pair_rsq);
+
+	/* CI::classify_range() with the steps of CIRsq bound at compile time */
+	void classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception);
+
+};
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CIRSQSAMPLE_H_
+#define CIRSQSAMPLE_H_
+
+#include <math.h>
+
+#include "CIRsq.h"
+
+using namespace std;
+
+/*
+ * CIRsq that first counts every pair on a sample of the haplotypes (HaplotypeSample). The allele frequencies are known exactly, so the
+ * only unknown of r^2 is the frequency of the minor/minor haplotype; by Serfling's bound for sampling without replacement it is within
+ * sample_margin of its sample frequency with the chosen confidence. If all r^2 values within the margin fall into one class, the pair
+ * gets this class; otherwise (and for the pairs with missing alleles) the pair is counted on all haplotypes, as by CIRsq.
+ */
+class CIRsqSample: public CIRsq {
+private:
+	const DbView* sample;
+	double sample_margin;
+
+	/* 2x2 tables of the sample, four cells per marker; allocated for db->n_markers markers on first use */
+	unsigned int* sample_counts;
+
+	unsigned long int n_sampled_pairs;
+	unsigned long int n_exact_pairs;
+
+	/* the class of the pair from its sample table; PAIR_UNKNOWN if it is uncertain */
+	unsigned int classify_sampled(unsigned int marker_a, unsigned int marker_b, const unsigned int* cells);
+
+public:
+	CIRsqSample();
+	virtual ~CIRsqSample();
+
+	/* sample is a view of the same markers as the view of set_dbview(); confidence is per pair, in (0, 1) */
+	void set_sample(const DbView* sample, double confidence);
+
+	void classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception);
+
+	/* pairs classified by classify_range() so far, and those of them that were counted on all haplotypes */
+	unsigned long int get_n_sampled_pairs();
+	unsigned long int get_n_exact_pairs();
+};
+
+#endif
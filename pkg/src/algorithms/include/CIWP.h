@@ -23,33 +23,81 @@
 #include "CI.h"
 #include "../../auxiliary/include/auxiliary.h"
 
+/*
+ * The likelihood grid is evaluated in "omp simd" loops with auxiliary::log_simd/exp_simd (natural log; about 1 ulp) instead of log10/pow(10, x).
+ * Tail areas are summed in the original order. Hence, the CI bounds are the same as with the scalar log10/pow evaluation, except when
+ * a cumulative tail area lies within about 1e-12 (relative) of the 5% cut-off; then a bound may move by one grid step (1 / likelihood_density).
+ *
+ * With the adaptive grid, the log-likelihood is first evaluated on a coarse grid of about sqrt(likelihood_density) points. Being concave
+ * in D' on [0, 1), it is then evaluated densely only where it is within ADAPTIVE_LOG_MARGIN of the coarse maximum (plus the last grid
+ * points); elsewhere the posterior is below exp(-ADAPTIVE_LOG_MARGIN) of its maximum and is taken as zero. The omitted area is far below
+ * the tolerance above, so the bounds are those of the dense grid. It pays off when the likelihood is peaked (large samples, strong LD).
+ *
+ * classify_bounded() evaluates the log-likelihood only at the grid point of the point estimate, at the grid points next to the
+ * thresholds and at the last grid point. By concavity, these bound the tail areas against the posterior at the point estimate.
+ * A class is returned only if the bounds decide it with BOUNDED_MARGIN to spare, so it is the class of the dense grid CI.
+ */
 class CIWP: public CI {
+	template <class T> friend struct CIBinding;
+
 private:
+	static const double MIN_FREQ;
+	static const unsigned int GRID_ALIGNMENT;
+	static const double ADAPTIVE_LOG_MARGIN;
+	static const double BOUNDED_MARGIN;
+
 	unsigned int generation_number;
+	unsigned int grid_size;
 	double* generated_dprime;
-	double generated_freq_haplotype_ref_a_ref_b;
-	double generated_freq_haplotype_ref_a_alt_b;
-	double generated_freq_haplotype_alt_a_ref_b;
-	double generated_freq_haplotype_alt_a_alt_b;
 
+	bool adaptive;
+	unsigned int coarse_step;
+	unsigned int coarse_size;
+	unsigned int n_coarse;
+	unsigned int* coarse_index;
+	double* coarse_dprime;
+	double* coarse_log_likelihood;
+
+	/* natural log */
 	double* log_likelihood;
 	double max_log_likelihood;
 
 	double* posterior_dist;
 	double total_posterior_dist_area;
 	double tail_posterior_dist_area;
-	double covered_posterior_dist_area;
+
+	/* grid ranges [start, end) where the posterior is evaluated; zero elsewhere */
+	unsigned int n_ranges;
+	unsigned int range_start[2];
+	unsigned int range_end[2];
 
 	unsigned int tmp_n_observed_haplotype_ref_a_ref_b;
 	unsigned int tmp_n_observed_haplotype_alt_a_alt_b;
 
 	double dmax;
 
+	/* grid indices of the thresholds; generation_number + 1 if the bounds cannot decide the corresponding class */
+	unsigned int strong_cl_i;
+	unsigned int strong_cu_i;
+	unsigned int recomb_cu_i;
+
+	void locate_ranges();
+	double compute_log_likelihood(const double* dprime, double* ll, unsigned int start, unsigned int end);
+
+protected:
+	void compute_CI(double* dprime_lower_ci, double* dprime_upper_ci);
+	unsigned int classify_bounded();
+
 public:
-	CIWP(unsigned int likelihood_density) throw (Exception);
+	CIWP(unsigned int likelihood_density, bool adaptive = false) throw (Exception);
 	virtual ~CIWP();
 
-	void get_CI(unsigned int marker_a, unsigned int marker_b, double* dprime_lower_ci, double* dprime_upper_ci);
+	void set_adaptive(bool adaptive);
+	void set_pair_thresholds(double strong_pair_cl, double strong_pair_cu, double recomb_pair_cu);
+
+	/* CI::classify_range() with the steps of CIWP bound at compile time */
+	void classify_range(unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* pair_classes) throw (Exception);
+
 };
 
 #endif
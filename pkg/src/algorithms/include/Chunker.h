@@ -0,0 +1,83 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef CHUNKER_H_
+#define CHUNKER_H_
+
+#include <vector>
+
+#include "../../exception/include/Exception.h"
+#include "../../db/include/Db.h"
+#include "../../db/include/DbView.h"
+#include "CI.h"
+#include "Partition.h"
+
+using namespace std;
+
+/*
+ * Splits a view into chunks that can be processed independently and stitches the partitions of the chunks.
+ * A split between markers k and k + 1 is accepted only if no pair (a, b) with k - band < a <= k < b <= k + band is in strong LD.
+ * Every block is delimited by a strong LD pair, so no block crosses an accepted split unless its first or its last marker is more than
+ * band markers away from it. In that case the stitched partition is identical to the partition of the whole view.
+ */
+class Chunker {
+private:
+	struct chunk_block {
+		unsigned int start;
+		unsigned int end;
+		unsigned long int length_bp;
+	};
+
+	const DbView* db;
+	CI* ci;
+
+	unsigned int band;
+	unsigned int* pair_classes;
+
+	vector<unsigned int> chunk_starts;
+
+	bool is_split(unsigned int marker, unsigned int* next_marker) throw (Exception);
+
+	static int chunk_blocks_cmp(const void* first, const void* second);
+
+public:
+	static const unsigned int DEFAULT_BAND;
+
+	Chunker(unsigned int band = DEFAULT_BAND);
+	virtual ~Chunker();
+
+	void set_dbview(const DbView* db);
+	void set_ci(CI* ci);
+
+	/* Finds the splits from left to right, leaving at least min_chunk_size markers in every chunk. */
+	void find_chunks(unsigned int min_chunk_size) throw (Exception);
+
+	unsigned int get_n_chunks();
+	unsigned int get_chunk_start(unsigned int chunk);
+	unsigned int get_chunk_end(unsigned int chunk);
+
+	/* Creates the view of the chunk from the same data and MAF threshold as the view being split. */
+	const DbView* create_chunk_view(Db* full_db, unsigned int chunk) throw (Exception);
+
+	/* Joins the partitions of all chunks (in chunk order) into one partition of the whole view, with the blocks in the order of Algorithm. */
+	Partition* stitch(vector<Partition*>& partitions) throw (Exception);
+};
+
+#endif
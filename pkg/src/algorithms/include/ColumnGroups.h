@@ -0,0 +1,80 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COLUMNGROUPS_H_
+#define COLUMNGROUPS_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../exception/include/Exception.h"
+#include "../../db/include/DbView.h"
+
+using namespace std;
+
+/*
+ * Groups the markers of a view whose haplotype columns (minor allele and missing allele bitplanes) are identical. The bitplanes are coded
+ * by the minor allele, so perfectly complementary columns (r^2 = 1, D' = -1) fall into the same group as well. Every pair of markers
+ * from two groups has the same 2x2 haplotype table, and hence the same class, as the pair of their groups' first markers.
+ * The columns are hashed and only those with equal hashes are compared.
+ */
+class ColumnGroups {
+private:
+	struct column {
+		uint64_t hash;
+		unsigned int marker;
+	};
+
+	const DbView* db;
+
+	/* view of the first marker of every group */
+	DbView* view;
+
+	unsigned int n_groups;
+
+	/* group (i.e. marker of view) of every marker of db */
+	unsigned int* groups;
+
+	/* marker of db of every group */
+	unsigned int* representatives;
+
+	uint64_t hash_column(unsigned int marker);
+	bool is_same_column(unsigned int marker_a, unsigned int marker_b);
+
+	static int compare_columns(const void* first, const void* second);
+
+public:
+	ColumnGroups(const DbView* db) throw (Exception);
+	virtual ~ColumnGroups();
+
+	const DbView* get_view();
+	unsigned int get_n_groups();
+
+	inline unsigned int get_group(unsigned int marker) {
+		return groups[marker];
+	}
+
+	/* the first group whose marker of db is >= marker (n_groups if none) */
+	unsigned int get_first_group(unsigned int marker);
+
+	double get_memory_usage();
+};
+
+#endif
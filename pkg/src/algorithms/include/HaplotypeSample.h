@@ -0,0 +1,55 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HAPLOTYPESAMPLE_H_
+#define HAPLOTYPESAMPLE_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../auxiliary/include/auxiliary.h"
+#include "../../exception/include/Exception.h"
+#include "../../db/include/Db.h"
+#include "../../db/include/DbView.h"
+
+using namespace std;
+
+/*
+ * A simple random sample (without replacement) of the haplotypes of a view. The view of the sample has the same markers, allele
+ * frequencies and indices as the original view, but only the sampled haplotypes in its minor allele bitplanes, and the minor allele
+ * counts of the sample. Missing alleles are not sampled: the pairs of markers with missing alleles must be counted on the original view.
+ */
+class HaplotypeSample {
+private:
+	const DbView* db;
+
+	DbView* view;
+	uint64_t* bitplanes;
+
+public:
+	HaplotypeSample(const DbView* db, unsigned int n_haplotypes, uint64_t seed) throw (Exception);
+	virtual ~HaplotypeSample();
+
+	const DbView* get_view();
+
+	double get_memory_usage();
+};
+
+#endif
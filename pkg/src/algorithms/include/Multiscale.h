@@ -0,0 +1,123 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MULTISCALE_H_
+#define MULTISCALE_H_
+
+#include <math.h>
+#include <vector>
+
+#include "../../auxiliary/include/auxiliary.h"
+#include "../../exception/include/Exception.h"
+#include "../../db/include/DbView.h"
+#include "CI.h"
+#include "Algorithm.h"
+#include "Partition.h"
+#include "PairClassCache.h"
+
+using namespace std;
+
+/*
+ * Coarse-to-fine block detection. The blocks found on a thinned view (every thin_step-th marker with MAF > thin_maf) delimit the regions
+ * worth processing at full resolution: every coarse block widened by margin thinned markers on both sides, with overlapping regions
+ * joined. The exact algorithm runs only on the regions, so a block lying outside of them is missed. Every block found within the
+ * regions is verified against the full-resolution criteria, with the same strong pair fraction test as the algorithm, before it
+ * enters the partition. Every region has a pair class cache, filled by the algorithm of the region and read by the verification, so
+ * the pairs of a block are classified once.
+ */
+class Multiscale {
+private:
+	struct region {
+		unsigned int start;
+		unsigned int end;
+	};
+
+	struct region_block {
+		unsigned int start;
+		unsigned int end;
+		unsigned long int length_bp;
+		unsigned int region;
+	};
+
+	const DbView* db;
+
+	unsigned int thin_step;
+	double thin_maf;
+	unsigned int margin;
+
+	unsigned int* thinned_markers;
+	unsigned int n_thinned_markers;
+	DbView* thinned_db;
+
+	vector<region> regions;
+	vector<DbView*> region_dbs;
+	vector<PairClassCache*> region_class_caches;
+
+	unsigned int n_rejected_blocks;
+	unsigned long int n_calculations;
+
+	bool is_block(CI* ci, PairClassCache* class_cache, Algorithm* algorithm, unsigned int start, unsigned int end, unsigned int* pair_classes) throw (Exception);
+
+	static int regions_cmp(const void* first, const void* second);
+	static int region_blocks_cmp(const void* first, const void* second);
+
+public:
+	static const unsigned int DEFAULT_MARGIN;
+	static const unsigned int CLASS_CACHE_BAND;
+	static const double EPSILON;
+
+	/* thin_maf is NaN if the markers are not thinned by MAF */
+	Multiscale(unsigned int thin_step, double thin_maf, unsigned int margin = DEFAULT_MARGIN);
+	virtual ~Multiscale();
+
+	void set_dbview(const DbView* db);
+
+	/* Creates the view of the thinned markers; NULL if fewer than 2 markers remain. */
+	const DbView* create_thinned_view() throw (Exception);
+
+	/* Finds the regions around the blocks of the partition of the thinned view. */
+	void find_regions(Partition* coarse_partition) throw (Exception);
+
+	unsigned int get_n_regions();
+	unsigned int get_region_start(unsigned int region);
+	unsigned int get_region_end(unsigned int region);
+
+	/* Creates the view of the markers of the region, and its pair class cache (band of at most CLASS_CACHE_BAND Db markers). */
+	const DbView* create_region_view(unsigned int region) throw (Exception);
+
+	/* The algorithm of the region must classify its pairs with the same CI settings as the ci passed to merge(). */
+	PairClassCache* get_region_class_cache(unsigned int region);
+
+	/*
+	 * Joins the partitions of all regions (in region order) into one partition of the whole view, with the blocks in the order of
+	 * Algorithm. A block is kept only if its first and last markers are in strong LD and its informative pairs pass
+	 * algorithm->is_strong_fraction(), with the pairs classified by ci on the whole view.
+	 */
+	Partition* merge(vector<Partition*>& partitions, CI* ci, Algorithm* algorithm) throw (Exception);
+
+	unsigned int get_n_rejected_blocks();
+
+	/* pairs classified by the last merge() to verify the blocks, without the pairs found in the class caches */
+	unsigned long int get_n_calculations();
+
+	/* memory used by the pair class caches of the regions (Mb) */
+	double get_memory_usage();
+};
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PAIRCLASSCACHE_H_
+#define PAIRCLASSCACHE_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "../../exception/include/Exception.h"
+
+using namespace std;
+
+/*
+ * Banded table of pair classes keyed by the marker indices in the Db, 2 bits per pair (0 is CI::PAIR_UNKNOWN, i.e. not classified yet).
+ * The pair (a, b), b < a, is kept in row a if a - b <= band. Because the keys are Db indices, the classes computed in one view are reused
+ * by all views of the same Db, whatever their region or MAF filter, as long as they are classified with the same CI settings. Stores
+ * only set bits with an atomic OR, so the table may be filled by concurrent threads without locks.
+ */
+class PairClassCache {
+private:
+	unsigned int first_marker;
+	unsigned int n_markers;
+	unsigned int band;
+	unsigned int n_row_words;
+
+	uint64_t* words;
+
+	inline uint64_t* get_word(unsigned int marker_a, unsigned int marker_b, unsigned int* shift) {
+		unsigned int offset = marker_a - marker_b - 1u;
+
+		*shift = (offset % PAIRS_PER_WORD) << 1;
+
+		return words + (size_t)(marker_a - first_marker) * n_row_words + offset / PAIRS_PER_WORD;
+	}
+
+	inline bool is_cached(unsigned int marker_a, unsigned int marker_b) {
+		return (marker_b < marker_a) && (marker_b >= first_marker) && (marker_a - first_marker < n_markers) && (marker_a - marker_b <= band);
+	}
+
+public:
+	static const unsigned int PAIRS_PER_WORD;
+
+	/* Keeps the pairs of the Db markers first_marker, ..., first_marker + n_markers - 1. */
+	PairClassCache(unsigned int first_marker, unsigned int n_markers, unsigned int band) throw (Exception);
+	virtual ~PairClassCache();
+
+	unsigned int get_band();
+
+	/* Class of the pair (marker_a, marker_b), 0 if it was not stored or is out of the band. */
+	inline unsigned int lookup(unsigned int marker_a, unsigned int marker_b) {
+		unsigned int shift = 0u;
+		uint64_t word = 0u;
+
+		if (!is_cached(marker_a, marker_b)) {
+			return 0u;
+		}
+
+		uint64_t* address = get_word(marker_a, marker_b, &shift);
+
+#if defined(_OPENMP) && (_OPENMP >= 201107)
+#pragma omp atomic read
+#endif
+		word = *address;
+
+		return (unsigned int)((word >> shift) & 3u);
+	}
+
+	/* Stores the class (1, 2 or 3) of the pair (marker_a, marker_b); does nothing if the pair is out of the band. */
+	inline void store(unsigned int marker_a, unsigned int marker_b, unsigned int pair_class) {
+		unsigned int shift = 0u;
+
+		if (!is_cached(marker_a, marker_b)) {
+			return;
+		}
+
+		uint64_t* address = get_word(marker_a, marker_b, &shift);
+		uint64_t bits = ((uint64_t)(pair_class & 3u)) << shift;
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+		*address |= bits;
+	}
+
+	double get_memory_usage();
+};
+
+#endif
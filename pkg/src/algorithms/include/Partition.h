@@ -61,12 +61,30 @@ public:
 	double strong_pairs_fraction;
 	const char* pruning_method;
 	unsigned int window;
+	bool auto_window;
+
+	unsigned long int max_span_bp;
+	unsigned int max_span_markers;
+
+	/* found by coarse-to-fine detection on every thin_step-th marker with MAF > thin_maf (0 if not used) */
+	unsigned int thin_step;
+	double thin_maf;
+	unsigned int thin_margin;
+
+	/* stitched from n_chunks chunks split at chunk_band (0 if not used); exact only for blocks whose ends are within chunk_band SNPs of every split */
+	unsigned int chunk_band;
+	unsigned int n_chunks;
+
+	/* built from the candidates found before a time budget ran out, with the windows up to reached_window */
+	bool provisional;
+	unsigned int reached_window;
 
 	Partition(const DbView* db) throw (Exception);
 	virtual ~Partition();
 
 	void add_block(unsigned int start, unsigned int end) throw (Exception);
 	unsigned int get_n_blocks();
+	void get_block(unsigned int block_id, unsigned int* start, unsigned int* end);
 
 	void write(const char* output_file_name) throw (Exception);
 
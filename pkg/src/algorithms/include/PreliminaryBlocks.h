@@ -0,0 +1,114 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRELIMINARYBLOCKS_H_
+#define PRELIMINARYBLOCKS_H_
+
+#include <stdlib.h>
+
+#include "../../exception/include/Exception.h"
+#include "../../db/include/DbView.h"
+#include "Partition.h"
+
+using namespace std;
+
+/*
+ * Preliminary (candidate) haplotype blocks, stored per end marker as runs of consecutive start markers. The runs of an end are kept in
+ * ascending order of start and must be added in descending order of start, as all MIG variants do. select() makes the greedy choice
+ * of Algorithm (longest block in base-pairs first, ties by smaller start, skipped if its start or end marker is already in a chosen
+ * block) with a heap of the best remaining block of every end, so the candidates are neither expanded nor sorted.
+ */
+class PreliminaryBlocks {
+private:
+	static const unsigned int NONE;
+
+	struct run {
+		unsigned int first_start;
+		unsigned int last_start;
+		unsigned int next;
+	};
+
+	struct heap_entry {
+		unsigned long int length_bp;
+		unsigned int start;
+		unsigned int end;
+		unsigned int run;
+	};
+
+	unsigned int n_markers;
+	unsigned int* heads;
+
+	run* runs;
+	unsigned int n_runs;
+	unsigned int runs_size;
+
+	unsigned int n_blocks;
+
+	void grow() throw (Exception);
+
+	static inline bool is_before(const heap_entry* first, const heap_entry* second) {
+		return (first->length_bp > second->length_bp) || ((first->length_bp == second->length_bp) && (first->start < second->start));
+	}
+
+	static void push(heap_entry* heap, unsigned int* heap_size, const heap_entry* entry);
+	static void pop(heap_entry* heap, unsigned int* heap_size);
+
+public:
+	PreliminaryBlocks();
+	virtual ~PreliminaryBlocks();
+
+	/* Drops all blocks and prepares for the markers 0, ..., n_markers - 1. */
+	void reset(unsigned int n_markers) throw (Exception);
+
+	inline void add(unsigned int start, unsigned int end) throw (Exception) {
+		run* head = heads[end] != NONE ? runs + heads[end] : NULL;
+
+		++n_blocks;
+
+		if ((head != NULL) && (head->first_start == start + 1u)) {
+			head->first_start = start;
+			return;
+		}
+
+		if ((head != NULL) && (head->first_start <= start)) {
+			throw Exception(__FILE__, __LINE__, "Preliminary block (%u, %u) is not added in descending order of start.", start, end);
+		}
+
+		if (n_runs >= runs_size) {
+			grow();
+		}
+
+		runs[n_runs].first_start = start;
+		runs[n_runs].last_start = start;
+		runs[n_runs].next = heads[end];
+		heads[end] = n_runs;
+
+		++n_runs;
+	}
+
+	unsigned int get_n_blocks();
+
+	/* Adds the chosen blocks to the partition in the order they are chosen. */
+	void select(const DbView* db, Partition* partition) throw (Exception);
+
+	double get_memory_usage();
+};
+
+#endif
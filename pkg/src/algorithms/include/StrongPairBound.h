@@ -0,0 +1,83 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef STRONGPAIRBOUND_H_
+#define STRONGPAIRBOUND_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "../../auxiliary/include/auxiliary.h"
+#include "../../exception/include/Exception.h"
+#include "../../db/include/DbView.h"
+
+using namespace std;
+
+/*
+ * Upper bound on the strong LD pairs that are still to come, for the pruning of MIG+ and MIG++ with r^2 pair classes. The allele
+ * frequencies alone cap r^2: for the frequency odds x and y of two markers, r^2 <= exp(-| |ln x| - |ln y| |). So a marker b can be in
+ * strong LD only with the markers a < b whose |ln odds| is within -ln(strong_pair_rsq) of its own; their number is the candidates of b.
+ * If some marker has missing alleles, the pair frequencies may differ from the marker frequencies, and every a < b is a candidate.
+ */
+class StrongPairBound {
+private:
+	struct marker_key {
+		double key;
+		unsigned int marker;
+	};
+
+	static int marker_key_cmp(const void* first, const void* second);
+
+	unsigned int n_markers;
+	unsigned int* n_candidates;
+
+	/* Fenwick trees over b - n_candidates[b] of the rows b that are left: their number, sum of b and sum of n_candidates[b] */
+	uint64_t* tree_rows;
+	uint64_t* tree_positions;
+	uint64_t* tree_candidates;
+	uint64_t n_rows_candidates;
+
+	void count_candidates(const DbView* db, double strong_pair_rsq) throw (Exception);
+
+public:
+	static const double EPSILON;
+
+	StrongPairBound(const DbView* db, double strong_pair_rsq) throw (Exception);
+	virtual ~StrongPairBound();
+
+	/* The strong LD pairs among any n_pairs pairs (a, marker_b), a < marker_b, can not exceed this. */
+	inline unsigned int get_n_strong_pairs(unsigned int marker_b, unsigned int n_pairs) {
+		return n_pairs < n_candidates[marker_b] ? n_pairs : n_candidates[marker_b];
+	}
+
+	/* Puts all rows b >= 1 in the Fenwick trees. */
+	void reset_rows() throw (Exception);
+
+	/* Removes the row of marker_b, which must still be in the trees. */
+	void remove_row(unsigned int marker_b);
+
+	/* Upper bound on the strong LD pairs (a, b) with a >= marker_j over all rows b that are left; all of them must be > marker_j. */
+	uint64_t get_max_strong_pairs(unsigned int marker_j);
+
+	double get_memory_usage();
+};
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SWEEP_H_
+#define SWEEP_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "../../exception/include/Exception.h"
+#include "../../db/include/DbView.h"
+#include "AlgorithmFactory.h"
+#include "CIFactory.h"
+
+using namespace std;
+
+/*
+ * Runs MIG+ for several settings of the D' CI thresholds and the strong pairs fraction in one pass over the region.
+ * The D' CI of every pair is computed once per row, over the union of the pruning frontiers of all settings; every setting then
+ * classifies the CIs with its own thresholds and accumulates its own weights, exactly as its own MIG+ run would.
+ */
+class Sweep {
+private:
+	struct setting {
+		Algorithm* algorithm;
+		CI* thresholds;
+		void* w_values;
+		long int breakpoint;
+		long int updated_breakpoint;
+	};
+
+	const DbView* db;
+
+	const char* ci_method;
+	unsigned int likelihood_density;
+	bool adaptive_likelihood;
+	CICache* ci_cache;
+
+	vector<setting> settings;
+
+	double* dprime_lower_cis;
+	double* dprime_upper_cis;
+	unsigned int* pair_classes;
+
+	template <class Weight> void scan_row(setting* s, Weight strong_weight, Weight recomb_weight, unsigned int i, long int first) throw (Exception);
+
+	void free_w_values();
+
+public:
+	Sweep();
+	virtual ~Sweep();
+
+	void set_dbview(const DbView* db);
+
+	void set_ci_method(const char* ci_method);
+	void set_likelihood_density(unsigned int likelihood_density);
+	void set_adaptive_likelihood(bool adaptive_likelihood);
+	void set_ci_cache(CICache* ci_cache);
+
+	void add_setting(double strong_pair_cl, double strong_pair_cu, double recomb_pair_cu, double strong_pairs_fraction) throw (Exception);
+	unsigned int get_n_settings();
+
+	void compute_preliminary_blocks() throw (Exception);
+
+	unsigned int get_n_preliminary_blocks(unsigned int setting_id);
+	Partition* get_block_partition(unsigned int setting_id) throw (Exception);
+
+	double get_memory_usage();
+};
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef WEIGHTSCAN_H_
+#define WEIGHTSCAN_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "../../auxiliary/include/auxiliary.h"
+
+using namespace std;
+
+/*
+ * Second phase of a MIG row: once the pairs (j, i) of a row segment are classified into pair_classes[0], ..., pair_classes[n - 1]
+ * (pair_classes[k] is the pair (first + k, i)), every w_values[k] gets the sum of the weights of the pairs k, ..., n - 1 and
+ * initial_sum, the weight of the pairs of the row already computed to the right of the segment. The sum of the row is returned.
+ *
+ * The integer weights are scanned by several kernels (scalar, AVX2), chosen like the kernels of PairCounter. The long double weights
+ * are summed serially in the order of the original loop, so that the rounding does not change.
+ */
+class WeightScan {
+public:
+	typedef bool (*supported_function)();
+	typedef int64_t (*scan_function)(const unsigned int* pair_classes, unsigned int n, int64_t strong_weight, int64_t recomb_weight, int64_t initial_sum, int64_t* w_values);
+
+	struct Kernel {
+		const char* name;
+		supported_function is_supported;
+		scan_function add_suffix_sums;
+	};
+
+private:
+	static const Kernel kernels[];
+	static const unsigned int N_KERNELS;
+
+	static const Kernel* kernel;
+
+	static const Kernel* select_kernel();
+
+public:
+	static const char* get_kernel_name();
+	static bool set_kernel(const char* name);
+
+	static inline int64_t add_suffix_sums(const unsigned int* pair_classes, unsigned int n, int64_t strong_weight, int64_t recomb_weight, int64_t initial_sum, int64_t* w_values) {
+		return kernel->add_suffix_sums(pair_classes, n, strong_weight, recomb_weight, initial_sum, w_values);
+	}
+
+	static long double add_suffix_sums(const unsigned int* pair_classes, unsigned int n, long double strong_weight, long double recomb_weight, long double initial_sum, long double* w_values);
+};
+
+#endif
@@ -93,3 +93,24 @@ double auxiliary::stats_quantile_from_sorted_data(double* data, unsigned int siz
 
 	return (1 - delta) * data[i] + delta * data[i + 1];
 }
+
+void* auxiliary::aligned_malloc(size_t size, size_t alignment) {
+	void* block = NULL;
+	void* aligned = NULL;
+
+	block = malloc(size + alignment + sizeof(void*));
+	if (block == NULL) {
+		return NULL;
+	}
+
+	aligned = (void*)((((uintptr_t)block) + sizeof(void*) + alignment - 1u) & ~((uintptr_t)(alignment - 1u)));
+	((void**)aligned)[-1] = block;
+
+	return aligned;
+}
+
+void auxiliary::aligned_free(void* ptr) {
+	if (ptr != NULL) {
+		free(((void**)ptr)[-1]);
+	}
+}
@@ -24,6 +24,7 @@
 #include <cstring>
 #include <cmath>
 #include <cctype>
+#include <stdint.h>
 
 using namespace std;
 
@@ -34,6 +35,9 @@ namespace auxiliary {
 	int strcmp_ignore_case(const char* first, const char* second, int n);
 	double stats_quantile_from_sorted_data(double* data, unsigned int size, double fraction);
 
+	void* aligned_malloc(size_t size, size_t alignment);
+	void aligned_free(void* ptr);
+
 	inline int fcmp(double x, double y, double epsilon) {
 		int max_exponent = 0;
 		double delta = 0.0;
@@ -53,6 +57,109 @@ namespace auxiliary {
 		}
 	}
 
+	inline unsigned int popcount(uint64_t x) {
+#if defined(__GNUC__)
+		return __builtin_popcountll(x);
+#else
+		x = x - ((x >> 1) & 0x5555555555555555ull);
+		x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+		x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+		return (unsigned int)((x * 0x0101010101010101ull) >> 56);
+#endif
+	}
+
+	/* splitmix64: a fast generator of 64-bit pseudo-random numbers, reproducible from the seed in state */
+	inline uint64_t next_random(uint64_t* state) {
+		uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+		return z ^ (z >> 31);
+	}
+
+	/*
+	 * Branch-free helpers for "omp simd" loops. They use only bit operations, additions, multiplications and divisions, so GCC
+	 * vectorizes them on plain SSE2 at -O2 (floating-point ternaries are not if-converted there because of -ftrapping-math).
+	 * log_simd and exp_simd use the fdlibm polynomials (max. error about 1 ulp).
+	 */
+
+	/* Returns x if x > 0.0, otherwise fallback. x must not be NaN. */
+	inline double select_positive(double x, double fallback) {
+		uint64_t x_bits = 0u;
+		uint64_t fallback_bits = 0u;
+		uint64_t mask = 0u;
+
+		memcpy(&x_bits, &x, sizeof(double));
+		memcpy(&fallback_bits, &fallback, sizeof(double));
+
+		/* all ones if the sign bit is set or x is +0.0 */
+		mask = 0u - ((x_bits >> 63) | ((x_bits - 1u) >> 63));
+		x_bits = (x_bits & ~mask) | (fallback_bits & mask);
+
+		memcpy(&x, &x_bits, sizeof(double));
+
+		return x;
+	}
+
+	/* x must be a positive normal number. */
+	inline double log_simd(double x) {
+		uint64_t bits = 0u;
+		uint64_t k_bits = 0u;
+		double m = 0.0, k = 0.0;
+		double f = 0.0, s = 0.0, z = 0.0, w = 0.0, r = 0.0, hfsq = 0.0;
+
+		memcpy(&bits, &x, sizeof(double));
+
+		/* x = m * 2^k, m in [sqrt(2)/2, sqrt(2)); k is converted to double through the 2^52 mantissa trick */
+		bits += 0x3ff0000000000000ull - 0x3fe6a09e667f3bcdull;
+		k_bits = (bits >> 52) | 0x4330000000000000ull;
+		memcpy(&k, &k_bits, sizeof(double));
+		k -= 4503599627370496.0 + 1023.0;
+
+		bits = (bits & 0x000fffffffffffffull) + 0x3fe6a09e667f3bcdull;
+		memcpy(&m, &bits, sizeof(double));
+
+		f = m - 1.0;
+		s = f / (2.0 + f);
+		z = s * s;
+		w = z * z;
+		r = z * (6.666666666666735130e-01 + w * (2.857142874366239149e-01 + w * (1.818357216161805012e-01 + w * 1.479819860511658591e-01))) +
+				w * (3.999999999940941908e-01 + w * (2.222219843214978396e-01 + w * 1.531383769920937332e-01));
+		hfsq = 0.5 * f * f;
+
+		return s * (hfsq + r) + k * 1.90821492927058770002e-10 - hfsq + f + k * 6.93147180369123816490e-01;
+	}
+
+	/* |x| must be below 2^50. Results below 2^-1022 are returned as about 2^-1022 instead of a subnormal or zero. */
+	inline double exp_simd(double x) {
+		uint64_t bits = 0u;
+		double k = 0.0, t = 0.0;
+		double hi = 0.0, lo = 0.0, r = 0.0, rr = 0.0, c = 0.0, y = 0.0, scale = 0.0;
+
+		/* k = round(x / ln(2)) */
+		k = x * 1.44269504088896338700e+00 + 6755399441055744.0;
+		k -= 6755399441055744.0;
+
+		hi = x - k * 6.93147180369123816490e-01;
+		lo = k * 1.90821492927058770002e-10;
+		r = hi - lo;
+		rr = r * r;
+		c = r - rr * (1.66666666666666019037e-01 + rr * (-2.77777777770155933842e-03 + rr * (6.61375632143793436117e-05 + rr * (-1.65339022054652515390e-06 + rr * 4.13813679705723846039e-08))));
+		y = 1.0 - ((lo - (r * c) / (2.0 - c)) - hi);
+
+		/* 2^k with k clamped to [-1022, 1023]; max/min through fabs are exact for integer valued k */
+		k = 0.5 * ((k - 1022.0) + fabs(k + 1022.0));
+		k = 0.5 * ((k + 1023.0) - fabs(k - 1023.0));
+		t = k + (1023.0 + 6755399441055744.0);
+
+		memcpy(&bits, &t, sizeof(double));
+		bits = (bits & 0x000fffffffffffffull) << 52;
+		memcpy(&scale, &bits, sizeof(double));
+
+		return y * scale;
+	}
+
 	inline int dblcmp(const void* first, const void* second) {
 		double d_first = *(double*)first;
 		double d_second = *(double*)second;
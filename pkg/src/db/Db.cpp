@@ -60,13 +60,15 @@ const unsigned int Db::IMPUTE2_HAP_MANDATORY_COLUMNS_SIZE = 5u;
 
 const unsigned int Db::HEAP_SIZE = 2000000;
 const unsigned int Db::HEAP_INCREMENT = 100000;
+const unsigned int Db::HAPLOTYPE_WORDS_ALIGNMENT = 8u;
 
 const double Db::EPSILON = 0.000000001;
 
 Db::Db() throw (Exception): hap_file_name(NULL), map_file_name(NULL),
 		n_haplotypes(0u), all_n_markers(0u), all_markers(NULL), all_positions(NULL),
-		all_major_alleles(NULL), all_minor_alleles(), all_major_allele_freqs(NULL), all_haplotypes(NULL),
-		current_heap_size(HEAP_SIZE) {
+		all_major_alleles(NULL), all_minor_alleles(), all_major_allele_freqs(NULL),
+		n_haplotype_words(0u), all_minor_haplotypes(NULL), all_missing_haplotypes(NULL), all_n_minor_alleles(NULL),
+		n_population_haplotypes(0u), current_heap_size(HEAP_SIZE) {
 
 	all_markers = (char**)malloc(current_heap_size * sizeof(char*));
 	if (all_markers == NULL) {
@@ -102,13 +104,24 @@ Db::Db() throw (Exception): hap_file_name(NULL), map_file_name(NULL),
 		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
 	}
 
-	all_haplotypes = (char**)malloc(current_heap_size * sizeof(char*));
-	if (all_haplotypes == NULL) {
+	all_minor_haplotypes = (uint64_t**)malloc(current_heap_size * sizeof(uint64_t*));
+	if (all_minor_haplotypes == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	all_missing_haplotypes = (uint64_t**)malloc(current_heap_size * sizeof(uint64_t*));
+	if (all_missing_haplotypes == NULL) {
 		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
 	}
 
 	for (unsigned int i = 0u; i < current_heap_size; ++i) {
-		all_haplotypes[i] = NULL;
+		all_minor_haplotypes[i] = NULL;
+		all_missing_haplotypes[i] = NULL;
+	}
+
+	all_n_minor_alleles = (unsigned int*)malloc(current_heap_size * sizeof(unsigned int));
+	if (all_n_minor_alleles == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
 	}
 }
 
@@ -120,6 +133,16 @@ Db::~Db() {
 	}
 	views.clear();
 
+	for (unsigned int i = 0u; i < population_haplotypes.size(); ++i) {
+		free(population_haplotypes.at(i));
+	}
+	population_haplotypes.clear();
+
+	for (unsigned int i = 0u; i < population_masks.size(); ++i) {
+		auxiliary::aligned_free(population_masks.at(i));
+	}
+	population_masks.clear();
+
 	free_markers(current_heap_size);
 	free_positions(current_heap_size);
 	free_alleles(current_heap_size);
@@ -168,16 +191,33 @@ void Db::free_major_allele_freqs(unsigned int heap_size) {
 }
 
 void Db::free_haplotypes(unsigned int heap_size) {
-	if (all_haplotypes != NULL) {
+	if (all_minor_haplotypes != NULL) {
 		for (unsigned int i = 0u; i < heap_size; ++i) {
-			if (all_haplotypes[i] != NULL) {
-				free(all_haplotypes[i]);
-				all_haplotypes[i] = NULL;
+			if (all_minor_haplotypes[i] != NULL) {
+				auxiliary::aligned_free(all_minor_haplotypes[i]);
+				all_minor_haplotypes[i] = NULL;
 			}
 		}
 
-		free(all_haplotypes);
-		all_haplotypes = NULL;
+		free(all_minor_haplotypes);
+		all_minor_haplotypes = NULL;
+	}
+
+	if (all_missing_haplotypes != NULL) {
+		for (unsigned int i = 0u; i < heap_size; ++i) {
+			if (all_missing_haplotypes[i] != NULL) {
+				auxiliary::aligned_free(all_missing_haplotypes[i]);
+				all_missing_haplotypes[i] = NULL;
+			}
+		}
+
+		free(all_missing_haplotypes);
+		all_missing_haplotypes = NULL;
+	}
+
+	if (all_n_minor_alleles != NULL) {
+		free(all_n_minor_alleles);
+		all_n_minor_alleles = NULL;
 	}
 }
 
@@ -187,7 +227,9 @@ void Db::reallocate() throw (Exception) {
 	char* new_all_major_alleles = NULL;
 	char* new_all_minor_alleles = NULL;
 	double* new_all_major_allele_freqs = NULL;
-	char** new_all_haplotypes = NULL;
+	uint64_t** new_all_minor_haplotypes = NULL;
+	uint64_t** new_all_missing_haplotypes = NULL;
+	unsigned int* new_all_n_minor_alleles = NULL;
 	unsigned int new_heap_size = current_heap_size + HEAP_INCREMENT;
 
 	new_all_markers = (char**)realloc(all_markers, new_heap_size * sizeof(char*));
@@ -234,20 +276,117 @@ void Db::reallocate() throw (Exception) {
 	all_major_allele_freqs = new_all_major_allele_freqs;
 	new_all_major_allele_freqs = NULL;
 
-	new_all_haplotypes = (char**)realloc(all_haplotypes, new_heap_size * sizeof(char*));
-	if (new_all_haplotypes == NULL) {
+	new_all_minor_haplotypes = (uint64_t**)realloc(all_minor_haplotypes, new_heap_size * sizeof(uint64_t*));
+	if (new_all_minor_haplotypes == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory re-allocation.");
+	}
+	all_minor_haplotypes = new_all_minor_haplotypes;
+	new_all_minor_haplotypes = NULL;
+
+	new_all_missing_haplotypes = (uint64_t**)realloc(all_missing_haplotypes, new_heap_size * sizeof(uint64_t*));
+	if (new_all_missing_haplotypes == NULL) {
 		throw Exception(__FILE__, __LINE__, "Error in memory re-allocation.");
 	}
-	all_haplotypes = new_all_haplotypes;
-	new_all_haplotypes = NULL;
+	all_missing_haplotypes = new_all_missing_haplotypes;
+	new_all_missing_haplotypes = NULL;
 
 	for (unsigned int i = current_heap_size; i < new_heap_size; ++i) {
-		all_haplotypes[i] = NULL;
+		all_minor_haplotypes[i] = NULL;
+		all_missing_haplotypes[i] = NULL;
+	}
+
+	new_all_n_minor_alleles = (unsigned int*)realloc(all_n_minor_alleles, new_heap_size * sizeof(unsigned int));
+	if (new_all_n_minor_alleles == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory re-allocation.");
 	}
+	all_n_minor_alleles = new_all_n_minor_alleles;
+	new_all_n_minor_alleles = NULL;
 
 	current_heap_size = new_heap_size;
 }
 
+/* Number of 64-bit words per bitplane, rounded up to a multiple of HAPLOTYPE_WORDS_ALIGNMENT so that every bitplane has the same aligned stride. */
+unsigned int Db::get_n_haplotype_words(unsigned int n_haplotypes) {
+	unsigned int n_words = (n_haplotypes + 63u) >> 6;
+
+	return ((n_words + HAPLOTYPE_WORDS_ALIGNMENT - 1u) / HAPLOTYPE_WORDS_ALIGNMENT) * HAPLOTYPE_WORDS_ALIGNMENT;
+}
+
+uint64_t* Db::allocate_bitplane() throw (Exception) {
+	uint64_t* bitplane = NULL;
+
+	bitplane = (uint64_t*)auxiliary::aligned_malloc(n_haplotype_words * sizeof(uint64_t), HAPLOTYPE_WORDS_ALIGNMENT * sizeof(uint64_t));
+	if (bitplane == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	for (unsigned int w = 0u; w < n_haplotype_words; ++w) {
+		bitplane[w] = 0u;
+	}
+
+	return bitplane;
+}
+
+/* Grows the bitplanes of all loaded markers when haplotypes are appended one at a time (HapMap). */
+/* Reallocates all bitplanes with n_words words, keeping the first min(n_words, n_haplotype_words) words. */
+void Db::resize_bitplanes(unsigned int n_words) throw (Exception) {
+	unsigned int old_n_words = n_haplotype_words < n_words ? n_haplotype_words : n_words;
+	uint64_t* old_bitplane = NULL;
+
+	n_haplotype_words = n_words;
+
+	for (unsigned int i = 0u; i < all_n_markers; ++i) {
+		old_bitplane = all_minor_haplotypes[i];
+		all_minor_haplotypes[i] = allocate_bitplane();
+		if (old_bitplane != NULL) {
+			memcpy(all_minor_haplotypes[i], old_bitplane, old_n_words * sizeof(uint64_t));
+			auxiliary::aligned_free(old_bitplane);
+		}
+
+		old_bitplane = all_missing_haplotypes[i];
+		if (old_bitplane != NULL) {
+			all_missing_haplotypes[i] = allocate_bitplane();
+			memcpy(all_missing_haplotypes[i], old_bitplane, old_n_words * sizeof(uint64_t));
+			auxiliary::aligned_free(old_bitplane);
+		}
+	}
+}
+
+void Db::set_second_allele(unsigned int marker, unsigned int haplotype) {
+	all_minor_haplotypes[marker][haplotype >> 6] |= ((uint64_t)1u) << (haplotype & 63u);
+}
+
+void Db::set_missing_allele(unsigned int marker, unsigned int haplotype) throw (Exception) {
+	if (all_missing_haplotypes[marker] == NULL) {
+		all_missing_haplotypes[marker] = allocate_bitplane();
+	}
+
+	all_missing_haplotypes[marker][haplotype >> 6] |= ((uint64_t)1u) << (haplotype & 63u);
+}
+
+/* Called after major and minor alleles were swapped: the bitplane must mark the new minor allele. Missing and padding bits stay unset. */
+void Db::swap_bitplane(unsigned int marker) {
+	uint64_t* minor_bitplane = all_minor_haplotypes[marker];
+	uint64_t* missing_bitplane = all_missing_haplotypes[marker];
+	unsigned int n_full_words = n_haplotypes >> 6;
+
+	for (unsigned int w = 0u; w < n_haplotype_words; ++w) {
+		minor_bitplane[w] = ~minor_bitplane[w];
+		if (missing_bitplane != NULL) {
+			minor_bitplane[w] &= ~missing_bitplane[w];
+		}
+	}
+
+	if ((n_haplotypes & 63u) != 0u) {
+		minor_bitplane[n_full_words] &= (((uint64_t)1u) << (n_haplotypes & 63u)) - 1u;
+		++n_full_words;
+	}
+
+	for (unsigned int w = n_full_words; w < n_haplotype_words; ++w) {
+		minor_bitplane[w] = 0u;
+	}
+}
+
 void Db::set_hap_file(const char* hap_file_name) {
 	this->hap_file_name = hap_file_name;
 }
@@ -367,6 +506,7 @@ void Db::load_vcf(unsigned long int start_position, unsigned long int end_positi
 		}
 
 		n_haplotypes = 2u * ((unsigned int)sample_number);
+		n_haplotype_words = get_n_haplotype_words(n_haplotypes);
 
 		/* Read data. */
 		tokens = (char**)malloc(total_column_number * sizeof(char*));
@@ -472,10 +612,7 @@ void Db::load_vcf(unsigned long int start_position, unsigned long int end_positi
 				strcpy(all_markers[all_n_markers], tokens[2u]);
 
 				/* tokens[i] with i = 9,...,N are samples */
-				all_haplotypes[all_n_markers] = (char*)malloc(n_haplotypes * sizeof(char));
-				if (all_haplotypes[all_n_markers] == NULL) {
-					throw Exception(__FILE__, __LINE__, "Error in memory allocation");
-				}
+				all_minor_haplotypes[all_n_markers] = allocate_bitplane();
 
 				n_ref_allele = 0u;
 				n_alt_allele = 0u;
@@ -493,27 +630,24 @@ void Db::load_vcf(unsigned long int start_position, unsigned long int end_positi
 						first_allele_index = 2u * (i - 9u);
 						second_allele_index = 2u * (i - 9u) + 1u;
 
-						if ((token[0u] == '.') && (token[2u] == '.')) {
-							all_haplotypes[all_n_markers][first_allele_index] = '.';
-							all_haplotypes[all_n_markers][second_allele_index] = '.';
-						}
-
 						if (token[0u] == '0') {
-							all_haplotypes[all_n_markers][first_allele_index] = all_major_alleles[all_n_markers];
 							++n_ref_allele;
 						} else if (token[0u] == '1') {
-							all_haplotypes[all_n_markers][first_allele_index] = all_minor_alleles[all_n_markers];
+							set_second_allele(all_n_markers, first_allele_index);
 							++n_alt_allele;
+						} else if (token[0u] == '.') {
+							set_missing_allele(all_n_markers, first_allele_index);
 						} else {
 							throw Exception(__FILE__, __LINE__, "Sample %d on line %d in '%s' file has unexpected first allele '%c'.", i - 9, line_number, hap_file_name, token[0u]);
 						}
 
 						if (token[2u] == '0') {
-							all_haplotypes[all_n_markers][second_allele_index] = all_major_alleles[all_n_markers];
 							++n_ref_allele;
 						} else if (token[2u] == '1') {
-							all_haplotypes[all_n_markers][second_allele_index] = all_minor_alleles[all_n_markers];
+							set_second_allele(all_n_markers, second_allele_index);
 							++n_alt_allele;
+						} else if (token[2u] == '.') {
+							set_missing_allele(all_n_markers, second_allele_index);
 						} else {
 							throw Exception(__FILE__, __LINE__, "Sample %d on line %d in '%s' file has unexpected second allele '%c'.", i - 9u, line_number, hap_file_name, token[2u]);
 						}
@@ -528,8 +662,11 @@ void Db::load_vcf(unsigned long int start_position, unsigned long int end_positi
 					all_major_alleles[all_n_markers] = all_minor_alleles[all_n_markers];
 					all_minor_alleles[all_n_markers] = swap_allele;
 					all_major_allele_freqs[all_n_markers] = ((double)n_alt_allele) / ((double)(n_ref_allele + n_alt_allele));
+					all_n_minor_alleles[all_n_markers] = n_ref_allele;
+					swap_bitplane(all_n_markers);
 				} else {
 					all_major_allele_freqs[all_n_markers] = ((double)n_ref_allele) / ((double)(n_ref_allele + n_alt_allele));
+					all_n_minor_alleles[all_n_markers] = n_alt_allele;
 				}
 
 				++all_n_markers;
@@ -638,6 +775,7 @@ void Db::load_vcf() throw (Exception) {
 		}
 
 		n_haplotypes = 2u * ((unsigned int)sample_number);
+		n_haplotype_words = get_n_haplotype_words(n_haplotypes);
 
 		/* Read data. */
 		tokens = (char**)malloc(total_column_number * sizeof(char*));
@@ -742,10 +880,7 @@ void Db::load_vcf() throw (Exception) {
 			strcpy(all_markers[all_n_markers], tokens[2u]);
 
 			/* tokens[i] with i = 9,...,N are samples */
-			all_haplotypes[all_n_markers] = (char*)malloc(n_haplotypes * sizeof(char));
-			if (all_haplotypes[all_n_markers] == NULL) {
-				throw Exception(__FILE__, __LINE__, "Error in memory allocation");
-			}
+			all_minor_haplotypes[all_n_markers] = allocate_bitplane();
 
 			n_ref_allele = 0u;
 			n_alt_allele = 0u;
@@ -763,27 +898,24 @@ void Db::load_vcf() throw (Exception) {
 					first_allele_index = 2u * (i - 9u);
 					second_allele_index = 2u * (i - 9u) + 1u;
 
-					if ((token[0u] == '.') && (token[2u] == '.')) {
-						all_haplotypes[all_n_markers][first_allele_index] = '.';
-						all_haplotypes[all_n_markers][second_allele_index] = '.';
-					}
-
 					if (token[0u] == '0') {
-						all_haplotypes[all_n_markers][first_allele_index] = all_major_alleles[all_n_markers];
 						++n_ref_allele;
 					} else if (token[0u] == '1') {
-						all_haplotypes[all_n_markers][first_allele_index] = all_minor_alleles[all_n_markers];
+						set_second_allele(all_n_markers, first_allele_index);
 						++n_alt_allele;
+					} else if (token[0u] == '.') {
+						set_missing_allele(all_n_markers, first_allele_index);
 					} else {
 						throw Exception(__FILE__, __LINE__, "Sample %d on line %d in '%s' file has unexpected first allele '%c'.", i - 9u, line_number, hap_file_name, token[0u]);
 					}
 
 					if (token[2u] == '0') {
-						all_haplotypes[all_n_markers][second_allele_index] = all_major_alleles[all_n_markers];
 						++n_ref_allele;
 					} else if (token[2u] == '1') {
-						all_haplotypes[all_n_markers][second_allele_index] = all_minor_alleles[all_n_markers];
+						set_second_allele(all_n_markers, second_allele_index);
 						++n_alt_allele;
+					} else if (token[2u] == '.') {
+						set_missing_allele(all_n_markers, second_allele_index);
 					} else {
 						throw Exception(__FILE__, __LINE__, "Sample %d on line %d in '%s' file has unexpected second allele '%c'.", i - 9u, line_number, hap_file_name, token[2u]);
 					}
@@ -798,8 +930,11 @@ void Db::load_vcf() throw (Exception) {
 				all_major_alleles[all_n_markers] = all_minor_alleles[all_n_markers];
 				all_minor_alleles[all_n_markers] = swap_allele;
 				all_major_allele_freqs[all_n_markers] = ((double)n_alt_allele) / ((double)(n_ref_allele + n_alt_allele));
+				all_n_minor_alleles[all_n_markers] = n_ref_allele;
+				swap_bitplane(all_n_markers);
 			} else {
 				all_major_allele_freqs[all_n_markers] = ((double)n_ref_allele) / ((double)(n_ref_allele + n_alt_allele));
+				all_n_minor_alleles[all_n_markers] = n_alt_allele;
 			}
 
 			++all_n_markers;
@@ -845,7 +980,6 @@ void Db::load_hapmap2(unsigned long int start_position, unsigned long int end_po
 	char swap_allele = '\0';
 	unsigned int* n_first_alleles = NULL;
 	unsigned int* n_second_alleles = NULL;
-	char* extended_haplotype = NULL;
 
 	filter = (unsigned char*)malloc(current_filter_size * sizeof(unsigned char));
 	if (filter == NULL) {
@@ -1024,6 +1158,11 @@ void Db::load_hapmap2(unsigned long int start_position, unsigned long int end_po
 				throw Exception(__FILE__, __LINE__, "The number of columns (%d) on line %d in '%s' file is not equal to the expected (%d).", column_number, line_number, hap_file_name, filter_n_markers);
 			}
 
+			/* the number of haplotypes is not known in advance, so the bitplanes are doubled to keep the loading time linear */
+			if (n_haplotypes >= (n_haplotype_words << 6)) {
+				resize_bitplanes(n_haplotype_words > 0u ? 2u * n_haplotype_words : HAPLOTYPE_WORDS_ALIGNMENT);
+			}
+
 			for (unsigned int i = 0u, j = 0u; i < filter_n_markers; ++i) {
 				if (strlen(tokens[i]) != 1u) {
 					throw Exception(__FILE__, __LINE__, "Sample on line %d in '%s' file has incorrect allele value '%s' for marker on position %d.", line_number, hap_file_name, tokens[i], i + 1u);
@@ -1032,19 +1171,11 @@ void Db::load_hapmap2(unsigned long int start_position, unsigned long int end_po
 				}
 
 				if (filter[i] == 0u) {
-					extended_haplotype = (char*)realloc(all_haplotypes[j], (n_haplotypes + 1u) * sizeof(char));
-					if (extended_haplotype == NULL) {
-						throw Exception(__FILE__, __LINE__, "Error in memory re-allocation.");
-					}
-					all_haplotypes[j] = extended_haplotype;
-					extended_haplotype = NULL;
-
 					if (tokens[i][0u] == '0') {
 						++n_first_alleles[j];
-						all_haplotypes[j][n_haplotypes] = all_major_alleles[j];
 					} else if (tokens[i][0u] == '1') {
 						++n_second_alleles[j];
-						all_haplotypes[j][n_haplotypes] = all_minor_alleles[j];
+						set_second_allele(j, n_haplotypes);
 					}
 
 					++j;
@@ -1061,6 +1192,11 @@ void Db::load_hapmap2(unsigned long int start_position, unsigned long int end_po
 		reader->close();
 		delete reader;
 
+		/* the kernels scan all words of a bitplane, so the spare capacity is released */
+		if (n_haplotype_words > get_n_haplotype_words(n_haplotypes)) {
+			resize_bitplanes(get_n_haplotype_words(n_haplotypes));
+		}
+
 		/* Calculate major allele frequencies. */
 		for (unsigned int i = 0u; i < all_n_markers; ++i) {
 			if (n_first_alleles[i] < n_second_alleles[i]) {
@@ -1068,8 +1204,11 @@ void Db::load_hapmap2(unsigned long int start_position, unsigned long int end_po
 				all_major_alleles[i] = all_minor_alleles[i];
 				all_minor_alleles[i] = swap_allele;
 				all_major_allele_freqs[i] = ((double)n_second_alleles[i]) / ((double)(n_first_alleles[i] + n_second_alleles[i]));
+				all_n_minor_alleles[i] = n_first_alleles[i];
+				swap_bitplane(i);
 			} else {
 				all_major_allele_freqs[i] = ((double)n_first_alleles[i]) / ((double)(n_first_alleles[i] + n_second_alleles[i]));
+				all_n_minor_alleles[i] = n_second_alleles[i];
 			}
 		}
 
@@ -1106,7 +1245,6 @@ void Db::load_hapmap2() throw (Exception) {
 	char swap_allele = '\0';
 	unsigned int* n_first_alleles = NULL;
 	unsigned int* n_second_alleles = NULL;
-	char* extended_haplotype = NULL;
 
 	/* Read map file. */
 	try {
@@ -1258,22 +1396,19 @@ void Db::load_hapmap2() throw (Exception) {
 				throw Exception(__FILE__, __LINE__, "The number of columns (%d) on line %d in '%s' file is not equal to the expected (%d).", column_number, line_number, hap_file_name, all_n_markers);
 			}
 
-			for (unsigned int i = 0u; i < all_n_markers; ++i) {
-				extended_haplotype = (char*)realloc(all_haplotypes[i], (n_haplotypes + 1u) * sizeof(char));
-				if (extended_haplotype == NULL) {
-					throw Exception(__FILE__, __LINE__, "Error in memory re-allocation.");
-				}
-				all_haplotypes[i] = extended_haplotype;
-				extended_haplotype = NULL;
+			/* the number of haplotypes is not known in advance, so the bitplanes are doubled to keep the loading time linear */
+			if (n_haplotypes >= (n_haplotype_words << 6)) {
+				resize_bitplanes(n_haplotype_words > 0u ? 2u * n_haplotype_words : HAPLOTYPE_WORDS_ALIGNMENT);
+			}
 
+			for (unsigned int i = 0u; i < all_n_markers; ++i) {
 				if (strlen(tokens[i]) != 1u) {
 					throw Exception(__FILE__, __LINE__, "Sample on line %d in '%s' file has incorrect allele value '%s' for marker on position %d.", line_number, hap_file_name, tokens[i], i + 1u);
 				} else if (tokens[i][0u] == '0') {
 					++n_first_alleles[i];
-					all_haplotypes[i][n_haplotypes] = all_major_alleles[i];
 				} else if (tokens[i][0u] == '1') {
 					++n_second_alleles[i];
-					all_haplotypes[i][n_haplotypes] = all_minor_alleles[i];
+					set_second_allele(i, n_haplotypes);
 				} else {
 					throw Exception(__FILE__, __LINE__, "Sample on line %d in '%s' file has unexpected allele value '%c' for marker on position %d.", line_number, hap_file_name, tokens[i][0u], i + 1u);
 				}
@@ -1289,6 +1424,11 @@ void Db::load_hapmap2() throw (Exception) {
 		reader->close();
 		delete reader;
 
+		/* the kernels scan all words of a bitplane, so the spare capacity is released */
+		if (n_haplotype_words > get_n_haplotype_words(n_haplotypes)) {
+			resize_bitplanes(get_n_haplotype_words(n_haplotypes));
+		}
+
 		/* Calculate major allele frequencies. */
 		for (unsigned int i = 0u; i < all_n_markers; ++i) {
 			if (n_first_alleles[i] < n_second_alleles[i]) {
@@ -1296,8 +1436,11 @@ void Db::load_hapmap2() throw (Exception) {
 				all_major_alleles[i] = all_minor_alleles[i];
 				all_minor_alleles[i] = swap_allele;
 				all_major_allele_freqs[i] = ((double)n_second_alleles[i]) / ((double)(n_first_alleles[i] + n_second_alleles[i]));
+				all_n_minor_alleles[i] = n_first_alleles[i];
+				swap_bitplane(i);
 			} else {
 				all_major_allele_freqs[i] = ((double)n_first_alleles[i]) / ((double)(n_first_alleles[i] + n_second_alleles[i]));
+				all_n_minor_alleles[i] = n_second_alleles[i];
 			}
 		}
 
@@ -1358,6 +1501,7 @@ void Db::load_impute2(unsigned long int start_position, unsigned long int end_po
 		}
 
 		n_haplotypes = total_column_number - IMPUTE2_HAP_MANDATORY_COLUMNS_SIZE;
+		n_haplotype_words = get_n_haplotype_words(n_haplotypes);
 
 		/* Load data. */
 		reader->reset();
@@ -1438,10 +1582,7 @@ void Db::load_impute2(unsigned long int start_position, unsigned long int end_po
 				}
 
 				/* tokens[i] with i = IMPUTE2_HAP_MANDATORY_COLUMNS_SIZE,...,N are samples */
-				all_haplotypes[all_n_markers] = (char*)malloc(n_haplotypes * sizeof(char));
-				if (all_haplotypes[all_n_markers] == NULL) {
-					throw Exception(__FILE__, __LINE__, "Error in memory allocation");
-				}
+				all_minor_haplotypes[all_n_markers] = allocate_bitplane();
 
 				n_first_allele = 0u;
 				n_second_allele = 0u;
@@ -1453,10 +1594,9 @@ void Db::load_impute2(unsigned long int start_position, unsigned long int end_po
 
 					if (tokens[i][0u] == '0') {
 						++n_first_allele;
-						all_haplotypes[all_n_markers][i - IMPUTE2_HAP_MANDATORY_COLUMNS_SIZE] = all_major_alleles[all_n_markers];
 					} else if (tokens[i][0u] == '1') {
 						++n_second_allele;
-						all_haplotypes[all_n_markers][i - IMPUTE2_HAP_MANDATORY_COLUMNS_SIZE] = all_minor_alleles[all_n_markers];
+						set_second_allele(all_n_markers, i - IMPUTE2_HAP_MANDATORY_COLUMNS_SIZE);
 					} else {
 						throw Exception(__FILE__, __LINE__, "The allele value '%s' on line %d in '%s' file is incorrect.", tokens[i], line_number, hap_file_name);
 					}
@@ -1468,8 +1608,11 @@ void Db::load_impute2(unsigned long int start_position, unsigned long int end_po
 					all_major_alleles[all_n_markers] = all_minor_alleles[all_n_markers];
 					all_minor_alleles[all_n_markers] = swap_allele;
 					all_major_allele_freqs[all_n_markers] = ((double)n_second_allele) / ((double)(n_first_allele + n_second_allele));
+					all_n_minor_alleles[all_n_markers] = n_first_allele;
+					swap_bitplane(all_n_markers);
 				} else {
 					all_major_allele_freqs[all_n_markers] = ((double)n_first_allele) / ((double)(n_first_allele + n_second_allele));
+					all_n_minor_alleles[all_n_markers] = n_second_allele;
 				}
 
 				++all_n_markers;
@@ -1534,6 +1677,7 @@ void Db::load_impute2() throw (Exception) {
 		}
 
 		n_haplotypes = total_column_number - IMPUTE2_HAP_MANDATORY_COLUMNS_SIZE;
+		n_haplotype_words = get_n_haplotype_words(n_haplotypes);
 
 		/* Load data. */
 		reader->reset();
@@ -1613,10 +1757,7 @@ void Db::load_impute2() throw (Exception) {
 			}
 
 			/* tokens[i] with i = IMPUTE2_HAP_MANDATORY_COLUMNS_SIZE,...,N are samples */
-			all_haplotypes[all_n_markers] = (char*)malloc(n_haplotypes * sizeof(char));
-			if (all_haplotypes[all_n_markers] == NULL) {
-				throw Exception(__FILE__, __LINE__, "Error in memory allocation");
-			}
+			all_minor_haplotypes[all_n_markers] = allocate_bitplane();
 
 			n_first_allele = 0u;
 			n_second_allele = 0u;
@@ -1628,10 +1769,9 @@ void Db::load_impute2() throw (Exception) {
 
 				if (tokens[i][0u] == '0') {
 					++n_first_allele;
-					all_haplotypes[all_n_markers][i - IMPUTE2_HAP_MANDATORY_COLUMNS_SIZE] = all_major_alleles[all_n_markers];
 				} else if (tokens[i][0u] == '1') {
 					++n_second_allele;
-					all_haplotypes[all_n_markers][i - IMPUTE2_HAP_MANDATORY_COLUMNS_SIZE] = all_minor_alleles[all_n_markers];
+					set_second_allele(all_n_markers, i - IMPUTE2_HAP_MANDATORY_COLUMNS_SIZE);
 				} else {
 					throw Exception(__FILE__, __LINE__, "The allele value '%s' on line %d in '%s' file is incorrect.", tokens[i], line_number, hap_file_name);
 				}
@@ -1643,8 +1783,11 @@ void Db::load_impute2() throw (Exception) {
 				all_major_alleles[all_n_markers] = all_minor_alleles[all_n_markers];
 				all_minor_alleles[all_n_markers] = swap_allele;
 				all_major_allele_freqs[all_n_markers] = ((double)n_second_allele) / ((double)(n_first_allele + n_second_allele));
+				all_n_minor_alleles[all_n_markers] = n_first_allele;
+				swap_bitplane(all_n_markers);
 			} else {
 				all_major_allele_freqs[all_n_markers] = ((double)n_first_allele) / ((double)(n_first_allele + n_second_allele));
+				all_n_minor_alleles[all_n_markers] = n_second_allele;
 			}
 
 			++all_n_markers;
@@ -1665,37 +1808,44 @@ void Db::load_impute2() throw (Exception) {
 	}
 }
 
-const DbView* Db::create_view(double maf_threshold, unsigned long int start_position, unsigned long int end_position) throw (Exception) {
-	DbView* view = NULL;
-
-	unsigned int start_index = 0u;
-	unsigned int end_index = 0u;
-	unsigned int n_markers = 0u;
+bool Db::find_index_range(unsigned long int start_position, unsigned long int end_position, unsigned int* start_index, unsigned int* end_index) {
+	*start_index = 0u;
+	*end_index = 0u;
 
 	if (all_n_markers <= 1u) {
-		return NULL;
+		return false;
 	}
 
 	if ((start_position > 0u) || (end_position != numeric_limits<unsigned long int>::max())) {
 		for (unsigned int i = 0u; i < all_n_markers; ++i) {
-			start_index = i;
+			*start_index = i;
 			if (all_positions[i] >= start_position) {
 				break;
 			}
 		}
 
-		for (long int i = all_n_markers - 1u; i >= start_index; --i) {
-			end_index = (unsigned int)i;
+		for (long int i = all_n_markers - 1u; i >= *start_index; --i) {
+			*end_index = (unsigned int)i;
 			if (all_positions[i] <= end_position) {
 				break;
 			}
 		}
 	} else {
-		start_index = 0u;
-		end_index = all_n_markers - 1u;
+		*start_index = 0u;
+		*end_index = all_n_markers - 1u;
 	}
 
-	if ((end_index - start_index) == 0u) {
+	return (*end_index - *start_index) != 0u;
+}
+
+const DbView* Db::create_view(double maf_threshold, unsigned long int start_position, unsigned long int end_position) throw (Exception) {
+	DbView* view = NULL;
+
+	unsigned int start_index = 0u;
+	unsigned int end_index = 0u;
+	unsigned int n_markers = 0u;
+
+	if (!find_index_range(start_position, end_position, &start_index, &end_index)) {
 		return NULL;
 	}
 
@@ -1750,8 +1900,25 @@ const DbView* Db::create_view(double maf_threshold, unsigned long int start_posi
 		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
 	}
 
-	view->haplotypes = (char**)malloc(view->n_markers * sizeof(char*));
-	if (view->haplotypes == NULL) {
+	view->n_haplotype_words = n_haplotype_words;
+
+	view->minor_haplotypes = (uint64_t**)malloc(view->n_markers * sizeof(uint64_t*));
+	if (view->minor_haplotypes == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	view->missing_haplotypes = (uint64_t**)malloc(view->n_markers * sizeof(uint64_t*));
+	if (view->missing_haplotypes == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	view->n_minor_alleles = (unsigned int*)malloc(view->n_markers * sizeof(unsigned int));
+	if (view->n_minor_alleles == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	view->indices = (unsigned int*)malloc(view->n_markers * sizeof(unsigned int));
+	if (view->indices == NULL) {
 		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
 	}
 
@@ -1767,7 +1934,10 @@ const DbView* Db::create_view(double maf_threshold, unsigned long int start_posi
 				view->major_alleles[j] = all_major_alleles[i];
 				view->minor_alleles[j] = all_minor_alleles[i];
 				view->major_allele_freqs[j] = all_major_allele_freqs[i];
-				view->haplotypes[j] = all_haplotypes[i];
+				view->minor_haplotypes[j] = all_minor_haplotypes[i];
+				view->missing_haplotypes[j] = all_missing_haplotypes[i];
+				view->n_minor_alleles[j] = all_n_minor_alleles[i];
+				view->indices[j] = i;
 
 				++j;
 			}
@@ -1783,7 +1953,10 @@ const DbView* Db::create_view(double maf_threshold, unsigned long int start_posi
 			view->major_alleles[j] = all_major_alleles[i];
 			view->minor_alleles[j] = all_minor_alleles[i];
 			view->major_allele_freqs[j] = all_major_allele_freqs[i];
-			view->haplotypes[j] = all_haplotypes[i];
+			view->minor_haplotypes[j] = all_minor_haplotypes[i];
+			view->missing_haplotypes[j] = all_missing_haplotypes[i];
+			view->n_minor_alleles[j] = all_n_minor_alleles[i];
+			view->indices[j] = i;
 
 			++j;
 		}
@@ -1792,6 +1965,200 @@ const DbView* Db::create_view(double maf_threshold, unsigned long int start_posi
 	return view;
 }
 
+const DbView* Db::create_population_view(double maf_threshold, unsigned long int start_position, unsigned long int end_position,
+		const unsigned int* samples, unsigned int n_samples) throw (Exception) {
+	DbView* view = NULL;
+
+	unsigned int* haplotypes = NULL;
+	uint64_t* mask = NULL;
+	unsigned int population_size = 2u * n_samples;
+
+	unsigned int start_index = 0u;
+	unsigned int end_index = 0u;
+	unsigned int n_markers = 0u;
+
+	unsigned int* n_minor = NULL;
+	unsigned int* n_missing = NULL;
+	double* major_allele_freq = NULL;
+	double minor_allele_freq = 0.0;
+	unsigned int n_valid = 0u;
+
+	if (n_samples == 0u) {
+		throw Exception(__FILE__, __LINE__, "The population has no samples.");
+	}
+
+	for (unsigned int i = 0u; i < n_samples; ++i) {
+		if (samples[i] >= (n_haplotypes >> 1)) {
+			throw Exception(__FILE__, __LINE__, "The sample index %u is out of range.", samples[i] + 1u);
+		}
+	}
+
+	haplotypes = (unsigned int*)malloc(population_size * sizeof(unsigned int));
+	if (haplotypes == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+	population_haplotypes.push_back(haplotypes);
+
+	mask = (uint64_t*)auxiliary::aligned_malloc(n_haplotype_words * sizeof(uint64_t), HAPLOTYPE_WORDS_ALIGNMENT * sizeof(uint64_t));
+	if (mask == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+	population_masks.push_back(mask);
+
+	n_population_haplotypes += population_size;
+
+	memset(mask, 0, n_haplotype_words * sizeof(uint64_t));
+	for (unsigned int i = 0u; i < n_samples; ++i) {
+		haplotypes[2u * i] = 2u * samples[i];
+		haplotypes[2u * i + 1u] = 2u * samples[i] + 1u;
+
+		/* both haplotypes of a sample are in the same word */
+		if ((mask[samples[i] >> 5] & (((uint64_t)3u) << ((2u * samples[i]) & 63u))) != 0u) {
+			throw Exception(__FILE__, __LINE__, "The sample index %u is repeated.", samples[i] + 1u);
+		}
+		mask[samples[i] >> 5] |= ((uint64_t)3u) << ((2u * samples[i]) & 63u);
+	}
+
+	if (!find_index_range(start_position, end_position, &start_index, &end_index)) {
+		return NULL;
+	}
+
+	n_minor = (unsigned int*)malloc((end_index - start_index + 1u) * sizeof(unsigned int));
+	if (n_minor == NULL) {
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	n_missing = (unsigned int*)malloc((end_index - start_index + 1u) * sizeof(unsigned int));
+	if (n_missing == NULL) {
+		free(n_minor);
+		n_minor = NULL;
+
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	major_allele_freq = (double*)malloc((end_index - start_index + 1u) * sizeof(double));
+	if (major_allele_freq == NULL) {
+		free(n_minor);
+		n_minor = NULL;
+
+		free(n_missing);
+		n_missing = NULL;
+
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	/* allele counts of the population are masked popcounts of the Db bitplanes */
+	for (unsigned int i = start_index, k = 0u; i <= end_index; ++i, ++k) {
+		n_minor[k] = 0u;
+		n_missing[k] = 0u;
+		for (unsigned int w = 0u; w < n_haplotype_words; ++w) {
+			n_minor[k] += auxiliary::popcount(all_minor_haplotypes[i][w] & mask[w]);
+		}
+		if (all_missing_haplotypes[i] != NULL) {
+			for (unsigned int w = 0u; w < n_haplotype_words; ++w) {
+				n_missing[k] += auxiliary::popcount(all_missing_haplotypes[i][w] & mask[w]);
+			}
+		}
+
+		n_valid = population_size - n_missing[k];
+		major_allele_freq[k] = n_valid > 0u ? ((double)(n_valid - n_minor[k])) / ((double)n_valid) : 1.0;
+
+		minor_allele_freq = min(major_allele_freq[k], 1.0 - major_allele_freq[k]);
+		if ((isnan(maf_threshold)) || (auxiliary::fcmp(minor_allele_freq, maf_threshold, EPSILON) > 0)) {
+			++n_markers;
+		}
+	}
+
+	if (n_markers <= 1u) {
+		free(n_minor);
+		n_minor = NULL;
+
+		free(n_missing);
+		n_missing = NULL;
+
+		free(major_allele_freq);
+		major_allele_freq = NULL;
+
+		return NULL;
+	}
+
+	try {
+		view = new DbView(maf_threshold, start_position, end_position);
+
+		views.push_back(view);
+
+		view->hap_file_name = hap_file_name;
+		view->map_file_name = map_file_name;
+
+		view->n_haplotypes = population_size;
+
+		view->n_unfiltered_markers = end_index - start_index + 1u;
+		view->n_markers = n_markers;
+
+		view->markers = (char**)malloc(view->n_markers * sizeof(char*));
+		view->positions = (unsigned long int*)malloc(view->n_markers * sizeof(unsigned long int));
+		view->major_alleles = (char*)malloc(view->n_markers * sizeof(char));
+		view->minor_alleles = (char*)malloc(view->n_markers * sizeof(char));
+		view->major_allele_freqs = (double*)malloc(view->n_markers * sizeof(double));
+		view->minor_haplotypes = (uint64_t**)malloc(view->n_markers * sizeof(uint64_t*));
+		view->missing_haplotypes = (uint64_t**)malloc(view->n_markers * sizeof(uint64_t*));
+		view->n_minor_alleles = (unsigned int*)malloc(view->n_markers * sizeof(unsigned int));
+		view->indices = (unsigned int*)malloc(view->n_markers * sizeof(unsigned int));
+
+		if ((view->markers == NULL) || (view->positions == NULL) || (view->major_alleles == NULL) || (view->minor_alleles == NULL) ||
+				(view->major_allele_freqs == NULL) || (view->minor_haplotypes == NULL) || (view->missing_haplotypes == NULL) ||
+				(view->n_minor_alleles == NULL) || (view->indices == NULL)) {
+			throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+		}
+
+		view->n_haplotype_words = n_haplotype_words;
+		view->haplotypes = haplotypes;
+		view->haplotype_mask = mask;
+
+		for (unsigned int i = start_index, j = 0u, k = 0u; i <= end_index; ++i, ++k) {
+			minor_allele_freq = min(major_allele_freq[k], 1.0 - major_allele_freq[k]);
+			if ((!isnan(maf_threshold)) && (auxiliary::fcmp(minor_allele_freq, maf_threshold, EPSILON) <= 0)) {
+				continue;
+			}
+
+			view->markers[j] = all_markers[i];
+			view->positions[j] = all_positions[i];
+			view->major_alleles[j] = all_major_alleles[i];
+			view->minor_alleles[j] = all_minor_alleles[i];
+			view->major_allele_freqs[j] = major_allele_freq[k];
+			view->minor_haplotypes[j] = all_minor_haplotypes[i];
+			/* markers without missing alleles in the population take the faster paths of the pair counting */
+			view->missing_haplotypes[j] = n_missing[k] > 0u ? all_missing_haplotypes[i] : NULL;
+			view->n_minor_alleles[j] = n_minor[k];
+			view->indices[j] = i;
+
+			++j;
+		}
+	} catch (Exception &e) {
+		free(n_minor);
+		n_minor = NULL;
+
+		free(n_missing);
+		n_missing = NULL;
+
+		free(major_allele_freq);
+		major_allele_freq = NULL;
+
+		throw;
+	}
+
+	free(n_minor);
+	n_minor = NULL;
+
+	free(n_missing);
+	n_missing = NULL;
+
+	free(major_allele_freq);
+	major_allele_freq = NULL;
+
+	return view;
+}
+
 unsigned int Db::get_n_haplotypes() {
 	return n_haplotypes;
 }
@@ -1808,6 +2175,9 @@ double Db::get_memory_usage() {
 		memory_usage += (*views_it)->get_memory_usage();
 	}
 
+	memory_usage += (n_population_haplotypes * sizeof(unsigned int)) / 1048576.0;
+	memory_usage += (population_masks.size() * n_haplotype_words * sizeof(uint64_t)) / 1048576.0;
+
 	memory_usage += (current_heap_size * sizeof(char*)) / 1048576.0;
 	for (unsigned int i = 0u; i < current_heap_size; ++i) {
 		if (all_markers[i] != NULL) {
@@ -1819,10 +2189,14 @@ double Db::get_memory_usage() {
 	memory_usage += (2u * current_heap_size * sizeof(char)) / 1048576.0;
 	memory_usage += (current_heap_size * sizeof(double)) / 1048576.0;
 
-	memory_usage += (current_heap_size * sizeof(char*)) / 1048576.0;
+	memory_usage += (2u * current_heap_size * sizeof(uint64_t*)) / 1048576.0;
+	memory_usage += (current_heap_size * sizeof(unsigned int)) / 1048576.0;
 	for (unsigned int i = 0u; i < current_heap_size; ++i) {
-		if (all_haplotypes[i] != NULL) {
-			memory_usage += (n_haplotypes * sizeof(char)) / 1048576.0;
+		if (all_minor_haplotypes[i] != NULL) {
+			memory_usage += (n_haplotype_words * sizeof(uint64_t)) / 1048576.0;
+		}
+		if (all_missing_haplotypes[i] != NULL) {
+			memory_usage += (n_haplotype_words * sizeof(uint64_t)) / 1048576.0;
 		}
 	}
 
@@ -23,7 +23,10 @@ DbView::DbView(double maf_threshold, unsigned long int start_position, unsigned
 	hap_file_name(NULL), map_file_name(NULL),
 	maf_threshold(maf_threshold), start_position(start_position), end_position(end_position),
 	n_unfiltered_markers(0u), n_haplotypes(0u), n_markers(0u), markers(NULL), positions(NULL),
-	major_alleles(NULL), minor_alleles(NULL), major_allele_freqs(NULL), haplotypes(NULL) {
+	major_alleles(NULL), minor_alleles(NULL), major_allele_freqs(NULL),
+	n_haplotype_words(0u), minor_haplotypes(NULL), missing_haplotypes(NULL), n_minor_alleles(NULL),
+	indices(NULL), haplotypes(NULL), haplotype_mask(NULL),
+	haplotype_weights(NULL), n_haplotype_weight_planes(0u) {
 
 }
 
@@ -53,12 +56,76 @@ DbView::~DbView() {
 		major_allele_freqs = NULL;
 	}
 
-	if (haplotypes != NULL) {
-		free(haplotypes);
-		haplotypes = NULL;
+	if (minor_haplotypes != NULL) {
+		free(minor_haplotypes);
+		minor_haplotypes = NULL;
+	}
+
+	if (missing_haplotypes != NULL) {
+		free(missing_haplotypes);
+		missing_haplotypes = NULL;
+	}
+
+	if (n_minor_alleles != NULL) {
+		free(n_minor_alleles);
+		n_minor_alleles = NULL;
+	}
+
+	if (indices != NULL) {
+		free(indices);
+		indices = NULL;
 	}
 }
 
+DbView* DbView::create_subview(const unsigned int* markers, unsigned int n_markers) const throw (Exception) {
+	DbView* view = new DbView(maf_threshold, start_position, end_position);
+
+	view->hap_file_name = hap_file_name;
+	view->map_file_name = map_file_name;
+
+	view->n_unfiltered_markers = n_unfiltered_markers;
+	view->n_haplotypes = n_haplotypes;
+	view->n_haplotype_words = n_haplotype_words;
+	view->n_markers = n_markers;
+	view->haplotypes = haplotypes;
+	view->haplotype_mask = haplotype_mask;
+	view->haplotype_weights = haplotype_weights;
+	view->n_haplotype_weight_planes = n_haplotype_weight_planes;
+
+	view->markers = (char**)malloc(n_markers * sizeof(char*));
+	view->positions = (unsigned long int*)malloc(n_markers * sizeof(unsigned long int));
+	view->major_alleles = (char*)malloc(n_markers * sizeof(char));
+	view->minor_alleles = (char*)malloc(n_markers * sizeof(char));
+	view->major_allele_freqs = (double*)malloc(n_markers * sizeof(double));
+	view->minor_haplotypes = (uint64_t**)malloc(n_markers * sizeof(uint64_t*));
+	view->missing_haplotypes = (uint64_t**)malloc(n_markers * sizeof(uint64_t*));
+	view->n_minor_alleles = (unsigned int*)malloc(n_markers * sizeof(unsigned int));
+	view->indices = (unsigned int*)malloc(n_markers * sizeof(unsigned int));
+
+	if ((view->markers == NULL) || (view->positions == NULL) || (view->major_alleles == NULL) || (view->minor_alleles == NULL) ||
+			(view->major_allele_freqs == NULL) || (view->minor_haplotypes == NULL) || (view->missing_haplotypes == NULL) ||
+			(view->n_minor_alleles == NULL) || (view->indices == NULL)) {
+		delete view;
+		view = NULL;
+
+		throw Exception(__FILE__, __LINE__, "Error in memory allocation.");
+	}
+
+	for (unsigned int i = 0u; i < n_markers; ++i) {
+		view->markers[i] = this->markers[markers[i]];
+		view->positions[i] = positions[markers[i]];
+		view->major_alleles[i] = major_alleles[markers[i]];
+		view->minor_alleles[i] = minor_alleles[markers[i]];
+		view->major_allele_freqs[i] = major_allele_freqs[markers[i]];
+		view->minor_haplotypes[i] = minor_haplotypes[markers[i]];
+		view->missing_haplotypes[i] = missing_haplotypes[markers[i]];
+		view->n_minor_alleles[i] = n_minor_alleles[markers[i]];
+		view->indices[i] = indices[markers[i]];
+	}
+
+	return view;
+}
+
 double DbView::get_memory_usage() {
 	double memory_usage = 0.0;
 
@@ -82,8 +149,20 @@ double DbView::get_memory_usage() {
 		memory_usage += (n_markers * sizeof(double)) / 1048576.0;
 	}
 
-	if (haplotypes != NULL) {
-		memory_usage += (n_markers * sizeof(char*)) / 1048576.0;
+	if (minor_haplotypes != NULL) {
+		memory_usage += (n_markers * sizeof(uint64_t*)) / 1048576.0;
+	}
+
+	if (missing_haplotypes != NULL) {
+		memory_usage += (n_markers * sizeof(uint64_t*)) / 1048576.0;
+	}
+
+	if (n_minor_alleles != NULL) {
+		memory_usage += (n_markers * sizeof(unsigned int)) / 1048576.0;
+	}
+
+	if (indices != NULL) {
+		memory_usage += (n_markers * sizeof(unsigned int)) / 1048576.0;
 	}
 
 	return memory_usage;
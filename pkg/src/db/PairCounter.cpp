@@ -0,0 +1,545 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/PairCounter.h"
+
+/*
+ * SIMD kernels are compiled with per-function target attributes, so the package itself is built without any -m flags and runs on every x86 host.
+ * AVX2 and AVX-512 are left out on Windows, where GCC does not align the stack for 256/512-bit spills.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PAIRCOUNTER_X86
+#include <immintrin.h>
+#if !defined(_WIN32)
+#define PAIRCOUNTER_X86_AVX2
+#if defined(__clang__) || (__GNUC__ >= 8)
+#define PAIRCOUNTER_X86_AVX512
+#endif
+#endif
+#endif
+
+/* counts[0] = minor_a & minor_b, counts[1] = minor_a & ~missing_b, counts[2] = minor_b & ~missing_a, counts[3] = missing_a | missing_b */
+
+static bool scalar_is_supported() {
+	return true;
+}
+
+static unsigned int scalar_count_and(const uint64_t* minor_a, const uint64_t* minor_b, unsigned int n_words) {
+	unsigned int n = 0u;
+
+	for (unsigned int w = 0u; w < n_words; ++w) {
+		n += auxiliary::popcount(minor_a[w] & minor_b[w]);
+	}
+
+	return n;
+}
+
+static void scalar_count_and_range(const uint64_t* minor_a, const uint64_t* const* minor_b, unsigned int n_markers_b, unsigned int n_words, unsigned int* n) {
+	for (unsigned int b = 0u; b < n_markers_b; ++b) {
+		n[b << 2] = scalar_count_and(minor_a, minor_b[b], n_words);
+	}
+}
+
+static void scalar_count_masked(const uint64_t* minor_a, const uint64_t* minor_b, const uint64_t* missing_a, const uint64_t* missing_b, unsigned int n_words, unsigned int* counts) {
+	counts[0u] = counts[1u] = counts[2u] = counts[3u] = 0u;
+
+	for (unsigned int w = 0u; w < n_words; ++w) {
+		counts[0u] += auxiliary::popcount(minor_a[w] & minor_b[w]);
+		counts[1u] += auxiliary::popcount(minor_a[w] & ~missing_b[w]);
+		counts[2u] += auxiliary::popcount(minor_b[w] & ~missing_a[w]);
+		counts[3u] += auxiliary::popcount(missing_a[w] | missing_b[w]);
+	}
+}
+
+#ifdef PAIRCOUNTER_X86
+static bool sse42_is_supported() {
+	return __builtin_cpu_supports("popcnt") && __builtin_cpu_supports("sse4.2");
+}
+
+__attribute__((target("sse4.2,popcnt")))
+static unsigned int sse42_count_and(const uint64_t* minor_a, const uint64_t* minor_b, unsigned int n_words) {
+	unsigned int n = 0u;
+
+	for (unsigned int w = 0u; w < n_words; ++w) {
+		n += __builtin_popcountll(minor_a[w] & minor_b[w]);
+	}
+
+	return n;
+}
+
+__attribute__((target("sse4.2,popcnt")))
+static void sse42_count_and_range(const uint64_t* minor_a, const uint64_t* const* minor_b, unsigned int n_markers_b, unsigned int n_words, unsigned int* n) {
+	const uint64_t* minor = NULL;
+	unsigned int n_and = 0u;
+
+	for (unsigned int b = 0u; b < n_markers_b; ++b) {
+		minor = minor_b[b];
+		n_and = 0u;
+		for (unsigned int w = 0u; w < n_words; ++w) {
+			n_and += __builtin_popcountll(minor_a[w] & minor[w]);
+		}
+		n[b << 2] = n_and;
+	}
+}
+
+__attribute__((target("sse4.2,popcnt")))
+static void sse42_count_masked(const uint64_t* minor_a, const uint64_t* minor_b, const uint64_t* missing_a, const uint64_t* missing_b, unsigned int n_words, unsigned int* counts) {
+	counts[0u] = counts[1u] = counts[2u] = counts[3u] = 0u;
+
+	for (unsigned int w = 0u; w < n_words; ++w) {
+		counts[0u] += __builtin_popcountll(minor_a[w] & minor_b[w]);
+		counts[1u] += __builtin_popcountll(minor_a[w] & ~missing_b[w]);
+		counts[2u] += __builtin_popcountll(minor_b[w] & ~missing_a[w]);
+		counts[3u] += __builtin_popcountll(missing_a[w] | missing_b[w]);
+	}
+}
+#endif
+
+#ifdef PAIRCOUNTER_X86_AVX2
+static bool avx2_is_supported() {
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+}
+
+/* Nibble lookup popcount: per-byte counts are summed into four 64-bit lanes with SAD. */
+__attribute__((target("avx2")))
+static inline __m256i avx2_popcount(__m256i v) {
+	const __m256i lookup = _mm256_setr_epi8(
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i low_mask = _mm256_set1_epi8(0x0f);
+	__m256i low = _mm256_and_si256(v, low_mask);
+	__m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+
+	return _mm256_sad_epu8(_mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high)), _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+static inline unsigned int avx2_sum(__m256i v) {
+	uint64_t lanes[4u];
+
+	_mm256_storeu_si256((__m256i*)lanes, v);
+
+	return (unsigned int)(lanes[0u] + lanes[1u] + lanes[2u] + lanes[3u]);
+}
+
+__attribute__((target("avx2,popcnt")))
+static unsigned int avx2_count_and(const uint64_t* minor_a, const uint64_t* minor_b, unsigned int n_words) {
+	__m256i n = _mm256_setzero_si256();
+	unsigned int n_vectors = n_words >> 2;
+	unsigned int tail = 0u;
+
+	for (unsigned int v = 0u; v < n_vectors; ++v) {
+		n = _mm256_add_epi64(n, avx2_popcount(_mm256_and_si256(
+				_mm256_load_si256((const __m256i*)minor_a + v), _mm256_load_si256((const __m256i*)minor_b + v))));
+	}
+
+	for (unsigned int w = n_vectors << 2; w < n_words; ++w) {
+		tail += __builtin_popcountll(minor_a[w] & minor_b[w]);
+	}
+
+	return avx2_sum(n) + tail;
+}
+
+__attribute__((target("avx2,popcnt")))
+static void avx2_count_and_range(const uint64_t* minor_a, const uint64_t* const* minor_b, unsigned int n_markers_b, unsigned int n_words, unsigned int* n) {
+	__m256i n_and;
+	const uint64_t* minor = NULL;
+	unsigned int n_vectors = n_words >> 2;
+	unsigned int tail = 0u;
+
+	for (unsigned int b = 0u; b < n_markers_b; ++b) {
+		minor = minor_b[b];
+		n_and = _mm256_setzero_si256();
+		for (unsigned int v = 0u; v < n_vectors; ++v) {
+			n_and = _mm256_add_epi64(n_and, avx2_popcount(_mm256_and_si256(
+					_mm256_load_si256((const __m256i*)minor_a + v), _mm256_load_si256((const __m256i*)minor + v))));
+		}
+
+		tail = 0u;
+		for (unsigned int w = n_vectors << 2; w < n_words; ++w) {
+			tail += __builtin_popcountll(minor_a[w] & minor[w]);
+		}
+
+		n[b << 2] = avx2_sum(n_and) + tail;
+	}
+}
+
+__attribute__((target("avx2,popcnt")))
+static void avx2_count_masked(const uint64_t* minor_a, const uint64_t* minor_b, const uint64_t* missing_a, const uint64_t* missing_b, unsigned int n_words, unsigned int* counts) {
+	__m256i n[4u];
+	__m256i a, b, ma, mb;
+	unsigned int n_vectors = n_words >> 2;
+
+	n[0u] = n[1u] = n[2u] = n[3u] = _mm256_setzero_si256();
+
+	for (unsigned int v = 0u; v < n_vectors; ++v) {
+		a = _mm256_load_si256((const __m256i*)minor_a + v);
+		b = _mm256_load_si256((const __m256i*)minor_b + v);
+		ma = _mm256_load_si256((const __m256i*)missing_a + v);
+		mb = _mm256_load_si256((const __m256i*)missing_b + v);
+
+		n[0u] = _mm256_add_epi64(n[0u], avx2_popcount(_mm256_and_si256(a, b)));
+		n[1u] = _mm256_add_epi64(n[1u], avx2_popcount(_mm256_andnot_si256(mb, a)));
+		n[2u] = _mm256_add_epi64(n[2u], avx2_popcount(_mm256_andnot_si256(ma, b)));
+		n[3u] = _mm256_add_epi64(n[3u], avx2_popcount(_mm256_or_si256(ma, mb)));
+	}
+
+	for (unsigned int i = 0u; i < 4u; ++i) {
+		counts[i] = avx2_sum(n[i]);
+	}
+
+	for (unsigned int w = n_vectors << 2; w < n_words; ++w) {
+		counts[0u] += __builtin_popcountll(minor_a[w] & minor_b[w]);
+		counts[1u] += __builtin_popcountll(minor_a[w] & ~missing_b[w]);
+		counts[2u] += __builtin_popcountll(minor_b[w] & ~missing_a[w]);
+		counts[3u] += __builtin_popcountll(missing_a[w] | missing_b[w]);
+	}
+}
+#endif
+
+#ifdef PAIRCOUNTER_X86_AVX512
+static bool avx512_is_supported() {
+	return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq");
+}
+
+/* Plain stores and xor/and are used instead of _mm512_reduce_add_epi64() and _mm512_andnot_si512(), which trigger uninitialized-value warnings in GCC headers. */
+__attribute__((target("avx512f")))
+static inline unsigned int avx512_sum(__m512i v) {
+	uint64_t lanes[8u];
+	uint64_t sum = 0u;
+
+	_mm512_storeu_si512((void*)lanes, v);
+	for (unsigned int i = 0u; i < 8u; ++i) {
+		sum += lanes[i];
+	}
+
+	return (unsigned int)sum;
+}
+
+__attribute__((target("avx512f")))
+static inline __m512i avx512_andnot(__m512i mask, __m512i v) {
+	return _mm512_xor_si512(v, _mm512_and_si512(v, mask));
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+static unsigned int avx512_count_and(const uint64_t* minor_a, const uint64_t* minor_b, unsigned int n_words) {
+	__m512i n = _mm512_setzero_si512();
+	unsigned int n_vectors = n_words >> 3;
+	unsigned int tail = 0u;
+
+	for (unsigned int v = 0u; v < n_vectors; ++v) {
+		n = _mm512_add_epi64(n, _mm512_popcnt_epi64(_mm512_and_si512(
+				_mm512_load_si512((const void*)(minor_a + (v << 3))), _mm512_load_si512((const void*)(minor_b + (v << 3))))));
+	}
+
+	for (unsigned int w = n_vectors << 3; w < n_words; ++w) {
+		tail += __builtin_popcountll(minor_a[w] & minor_b[w]);
+	}
+
+	return avx512_sum(n) + tail;
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+static void avx512_count_and_range(const uint64_t* minor_a, const uint64_t* const* minor_b, unsigned int n_markers_b, unsigned int n_words, unsigned int* n) {
+	__m512i n_and;
+	const uint64_t* minor = NULL;
+	unsigned int n_vectors = n_words >> 3;
+	unsigned int tail = 0u;
+
+	for (unsigned int b = 0u; b < n_markers_b; ++b) {
+		minor = minor_b[b];
+		n_and = _mm512_setzero_si512();
+		for (unsigned int v = 0u; v < n_vectors; ++v) {
+			n_and = _mm512_add_epi64(n_and, _mm512_popcnt_epi64(_mm512_and_si512(
+					_mm512_load_si512((const void*)(minor_a + (v << 3))), _mm512_load_si512((const void*)(minor + (v << 3))))));
+		}
+
+		tail = 0u;
+		for (unsigned int w = n_vectors << 3; w < n_words; ++w) {
+			tail += __builtin_popcountll(minor_a[w] & minor[w]);
+		}
+
+		n[b << 2] = avx512_sum(n_and) + tail;
+	}
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+static void avx512_count_masked(const uint64_t* minor_a, const uint64_t* minor_b, const uint64_t* missing_a, const uint64_t* missing_b, unsigned int n_words, unsigned int* counts) {
+	__m512i n[4u];
+	__m512i a, b, ma, mb;
+	unsigned int n_vectors = n_words >> 3;
+
+	n[0u] = n[1u] = n[2u] = n[3u] = _mm512_setzero_si512();
+
+	for (unsigned int v = 0u; v < n_vectors; ++v) {
+		a = _mm512_load_si512((const void*)(minor_a + (v << 3)));
+		b = _mm512_load_si512((const void*)(minor_b + (v << 3)));
+		ma = _mm512_load_si512((const void*)(missing_a + (v << 3)));
+		mb = _mm512_load_si512((const void*)(missing_b + (v << 3)));
+
+		n[0u] = _mm512_add_epi64(n[0u], _mm512_popcnt_epi64(_mm512_and_si512(a, b)));
+		n[1u] = _mm512_add_epi64(n[1u], _mm512_popcnt_epi64(avx512_andnot(mb, a)));
+		n[2u] = _mm512_add_epi64(n[2u], _mm512_popcnt_epi64(avx512_andnot(ma, b)));
+		n[3u] = _mm512_add_epi64(n[3u], _mm512_popcnt_epi64(_mm512_or_si512(ma, mb)));
+	}
+
+	for (unsigned int i = 0u; i < 4u; ++i) {
+		counts[i] = avx512_sum(n[i]);
+	}
+
+	for (unsigned int w = n_vectors << 3; w < n_words; ++w) {
+		counts[0u] += __builtin_popcountll(minor_a[w] & minor_b[w]);
+		counts[1u] += __builtin_popcountll(minor_a[w] & ~missing_b[w]);
+		counts[2u] += __builtin_popcountll(minor_b[w] & ~missing_a[w]);
+		counts[3u] += __builtin_popcountll(missing_a[w] | missing_b[w]);
+	}
+}
+#endif
+
+/* Ordered from the widest to the narrowest; the scalar kernel must stay last. */
+const PairCounter::Kernel PairCounter::kernels[] = {
+#ifdef PAIRCOUNTER_X86_AVX512
+		{ "AVX-512 VPOPCNTDQ", avx512_is_supported, avx512_count_and, avx512_count_masked, avx512_count_and_range },
+#endif
+#ifdef PAIRCOUNTER_X86_AVX2
+		{ "AVX2", avx2_is_supported, avx2_count_and, avx2_count_masked, avx2_count_and_range },
+#endif
+#ifdef PAIRCOUNTER_X86
+		{ "SSE4.2", sse42_is_supported, sse42_count_and, sse42_count_masked, sse42_count_and_range },
+#endif
+		{ "scalar", scalar_is_supported, scalar_count_and, scalar_count_masked, scalar_count_and_range }
+};
+
+const unsigned int PairCounter::N_KERNELS = sizeof(PairCounter::kernels) / sizeof(PairCounter::Kernel);
+
+const PairCounter::Kernel* PairCounter::kernel = PairCounter::select_kernel();
+
+const PairCounter::Kernel* PairCounter::select_kernel() {
+#ifdef PAIRCOUNTER_X86
+	__builtin_cpu_init();
+#endif
+
+	for (unsigned int i = 0u; i < N_KERNELS; ++i) {
+		if (kernels[i].is_supported()) {
+			return &kernels[i];
+		}
+	}
+
+	return &kernels[N_KERNELS - 1u];
+}
+
+const char* PairCounter::get_kernel_name() {
+	return kernel->name;
+}
+
+bool PairCounter::set_kernel(const char* name) {
+	for (unsigned int i = 0u; i < N_KERNELS; ++i) {
+		if ((auxiliary::strcmp_ignore_case(kernels[i].name, name) == 0) && (kernels[i].is_supported())) {
+			kernel = &kernels[i];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* counts[0] = n(minor_a & minor_b), counts[1] = n(minor_a & ~missing_b), counts[2] = n(minor_b & ~missing_a), counts[3] = n(missing_a | missing_b) within the mask */
+void PairCounter::count_population(const uint64_t* mask, const uint64_t* minor_a, const uint64_t* minor_b, const uint64_t* missing_a, const uint64_t* missing_b,
+		unsigned int n_words, unsigned int* counts) {
+	uint64_t valid = 0u;
+
+	counts[0u] = counts[1u] = counts[2u] = counts[3u] = 0u;
+
+	for (unsigned int w = 0u; w < n_words; ++w) {
+		valid = mask[w];
+		if (missing_a != NULL) {
+			valid &= ~missing_a[w];
+		}
+		if (missing_b != NULL) {
+			valid &= ~missing_b[w];
+		}
+
+		counts[0u] += auxiliary::popcount(minor_a[w] & minor_b[w] & valid);
+		counts[1u] += auxiliary::popcount(minor_a[w] & valid);
+		counts[2u] += auxiliary::popcount(minor_b[w] & valid);
+		counts[3u] += auxiliary::popcount(mask[w] & ~valid);
+	}
+}
+
+/* the counts of count_population() with every weight plane as the mask, multiplied by the weight of the plane */
+void PairCounter::count_weighted(const uint64_t* weights, unsigned int n_planes, const uint64_t* minor_a, const uint64_t* minor_b, const uint64_t* missing_a, const uint64_t* missing_b,
+		unsigned int n_words, unsigned int* counts) {
+	unsigned int plane_counts[4u];
+
+	counts[0u] = counts[1u] = counts[2u] = counts[3u] = 0u;
+
+	for (unsigned int k = 0u; k < n_planes; ++k) {
+		count_population(weights + (size_t)k * n_words, minor_a, minor_b, missing_a, missing_b, n_words, plane_counts);
+		counts[0u] += plane_counts[0u] << k;
+		counts[1u] += plane_counts[1u] << k;
+		counts[2u] += plane_counts[2u] << k;
+		counts[3u] += plane_counts[3u] << k;
+	}
+}
+
+void PairCounter::count(const DbView* db, unsigned int marker_a, unsigned int marker_b,
+		unsigned int* n_major_a_major_b, unsigned int* n_major_a_minor_b, unsigned int* n_minor_a_major_b, unsigned int* n_minor_a_minor_b) {
+	const uint64_t* minor_a = db->minor_haplotypes[marker_a];
+	const uint64_t* minor_b = db->minor_haplotypes[marker_b];
+	const uint64_t* missing_a = db->missing_haplotypes[marker_a];
+	const uint64_t* missing_b = db->missing_haplotypes[marker_b];
+
+	unsigned int counts[4u];
+	unsigned int n_valid = db->n_haplotypes;
+	unsigned int n_minor_a = 0u;
+	unsigned int n_minor_b = 0u;
+	unsigned int n_minor_minor = 0u;
+
+	if (db->haplotype_weights != NULL) {
+		count_weighted(db->haplotype_weights, db->n_haplotype_weight_planes, minor_a, minor_b, missing_a, missing_b, db->n_haplotype_words, counts);
+		n_minor_minor = counts[0u];
+		n_minor_a = counts[1u];
+		n_minor_b = counts[2u];
+		n_valid -= counts[3u];
+	} else if (db->haplotype_mask != NULL) {
+		count_population(db->haplotype_mask, minor_a, minor_b, missing_a, missing_b, db->n_haplotype_words, counts);
+		n_minor_minor = counts[0u];
+		n_minor_a = counts[1u];
+		n_minor_b = counts[2u];
+		n_valid -= counts[3u];
+	} else if ((missing_a == NULL) && (missing_b == NULL)) {
+		n_minor_minor = kernel->count_and(minor_a, minor_b, db->n_haplotype_words);
+		n_minor_a = db->n_minor_alleles[marker_a];
+		n_minor_b = db->n_minor_alleles[marker_b];
+	} else {
+		/* minor allele bits are never set for missing alleles, so a marker without missing alleles can borrow the other marker's missing bitplane */
+		kernel->count_masked(minor_a, minor_b,
+				missing_a != NULL ? missing_a : missing_b, missing_b != NULL ? missing_b : missing_a,
+				db->n_haplotype_words, counts);
+		n_minor_minor = counts[0u];
+		n_minor_a = counts[1u];
+		n_minor_b = counts[2u];
+		n_valid -= counts[3u];
+	}
+
+	*n_minor_a_minor_b = n_minor_minor;
+	*n_minor_a_major_b = n_minor_a - n_minor_minor;
+	*n_major_a_minor_b = n_minor_b - n_minor_minor;
+	*n_major_a_major_b = n_valid - n_minor_a - n_minor_b + n_minor_minor;
+}
+
+void PairCounter::count_range(const DbView* db, unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* counts) {
+	const uint64_t* minor_a = db->minor_haplotypes[marker_a];
+	const uint64_t* missing_a = db->missing_haplotypes[marker_a];
+	const uint64_t* const* minor_b = db->minor_haplotypes + first_marker_b;
+	const uint64_t* const* missing_b = db->missing_haplotypes + first_marker_b;
+
+	unsigned int n_valid = 0u;
+	unsigned int n_minor_a = db->n_minor_alleles[marker_a];
+	unsigned int n_minor_b = 0u;
+	unsigned int n_minor_minor = 0u;
+	unsigned int* cells = NULL;
+
+	if ((db->haplotype_mask != NULL) || (db->haplotype_weights != NULL)) {
+		for (unsigned int b = 0u; b < n_markers_b; ++b) {
+			cells = counts + (b << 2);
+			count(db, marker_a, first_marker_b + b, &cells[0u], &cells[1u], &cells[2u], &cells[3u]);
+		}
+		return;
+	}
+
+	if (missing_a == NULL) {
+		kernel->count_and_range(minor_a, minor_b, n_markers_b, db->n_haplotype_words, counts + 3u);
+	}
+
+	for (unsigned int b = 0u; b < n_markers_b; ++b) {
+		cells = counts + (b << 2);
+
+		if ((missing_a == NULL) && (missing_b[b] == NULL)) {
+			n_valid = db->n_haplotypes;
+			n_minor_minor = cells[3u];
+			n_minor_b = db->n_minor_alleles[first_marker_b + b];
+
+			cells[0u] = n_valid - n_minor_a - n_minor_b + n_minor_minor;
+			cells[1u] = n_minor_b - n_minor_minor;
+			cells[2u] = n_minor_a - n_minor_minor;
+		} else {
+			count(db, marker_a, first_marker_b + b, &cells[0u], &cells[1u], &cells[2u], &cells[3u]);
+		}
+	}
+}
+
+void PairCounter::count_range_masked(const DbView* db, unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, uint64_t* masked_a, unsigned int* counts) {
+	const uint64_t* minor_a = db->minor_haplotypes[marker_a];
+	const uint64_t* missing_a = db->missing_haplotypes[marker_a];
+	const uint64_t* mask = db->haplotype_mask;
+	const uint64_t* plane = NULL;
+	const uint64_t* const* minor_b = db->minor_haplotypes + first_marker_b;
+	const uint64_t* const* missing_b = db->missing_haplotypes + first_marker_b;
+
+	unsigned int n_minor_a = db->n_minor_alleles[marker_a];
+	unsigned int n_minor_b = 0u;
+	unsigned int n_minor_minor = 0u;
+	unsigned int* cells = NULL;
+
+	if ((mask == NULL) && (db->haplotype_weights == NULL)) {
+		count_range(db, marker_a, first_marker_b, n_markers_b, counts);
+		return;
+	}
+
+	/* minor_a & mask & minor_b[b] is counted by the unmasked kernel; the marginal counts in the view are those of the population */
+	if ((missing_a == NULL) && (db->haplotype_weights == NULL)) {
+		for (unsigned int w = 0u; w < db->n_haplotype_words; ++w) {
+			masked_a[w] = minor_a[w] & mask[w];
+		}
+		kernel->count_and_range(masked_a, minor_b, n_markers_b, db->n_haplotype_words, counts + 3u);
+	} else if (missing_a == NULL) {
+		/* one kernel call per weight plane; the planes above the first one are counted into the (still unused) third cell */
+		for (unsigned int k = 0u; k < db->n_haplotype_weight_planes; ++k) {
+			plane = db->haplotype_weights + (size_t)k * db->n_haplotype_words;
+			for (unsigned int w = 0u; w < db->n_haplotype_words; ++w) {
+				masked_a[w] = minor_a[w] & plane[w];
+			}
+
+			if (k == 0u) {
+				kernel->count_and_range(masked_a, minor_b, n_markers_b, db->n_haplotype_words, counts + 3u);
+			} else {
+				kernel->count_and_range(masked_a, minor_b, n_markers_b, db->n_haplotype_words, counts + 2u);
+				for (unsigned int b = 0u; b < n_markers_b; ++b) {
+					counts[(b << 2) + 3u] += counts[(b << 2) + 2u] << k;
+				}
+			}
+		}
+	}
+
+	for (unsigned int b = 0u; b < n_markers_b; ++b) {
+		cells = counts + (b << 2);
+
+		if ((missing_a == NULL) && (missing_b[b] == NULL)) {
+			n_minor_minor = cells[3u];
+			n_minor_b = db->n_minor_alleles[first_marker_b + b];
+
+			cells[0u] = db->n_haplotypes - n_minor_a - n_minor_b + n_minor_minor;
+			cells[1u] = n_minor_b - n_minor_minor;
+			cells[2u] = n_minor_a - n_minor_minor;
+		} else {
+			count(db, marker_a, first_marker_b + b, &cells[0u], &cells[1u], &cells[2u], &cells[3u]);
+		}
+	}
+}
@@ -74,10 +74,19 @@ private:
 	char* all_major_alleles;
 	char* all_minor_alleles;
 	double* all_major_allele_freqs;
-	char** all_haplotypes;
+
+	unsigned int n_haplotype_words;
+	uint64_t** all_minor_haplotypes;
+	uint64_t** all_missing_haplotypes;
+	unsigned int* all_n_minor_alleles;
 
 	vector<DbView*> views;
 
+	/* haplotype indices and masks of the population views */
+	vector<unsigned int*> population_haplotypes;
+	vector<uint64_t*> population_masks;
+	unsigned long int n_population_haplotypes;
+
 	unsigned int current_heap_size;
 
 	void load_vcf(unsigned long int start_position, unsigned long int end_position) throw (Exception);
@@ -97,9 +106,19 @@ private:
 
 	void reallocate() throw (Exception);
 
+	static unsigned int get_n_haplotype_words(unsigned int n_haplotypes);
+	uint64_t* allocate_bitplane() throw (Exception);
+	void resize_bitplanes(unsigned int n_words) throw (Exception);
+	void set_second_allele(unsigned int marker, unsigned int haplotype);
+	void set_missing_allele(unsigned int marker, unsigned int haplotype) throw (Exception);
+	void swap_bitplane(unsigned int marker);
+
+	bool find_index_range(unsigned long int start_position, unsigned long int end_position, unsigned int* start_index, unsigned int* end_index);
+
 public:
 	static const unsigned int HEAP_SIZE;
 	static const unsigned int HEAP_INCREMENT;
+	static const unsigned int HAPLOTYPE_WORDS_ALIGNMENT;
 
 	static const double EPSILON;
 
@@ -117,6 +136,15 @@ public:
 
 	const DbView* create_view(double maf_threshold, unsigned long int start_position, unsigned long int end_position) throw (Exception);
 
+	/*
+	 * Creates a view of the haplotypes of samples[0], ..., samples[n_samples - 1] (0-based, in the order of the phase file), e.g. of one population.
+	 * Sample i has haplotypes 2i and 2i + 1. The view shares the bitplanes of the Db and masks the other haplotypes.
+	 * The allele frequencies and the MAF filter are computed on the population, but the minor allele of every marker is that of the Db,
+	 * so its frequency in the population may exceed 0.5. Returns NULL if there are not enough markers (<= 1).
+	 */
+	const DbView* create_population_view(double maf_threshold, unsigned long int start_position, unsigned long int end_position,
+			const unsigned int* samples, unsigned int n_samples) throw (Exception);
+
 	unsigned int get_n_haplotypes();
 	unsigned int get_all_n_markers();
 
@@ -21,6 +21,9 @@
 #define DBVIEW_H_
 
 #include <stdlib.h>
+#include <stdint.h>
+
+#include "../../exception/include/Exception.h"
 
 using namespace std;
 
@@ -45,10 +48,52 @@ public:
 	char* major_alleles;
 	char* minor_alleles;
 	double* major_allele_freqs;
-	char** haplotypes;
+
+	unsigned int n_haplotype_words;
+	uint64_t** minor_haplotypes;
+	uint64_t** missing_haplotypes;
+	unsigned int* n_minor_alleles;
+
+	/* index of every marker among all markers of the Db, shared by all its views */
+	unsigned int* indices;
+
+	/*
+	 * For a view of a subset of the haplotypes (e.g. one population): haplotype i of the view is haplotype haplotypes[i] of the Db,
+	 * and haplotype_mask has their bits set in the Db bitplanes, which are shared with the Db. NULL if the view has all haplotypes.
+	 */
+	const unsigned int* haplotypes;
+	const uint64_t* haplotype_mask;
+
+	/*
+	 * For a view with multiplicities of the haplotypes (e.g. a bootstrap replicate): bit k of the multiplicity of every haplotype of the Db
+	 * is in plane k, at haplotype_weights + k * n_haplotype_words, and n_haplotypes is the sum of the multiplicities. The counts are weighted
+	 * popcounts, but get_allele() ignores the multiplicities. NULL if every haplotype counts once.
+	 */
+	const uint64_t* haplotype_weights;
+	unsigned int n_haplotype_weight_planes;
 
 	virtual ~DbView();
 
+	inline char get_allele(unsigned int marker, unsigned int haplotype) const {
+		if (haplotypes != NULL) {
+			haplotype = haplotypes[haplotype];
+		}
+
+		uint64_t bit = ((uint64_t)1u) << (haplotype & 63u);
+
+		if ((missing_haplotypes[marker] != NULL) && ((missing_haplotypes[marker][haplotype >> 6] & bit) != 0u)) {
+			return '.';
+		}
+
+		return (minor_haplotypes[marker][haplotype >> 6] & bit) != 0u ? minor_alleles[marker] : major_alleles[marker];
+	}
+
+	/*
+	 * Returns a new view of the markers[0], ..., markers[n_markers - 1] (increasing) of this view, e.g. one marker of every group of
+	 * identical columns. The bitplanes and marker names are shared with this view, so the caller deletes the new view before its Db.
+	 */
+	DbView* create_subview(const unsigned int* markers, unsigned int n_markers) const throw (Exception);
+
 	double get_memory_usage();
 
 	friend class Db;
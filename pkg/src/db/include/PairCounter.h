@@ -0,0 +1,86 @@
+/*
+ * Copyright  2013 Daniel Taliun, Johann Gamper and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of LDExplorer.
+ *
+ * LDExplorer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LDExplorer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LDExplorer.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PAIRCOUNTER_H_
+#define PAIRCOUNTER_H_
+
+#include "DbView.h"
+#include "../../auxiliary/include/auxiliary.h"
+
+using namespace std;
+
+/*
+ * Fills the 2x2 haplotype table of two markers from their bitplanes.
+ * Only the minor/minor cell is counted (AND + popcount); the other three cells are derived from the marginal minor allele counts.
+ * Haplotypes with a missing allele in either marker are excluded from all four cells.
+ *
+ * The popcount loops are provided by several kernels (scalar, SSE4.2, AVX2, AVX-512 VPOPCNTDQ).
+ * The widest kernel supported by the host CPU is selected once, when the library is loaded.
+ *
+ * count_range() fills the tables of one marker with a contiguous range of markers. Marker a's bitplane and the kernel are fetched
+ * once for the whole range, and pairs without missing alleles are counted in one kernel call.
+ *
+ * In a view of a subset of the haplotypes (DbView::haplotype_mask is set), all counts are masked popcounts of the shared bitplanes.
+ * count_range_masked() ANDs marker a's bitplane with the mask once, so that the range is still counted in one kernel call.
+ * With multiplicities (DbView::haplotype_weights is set), every weight plane is counted like a mask and shifted by its bit position.
+ */
+class PairCounter {
+public:
+	typedef bool (*supported_function)();
+	typedef unsigned int (*and_function)(const uint64_t* minor_a, const uint64_t* minor_b, unsigned int n_words);
+	typedef void (*masked_function)(const uint64_t* minor_a, const uint64_t* minor_b, const uint64_t* missing_a, const uint64_t* missing_b, unsigned int n_words, unsigned int* counts);
+	/* n[4 * b] = count_and(minor_a, minor_b[b], n_words) */
+	typedef void (*and_range_function)(const uint64_t* minor_a, const uint64_t* const* minor_b, unsigned int n_markers_b, unsigned int n_words, unsigned int* n);
+
+	struct Kernel {
+		const char* name;
+		supported_function is_supported;
+		and_function count_and;
+		masked_function count_masked;
+		and_range_function count_and_range;
+	};
+
+private:
+	static const Kernel kernels[];
+	static const unsigned int N_KERNELS;
+
+	static const Kernel* kernel;
+
+	static const Kernel* select_kernel();
+
+	static void count_population(const uint64_t* mask, const uint64_t* minor_a, const uint64_t* minor_b, const uint64_t* missing_a, const uint64_t* missing_b,
+			unsigned int n_words, unsigned int* counts);
+	static void count_weighted(const uint64_t* weights, unsigned int n_planes, const uint64_t* minor_a, const uint64_t* minor_b, const uint64_t* missing_a, const uint64_t* missing_b,
+			unsigned int n_words, unsigned int* counts);
+
+public:
+	static const char* get_kernel_name();
+	static bool set_kernel(const char* name);
+
+	static void count(const DbView* db, unsigned int marker_a, unsigned int marker_b,
+			unsigned int* n_major_a_major_b, unsigned int* n_major_a_minor_b, unsigned int* n_minor_a_major_b, unsigned int* n_minor_a_minor_b);
+
+	/* counts[4 * b] ... counts[4 * b + 3] are the four cells of count() (in the same order) for marker_a and marker first_marker_b + b. */
+	static void count_range(const DbView* db, unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, unsigned int* counts);
+
+	/* Same as count_range(); masked_a is an aligned buffer of db->n_haplotype_words words, used if db has a haplotype mask or weights. */
+	static void count_range_masked(const DbView* db, unsigned int marker_a, unsigned int first_marker_b, unsigned int n_markers_b, uint64_t* masked_a, unsigned int* counts);
+};
+
+#endif
@@ -103,5 +103,7 @@ const char* Exception::what() const throw() {
 		trace_it++;
 	}
 
-	return string_stream.str().c_str();
+	what_text = string_stream.str();
+
+	return what_text.c_str();
 }
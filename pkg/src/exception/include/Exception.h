@@ -28,6 +28,7 @@
 #include <sstream>
 #include <cstdlib>
 #include <cstdio>
+#include <string>
 
 using namespace std;
 
@@ -43,6 +44,7 @@ private:
 	};
 
 	list<message*> trace;
+	mutable string what_text;
 
 	void format_message_text(char** text, const char* text_template, va_list arguments);
 	void add_message(const char* source, int source_line, const char* text_message, va_list arguments);